@@ -0,0 +1,101 @@
+﻿/**
+ * @file main.cpp
+ * @brief 视图性能基准程序
+ *
+ * 在离屏视图中加载标准场景，沿固定相机路径逐帧计时，输出JSON报告，
+ * 并可导出截图用于视觉回归对比。默认使用软件OpenGL，CI上可配合 xvfb-run 运行：
+ *
+ *   xvfb-run -s "-screen 0 1920x1080x24" AnderCADBench --frames 240 --images out/
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QStringList>
+#include <iostream>
+
+#include "cad_ui/OffscreenView.h"
+#include "cad_ui/ViewBenchmark.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("AnderCADBench");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Ander CAD offscreen view benchmark");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption sceneOption({"s", "scene"}, "Scene to run (boxes, spheres, instanced, mixed). Repeatable, default: all.", "name");
+    QCommandLineOption countOption({"n", "count"}, "Objects per scene.", "count", "100");
+    QCommandLineOption framesOption({"f", "frames"}, "Timed frames per scene.", "frames", "360");
+    QCommandLineOption sizeOption("size", "Viewport size WIDTHxHEIGHT.", "size", "1280x720");
+    QCommandLineOption imagesOption("images", "Directory for screenshot dumps.", "dir");
+    QCommandLineOption imageEveryOption("image-every", "Dump a screenshot every N frames.", "frames", "60");
+    QCommandLineOption formatOption("image-format", "Screenshot format (png, ppm, bmp).", "ext", "png");
+    QCommandLineOption reportOption({"o", "report"}, "Write JSON report to file instead of stdout.", "file");
+    QCommandLineOption hardwareOption("hardware", "Use the hardware OpenGL driver instead of software rendering.");
+    parser.addOptions({sceneOption, countOption, framesOption, sizeOption, imagesOption,
+                       imageEveryOption, formatOption, reportOption, hardwareOption});
+    parser.process(app);
+
+    cad_ui::OffscreenViewOptions options;
+    const QStringList size = parser.value(sizeOption).split('x');
+    if (size.size() == 2) {
+        options.width = qMax(1, size[0].toInt());
+        options.height = qMax(1, size[1].toInt());
+    }
+    options.softwareOpenGL = !parser.isSet(hardwareOption);
+
+    cad_ui::OffscreenView view;
+    if (!view.Initialize(options)) {
+        std::cerr << "Failed to create offscreen view" << std::endl;
+        return 1;
+    }
+
+    cad_ui::ViewBenchmark benchmark(view);
+    benchmark.SetFrameCount(qMax(1, parser.value(framesOption).toInt()));
+    if (parser.isSet(imagesOption)) {
+        benchmark.SetImageOutput(parser.value(imagesOption).toStdString(),
+                                 qMax(1, parser.value(imageEveryOption).toInt()),
+                                 parser.value(formatOption).toStdString());
+    }
+
+    std::vector<std::string> sceneNames;
+    for (const QString& name : parser.values(sceneOption)) {
+        sceneNames.push_back(name.toStdString());
+    }
+    if (sceneNames.empty()) {
+        sceneNames = cad_ui::ViewBenchmark::GetStandardSceneNames();
+    }
+
+    const int count = qMax(1, parser.value(countOption).toInt());
+    std::vector<cad_ui::BenchmarkResult> results;
+    for (const auto& name : sceneNames) {
+        cad_ui::BenchmarkScene scene = cad_ui::ViewBenchmark::CreateStandardScene(name, count);
+        if (scene.shapes.empty()) {
+            std::cerr << "Skipping empty scene: " << name << std::endl;
+            continue;
+        }
+        cad_ui::BenchmarkResult result = benchmark.Run(scene);
+        std::cerr << name << ": mean " << result.meanFrameMs << " ms, p95 " << result.p95FrameMs
+                  << " ms, " << result.triangles << " triangles" << std::endl;
+        results.push_back(result);
+    }
+
+    const std::string report = cad_ui::ViewBenchmark::ToJson(results);
+    if (parser.isSet(reportOption)) {
+        QFile file(parser.value(reportOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::cerr << "Cannot write report: " << parser.value(reportOption).toStdString() << std::endl;
+            return 1;
+        }
+        file.write(report.c_str(), static_cast<qint64>(report.size()));
+    } else {
+        std::cout << report;
+    }
+
+    return results.empty() ? 1 : 0;
+}
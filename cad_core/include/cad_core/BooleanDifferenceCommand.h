@@ -0,0 +1,36 @@
+#pragma once
+
+#include "ICommand.h"
+#include "Shape.h"
+#include "BooleanOperations.h"
+#include <vector>
+
+namespace cad_core {
+
+/**
+ * @class BooleanDifferenceCommand
+ * @brief 多工具差集命令：所有工具一次从目标上切除
+ */
+class BooleanDifferenceCommand : public ICommand {
+public:
+    BooleanDifferenceCommand(const ShapePtr& target, const std::vector<ShapePtr>& tools,
+                             const BooleanOptions& options);
+    virtual ~BooleanDifferenceCommand() = default;
+
+    bool Execute() override;
+    bool Undo() override;
+    bool Redo() override;
+    const char* GetName() const override;
+
+    ShapePtr GetTargetShape() const;
+    ShapePtr GetResultShape() const;
+
+private:
+    ShapePtr m_target;
+    std::vector<ShapePtr> m_tools;
+    BooleanOptions m_options;
+    ShapePtr m_result;
+    bool m_executed;
+};
+
+} // namespace cad_core
@@ -1,10 +1,48 @@
 #pragma once
 
 #include "cad_core/Shape.h"
+#include "cad_core/CancellationToken.h"
 #include <vector>
+#include <Message_ProgressRange.hxx>
+#include <BRepTools_History.hxx>
 
 namespace cad_core {
 
+// 一次形状简化的结果：面/边数量变化和原子形状到合并后形状的映射
+struct SimplifyReport {
+    int facesBefore = 0;
+    int facesAfter = 0;
+    int edgesBefore = 0;
+    int edgesAfter = 0;
+    Handle(BRepTools_History) history;
+};
+
+// 布尔运算内核选项
+struct BooleanOptions {
+    // 共享面的粘合模式：输入之间只接触（如导入装配体的贴合面）时跳过面面求交
+    enum class GlueMode {
+        Off,    // 一般情况
+        Shift,  // 输入只部分重叠或接触，面之间没有真正的相交
+        Full    // 输入的接触面完全重合
+    };
+    
+    bool parallel = true;        // 内核内部并行
+    bool useOBB = true;          // 用有向包围盒预筛选不相交的子形状
+    double fuzzyValue = 0.0;     // 模糊容差，0 表示使用形状自身容差
+    GlueMode glue = GlueMode::Off;
+    bool history = false;        // 没有调用方使用历史时关闭，省去历史记录的开销
+    bool simplify = true;        // 结果合并同域面（见 SimplifyShape）
+};
+
+// 进程内所有简化的累计计数
+struct SimplifyStatistics {
+    long long runs = 0;
+    long long facesBefore = 0;
+    long long facesAfter = 0;
+    long long edgesBefore = 0;
+    long long edgesAfter = 0;
+};
+
 class BooleanOperations {
 public:
     // 布尔运算类型
@@ -14,18 +52,43 @@ public:
         Difference    // 差集
     };
     
+    // 默认选项：simplify 取自动简化开关的当前值
+    static BooleanOptions DefaultOptions();
+    
     // 布尔运算
-    static ShapePtr Union(const ShapePtr& shape1, const ShapePtr& shape2);
-    static ShapePtr Union(const std::vector<ShapePtr>& shapes);
+    static ShapePtr Union(const ShapePtr& shape1, const ShapePtr& shape2,
+                          const BooleanOptions& options = DefaultOptions());
+    static ShapePtr Union(const std::vector<ShapePtr>& shapes, const BooleanOptions& options = DefaultOptions());
     
-    static ShapePtr Intersection(const ShapePtr& shape1, const ShapePtr& shape2);
-    static ShapePtr Intersection(const std::vector<ShapePtr>& shapes);
+    static ShapePtr Intersection(const ShapePtr& shape1, const ShapePtr& shape2,
+                                 const BooleanOptions& options = DefaultOptions());
+    static ShapePtr Intersection(const std::vector<ShapePtr>& shapes,
+                                 const BooleanOptions& options = DefaultOptions());
     
-    static ShapePtr Difference(const ShapePtr& shape1, const ShapePtr& shape2);
+    static ShapePtr Difference(const ShapePtr& shape1, const ShapePtr& shape2,
+                               const BooleanOptions& options = DefaultOptions());
+    // 一次运算减去全部工具（阵列孔等），比逐个相减少做 N-1 次求交和结果重建
+    // options.history 为 true 时 history 返回输入子形状到最终结果（含简化）的映射
+    static ShapePtr Difference(const ShapePtr& shape, const std::vector<ShapePtr>& tools,
+                               const BooleanOptions& options = DefaultOptions(),
+                               const Message_ProgressRange& range = Message_ProgressRange(),
+                               Handle(BRepTools_History)* history = nullptr);
     
     // 通用布尔运算
-    static ShapePtr BooleanOperation(const ShapePtr& shape1, const ShapePtr& shape2, BooleanType type);
-    static ShapePtr BooleanOperation(const std::vector<ShapePtr>& shapes, BooleanType type);
+    static ShapePtr BooleanOperation(const ShapePtr& shape1, const ShapePtr& shape2, BooleanType type,
+                                     const BooleanOptions& options = DefaultOptions());
+    static ShapePtr BooleanOperation(const std::vector<ShapePtr>& shapes, BooleanType type,
+                                     const BooleanOptions& options = DefaultOptions());
+    
+    // 目标/工具形式的布尔运算（对话框预览与确定使用同一实现）：
+    // 并集合并全部形状，交集依次与其余形状求交，差集从第一个目标中减去所有工具。
+    // token 被取消时尽快返回 nullptr；history 同 Difference，多步运算的历史依次合并
+    static ShapePtr Perform(BooleanType type,
+                            const std::vector<ShapePtr>& targets,
+                            const std::vector<ShapePtr>& tools,
+                            const BooleanOptions& options = DefaultOptions(),
+                            const CancellationTokenPtr& token = nullptr,
+                            Handle(BRepTools_History)* history = nullptr);
     
     // 验证形状是否有效
     static bool IsValidShape(const ShapePtr& shape);
@@ -33,18 +96,37 @@ public:
     // 修复形状
     static ShapePtr FixShape(const ShapePtr& shape);
     
-    // 简化形状
-    static ShapePtr SimplifyShape(const ShapePtr& shape);
+    // 简化形状：合并同一曲面上的面和同一曲线上的边（布尔运算留下的拆分面）
+    // 没有可合并的面和边时返回原形状对象
+    static ShapePtr SimplifyShape(const ShapePtr& shape, SimplifyReport* report = nullptr);
+    
+    // 简化前的子形状在结果中的对应形状（被合并时返回合并后的形状，被删除时为空）
+    static std::vector<TopoDS_Shape> TrackSubShape(const SimplifyReport& report, const TopoDS_Shape& subShape);
+    
+    // 未指定选项时布尔运算结果是否自动简化（默认开启，可在任意线程读取）
+    static void SetAutoSimplify(bool enabled);
+    static bool IsAutoSimplify();
+    
+    static SimplifyStatistics GetSimplifyStatistics();
+    static void ResetSimplifyStatistics();
     
 private:
     // 私有辅助方法
-    static ShapePtr PerformUnion(const ShapePtr& shape1, const ShapePtr& shape2);
-    static ShapePtr PerformIntersection(const ShapePtr& shape1, const ShapePtr& shape2);
-    static ShapePtr PerformDifference(const ShapePtr& shape1, const ShapePtr& shape2);
+    static ShapePtr PerformUnion(const ShapePtr& shape1, const ShapePtr& shape2, const BooleanOptions& options,
+                                 const Message_ProgressRange& range = Message_ProgressRange());
+    static ShapePtr PerformIntersection(const ShapePtr& shape1, const ShapePtr& shape2, const BooleanOptions& options,
+                                        const Message_ProgressRange& range = Message_ProgressRange());
+    static ShapePtr PerformDifference(const ShapePtr& shape1, const ShapePtr& shape2, const BooleanOptions& options,
+                                      const Message_ProgressRange& range = Message_ProgressRange());
+    static ShapePtr PerformOperation(BooleanType type, const ShapePtr& shape1, const ShapePtr& shape2,
+                                     const BooleanOptions& options, const Message_ProgressRange& range,
+                                     Handle(BRepTools_History)* history = nullptr);
     
-    // 形状验证和修复
+    // 形状验证和修复；operationHistory 与简化的历史合并后写入 history
     static bool ValidateInputs(const ShapePtr& shape1, const ShapePtr& shape2);
-    static ShapePtr PostProcessResult(const TopoDS_Shape& result);
+    static ShapePtr PostProcessResult(const TopoDS_Shape& result, const BooleanOptions& options,
+                                      const Handle(BRepTools_History)& operationHistory = Handle(BRepTools_History)(),
+                                      Handle(BRepTools_History)* history = nullptr);
 };
 
 } // namespace cad_core
\ No newline at end of file
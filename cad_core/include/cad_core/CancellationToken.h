@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <Message_ProgressIndicator.hxx>
+
+namespace cad_core {
+
+// 取消标志，可在GUI线程设置、在工作线程检查
+class CancellationToken {
+public:
+    void Cancel() { m_cancelled.store(true); }
+    bool IsCancelled() const { return m_cancelled.load(); }
+
+private:
+    std::atomic<bool> m_cancelled{false};
+};
+
+using CancellationTokenPtr = std::shared_ptr<CancellationToken>;
+
+// OCCT进度指示器：UserBreak 返回取消标志，长时间运行的算法据此中途退出
+class CancellationProgress : public Message_ProgressIndicator {
+public:
+    explicit CancellationProgress(const CancellationTokenPtr& token);
+
+    Standard_Boolean UserBreak() override;
+
+protected:
+    void Show(const Message_ProgressScope& scope, const Standard_Boolean force) override;
+
+private:
+    CancellationTokenPtr m_token;
+};
+
+} // namespace cad_core
@@ -3,23 +3,88 @@
 #include "cad_core/Shape.h"
 #include <TopoDS_Edge.hxx>
 #include <TopoDS_Face.hxx>
+#include <TopoDS_Vertex.hxx>
+#include <Message_ProgressRange.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <cstddef>
+#include <map>
+#include <mutex>
 #include <vector>
 
 namespace cad_core {
 
+// 圆角/倒角失败诊断：列出导致运算失败的边和顶点
+struct FilletFailureReport {
+    bool succeeded = false;
+    std::vector<TopoDS_Edge> faultyEdges;
+    std::vector<TopoDS_Vertex> faultyVertices;   // 多条圆角交汇处无法处理的顶点
+};
+
+// 圆角半径的可行范围
+struct FilletRadiusRange {
+    bool valid = false;          // 为 false 表示所选边无法圆角
+    double minRadius = 0.0;
+    double maxRadius = 0.0;      // 几何估计的上界；refined 时为试算通过的最大半径
+    bool refined = false;
+    
+    // 估计进度：传回 EstimateFilletRadiusRange 时跳过已完成的几何估计，并从中断处继续二分
+    bool estimated = false;
+    double boundRadius = 0.0;    // 几何估计的上界
+    double passedRadius = 0.0;   // 试算通过的最大半径（0 表示还没有）
+    double failedRadius = 0.0;   // 试算失败的最小半径（0 表示还没有）
+    int bisectionSteps = 0;
+};
+
+// 可行半径估计的缓存，按形状和边集合（TShape）保存估计结果和试算进度，可在工作线程上使用
+class FilletRadiusCache {
+public:
+    static const std::size_t MaxEntries = 256;
+    
+    bool Find(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, FilletRadiusRange& range) const;
+    void Store(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, const FilletRadiusRange& range);
+    void Clear();
+    
+private:
+    using Key = std::vector<const Standard_Transient*>;
+    struct Entry {
+        std::vector<Handle(Standard_Transient)> holders;   // 持有 TShape，避免地址被复用
+        FilletRadiusRange range;
+    };
+    
+    static Key MakeKey(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges,
+                       std::vector<Handle(Standard_Transient)>* holders);
+    
+    mutable std::mutex m_mutex;
+    std::map<Key, Entry> m_entries;
+};
+
+// 批量圆角/倒角中的一个实体及其上要处理的边
+struct EdgeBlendJob {
+    ShapePtr shape;
+    std::vector<TopoDS_Edge> edges;
+};
+
 class FilletChamferOperations {
 public:
     // 圆角操作
-    static ShapePtr CreateFillet(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius);
+    static ShapePtr CreateFillet(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius,
+                                 const Message_ProgressRange& range = Message_ProgressRange());
     static ShapePtr CreateFillet(const ShapePtr& shape, const TopoDS_Edge& edge, double radius);
     static ShapePtr CreateVariableFillet(const ShapePtr& shape, const TopoDS_Edge& edge, double radius1, double radius2);
     
     // 倒角操作
-    static ShapePtr CreateChamfer(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double distance);
+    static ShapePtr CreateChamfer(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double distance,
+                                  const Message_ProgressRange& range = Message_ProgressRange());
     static ShapePtr CreateChamfer(const ShapePtr& shape, const TopoDS_Edge& edge, double distance);
     static ShapePtr CreateAsymmetricChamfer(const ShapePtr& shape, const TopoDS_Edge& edge, double distance1, double distance2);
     static ShapePtr CreateChamferByAngle(const ShapePtr& shape, const TopoDS_Edge& edge, double distance, double angle);
     
+    // 多个实体并行处理，结果与 jobs 一一对应（失败为 nullptr）
+    static std::vector<ShapePtr> CreateFillets(const std::vector<EdgeBlendJob>& jobs, double radius,
+                                               bool parallel = true);
+    static std::vector<ShapePtr> CreateChamfers(const std::vector<EdgeBlendJob>& jobs, double distance,
+                                                bool parallel = true);
+    
     // 面圆角
     static ShapePtr CreateFaceFillet(const ShapePtr& shape, const std::vector<TopoDS_Face>& faces, double radius);
     
@@ -38,16 +103,39 @@ public:
     static double GetSuggestedFilletRadius(const ShapePtr& shape, const TopoDS_Edge& edge);
     static double GetSuggestedChamferDistance(const ShapePtr& shape, const TopoDS_Edge& edge);
     
+    // 由相邻面宽度、二面角、边曲率和相邻边长度估计半径上界
+    static FilletRadiusRange EstimateMaxFilletRadius(const ShapePtr& shape, const TopoDS_Edge& edge);
+    // 多条边使用同一半径时的可行范围：各边并行估计后取最小，refine 时再用试算二分细化。
+    // progress 非空时从中读取并写回估计进度，取消后再次调用可继续二分
+    static FilletRadiusRange EstimateFilletRadiusRange(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges,
+                                                       bool refine = false, int iterations = 6,
+                                                       const Message_ProgressRange& range = Message_ProgressRange(),
+                                                       FilletRadiusRange* progress = nullptr);
+    
+    // 失败诊断：圆角使用算法报告的失败轮廓，倒角逐条边试算
+    static FilletFailureReport AnalyzeFilletFailure(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges,
+                                                    double radius,
+                                                    const Message_ProgressRange& range = Message_ProgressRange());
+    static FilletFailureReport AnalyzeChamferFailure(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges,
+                                                     double distance,
+                                                     const Message_ProgressRange& range = Message_ProgressRange());
+    
 private:
     // 私有辅助方法
-    static ShapePtr PerformFillet(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius);
-    static ShapePtr PerformChamfer(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double distance);
+    static ShapePtr PerformFillet(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius,
+                                  const Message_ProgressRange& range = Message_ProgressRange());
+    static ShapePtr PerformChamfer(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double distance,
+                                   const Message_ProgressRange& range = Message_ProgressRange());
     static ShapePtr PostProcessResult(const TopoDS_Shape& result);
+    static std::vector<ShapePtr> PerformBatch(const std::vector<EdgeBlendJob>& jobs, bool parallel,
+                                              bool fillet, double size);
     
     // 边分析
     static bool AnalyzeEdge(const ShapePtr& shape, const TopoDS_Edge& edge, double& minRadius, double& maxRadius);
     static double GetEdgeLength(const TopoDS_Edge& edge);
     static double GetMinimumRadius(const ShapePtr& shape, const TopoDS_Edge& edge);
+    static double ComputeRadiusUpperBound(const TopTools_IndexedDataMapOfShapeListOfShape& edgeFaces,
+                                          const TopoDS_Edge& edge);
 };
 
 } // namespace cad_core
\ No newline at end of file
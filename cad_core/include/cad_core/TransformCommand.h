@@ -37,6 +37,9 @@ public:
     // 获取变换后的形状（用于预览）
     std::vector<ShapePtr> GetTransformedShapes() const;
     
+    // 获取变换矩阵（预览只需移动原形状，不必生成新形状）
+    gp_Trsf GetTransformation() const { return CreateTransformation(); }
+    
     // 设置变换参数（由派生类具体实现）
     virtual void SetTransformParameters() = 0;
     
@@ -0,0 +1,54 @@
+﻿#include "cad_core/BooleanDifferenceCommand.h"
+
+namespace cad_core {
+
+BooleanDifferenceCommand::BooleanDifferenceCommand(const ShapePtr& target, const std::vector<ShapePtr>& tools,
+                                                   const BooleanOptions& options)
+    : m_target(target), m_tools(tools), m_options(options), m_executed(false) {
+}
+
+bool BooleanDifferenceCommand::Execute() {
+    if (m_executed) {
+        return true;
+    }
+
+    if (!m_target || m_tools.empty()) {
+        return false;
+    }
+
+    m_result = BooleanOperations::Difference(m_target, m_tools, m_options);
+    m_executed = (m_result != nullptr);
+    return m_executed;
+}
+
+bool BooleanDifferenceCommand::Undo() {
+    if (!m_executed) {
+        return false;
+    }
+
+    m_result.reset();
+    m_executed = false;
+    return true;
+}
+
+bool BooleanDifferenceCommand::Redo() {
+    if (m_executed) {
+        return true;
+    }
+
+    return Execute();
+}
+
+const char* BooleanDifferenceCommand::GetName() const {
+    return "Boolean Difference";
+}
+
+ShapePtr BooleanDifferenceCommand::GetTargetShape() const {
+    return m_target;
+}
+
+ShapePtr BooleanDifferenceCommand::GetResultShape() const {
+    return m_result;
+}
+
+} // namespace cad_core
@@ -8,70 +8,161 @@
 #include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
 #include <Standard_Failure.hxx>
+#include <Message_ProgressScope.hxx>
+#include <ShapeUpgrade_UnifySameDomain.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopTools_ListOfShape.hxx>
+#include <atomic>
+#include <memory>
 
 namespace cad_core {
 
-ShapePtr BooleanOperations::Union(const ShapePtr& shape1, const ShapePtr& shape2) {
-    return PerformUnion(shape1, shape2);
+namespace {
+
+std::atomic<bool> g_autoSimplify{true};
+
+std::atomic<long long> g_simplifyRuns{0};
+std::atomic<long long> g_simplifyFacesBefore{0};
+std::atomic<long long> g_simplifyFacesAfter{0};
+std::atomic<long long> g_simplifyEdgesBefore{0};
+std::atomic<long long> g_simplifyEdgesAfter{0};
+
+void ConfigureOperation(BRepAlgoAPI_BooleanOperation& operation, const BooleanOptions& options) {
+    operation.SetRunParallel(options.parallel);
+    operation.SetUseOBB(options.useOBB);
+    if (options.fuzzyValue > 0.0) {
+        operation.SetFuzzyValue(options.fuzzyValue);
+    }
+    switch (options.glue) {
+        case BooleanOptions::GlueMode::Shift:
+            operation.SetGlue(BOPAlgo_GlueShift);
+            break;
+        case BooleanOptions::GlueMode::Full:
+            operation.SetGlue(BOPAlgo_GlueFull);
+            break;
+        default:
+            operation.SetGlue(BOPAlgo_GlueOff);
+            break;
+    }
+    operation.SetToFillHistory(options.history);
+}
+
+int CountSubShapes(const TopoDS_Shape& shape, TopAbs_ShapeEnum type) {
+    TopTools_IndexedMapOfShape map;
+    TopExp::MapShapes(shape, type, map);
+    return map.Extent();
+}
+
+} // anonymous namespace
+
+BooleanOptions BooleanOperations::DefaultOptions() {
+    BooleanOptions options;
+    options.simplify = IsAutoSimplify();
+    return options;
 }
 
-ShapePtr BooleanOperations::Union(const std::vector<ShapePtr>& shapes) {
+ShapePtr BooleanOperations::Union(const ShapePtr& shape1, const ShapePtr& shape2, const BooleanOptions& options) {
+    return PerformUnion(shape1, shape2, options);
+}
+
+ShapePtr BooleanOperations::Union(const std::vector<ShapePtr>& shapes, const BooleanOptions& options) {
     if (shapes.empty()) return nullptr;
     if (shapes.size() == 1) return shapes[0];
     
     ShapePtr result = shapes[0];
     for (size_t i = 1; i < shapes.size(); i++) {
-        result = Union(result, shapes[i]);
+        result = Union(result, shapes[i], options);
         if (!result) return nullptr;
     }
     
     return result;
 }
 
-ShapePtr BooleanOperations::Intersection(const ShapePtr& shape1, const ShapePtr& shape2) {
-    return PerformIntersection(shape1, shape2);
+ShapePtr BooleanOperations::Intersection(const ShapePtr& shape1, const ShapePtr& shape2, const BooleanOptions& options) {
+    return PerformIntersection(shape1, shape2, options);
 }
 
-ShapePtr BooleanOperations::Intersection(const std::vector<ShapePtr>& shapes) {
+ShapePtr BooleanOperations::Intersection(const std::vector<ShapePtr>& shapes, const BooleanOptions& options) {
     if (shapes.empty()) return nullptr;
     if (shapes.size() == 1) return shapes[0];
     
     ShapePtr result = shapes[0];
     for (size_t i = 1; i < shapes.size(); i++) {
-        result = Intersection(result, shapes[i]);
+        result = Intersection(result, shapes[i], options);
         if (!result) return nullptr;
     }
     
     return result;
 }
 
-ShapePtr BooleanOperations::Difference(const ShapePtr& shape1, const ShapePtr& shape2) {
-    return PerformDifference(shape1, shape2);
+ShapePtr BooleanOperations::Difference(const ShapePtr& shape1, const ShapePtr& shape2, const BooleanOptions& options) {
+    return PerformDifference(shape1, shape2, options);
+}
+
+ShapePtr BooleanOperations::Difference(const ShapePtr& shape, const std::vector<ShapePtr>& tools,
+                                       const BooleanOptions& options, const Message_ProgressRange& range,
+                                       Handle(BRepTools_History)* history) {
+    if (!shape || shape->GetOCCTShape().IsNull()) {
+        return nullptr;
+    }
+    
+    TopTools_ListOfShape toolList;
+    for (const auto& tool : tools) {
+        if (tool && !tool->GetOCCTShape().IsNull()) {
+            toolList.Append(tool->GetOCCTShape());
+        }
+    }
+    if (toolList.IsEmpty()) {
+        return shape;
+    }
+    
+    try {
+        TopTools_ListOfShape arguments;
+        arguments.Append(shape->GetOCCTShape());
+        
+        BRepAlgoAPI_Cut cutOp;
+        cutOp.SetArguments(arguments);
+        cutOp.SetTools(toolList);
+        ConfigureOperation(cutOp, options);
+        cutOp.Build(range);
+        
+        if (cutOp.IsDone() && !range.UserBreak()) {
+            TopoDS_Shape result = cutOp.Shape();
+            return PostProcessResult(result, options, cutOp.History(), history);
+        }
+    } catch (const Standard_Failure&) {
+        // 布尔运算失败
+    }
+    
+    return nullptr;
 }
 
-ShapePtr BooleanOperations::BooleanOperation(const ShapePtr& shape1, const ShapePtr& shape2, BooleanType type) {
+ShapePtr BooleanOperations::BooleanOperation(const ShapePtr& shape1, const ShapePtr& shape2, BooleanType type,
+                                             const BooleanOptions& options) {
     switch (type) {
         case BooleanType::Union:
-            return Union(shape1, shape2);
+            return Union(shape1, shape2, options);
         case BooleanType::Intersection:
-            return Intersection(shape1, shape2);
+            return Intersection(shape1, shape2, options);
         case BooleanType::Difference:
-            return Difference(shape1, shape2);
+            return Difference(shape1, shape2, options);
         default:
             return nullptr;
     }
 }
 
-ShapePtr BooleanOperations::BooleanOperation(const std::vector<ShapePtr>& shapes, BooleanType type) {
+ShapePtr BooleanOperations::BooleanOperation(const std::vector<ShapePtr>& shapes, BooleanType type,
+                                             const BooleanOptions& options) {
     switch (type) {
         case BooleanType::Union:
-            return Union(shapes);
+            return Union(shapes, options);
         case BooleanType::Intersection:
-            return Intersection(shapes);
+            return Intersection(shapes, options);
         case BooleanType::Difference:
             // 对于差集操作，我们只能处理两个形状
             if (shapes.size() == 2) {
-                return Difference(shapes[0], shapes[1]);
+                return Difference(shapes[0], shapes[1], options);
             }
             return nullptr;
         default:
@@ -79,6 +170,67 @@ ShapePtr BooleanOperations::BooleanOperation(const std::vector<ShapePtr>& shapes
     }
 }
 
+ShapePtr BooleanOperations::Perform(BooleanType type,
+                                    const std::vector<ShapePtr>& targets,
+                                    const std::vector<ShapePtr>& tools,
+                                    const BooleanOptions& options,
+                                    const CancellationTokenPtr& token,
+                                    Handle(BRepTools_History)* history) {
+    // 按运算类型确定参与运算的形状序列
+    std::vector<ShapePtr> operands;
+    switch (type) {
+        case BooleanType::Union:
+        case BooleanType::Intersection:
+            operands = targets;
+            operands.insert(operands.end(), tools.begin(), tools.end());
+            break;
+        case BooleanType::Difference:
+            if (targets.empty() || tools.empty()) {
+                return nullptr;
+            }
+            operands.push_back(targets[0]);
+            operands.insert(operands.end(), tools.begin(), tools.end());
+            break;
+    }
+    if (operands.empty()) {
+        return nullptr;
+    }
+    if (operands.size() == 1) {
+        return operands[0];
+    }
+    
+    Handle(Message_ProgressIndicator) progress;
+    if (token) {
+        progress = new CancellationProgress(token);
+    }
+    Message_ProgressScope scope(progress.IsNull() ? Message_ProgressRange() : progress->Start(),
+                                "Boolean", static_cast<Standard_Real>(operands.size() - 1));
+    
+    ShapePtr result = operands[0];
+    Handle(BRepTools_History) combined;
+    for (size_t i = 1; i < operands.size() && result; ++i) {
+        if (scope.UserBreak()) {
+            return nullptr;
+        }
+        Handle(BRepTools_History) stepHistory;
+        result = PerformOperation(type, result, operands[i], options, scope.Next(),
+                                  history != nullptr ? &stepHistory : nullptr);
+        if (combined.IsNull()) {
+            combined = stepHistory;
+        } else if (!stepHistory.IsNull()) {
+            combined->Merge(stepHistory);
+        }
+    }
+    
+    if (token && token->IsCancelled()) {
+        return nullptr;
+    }
+    if (history != nullptr) {
+        *history = combined;
+    }
+    return result;
+}
+
 bool BooleanOperations::IsValidShape(const ShapePtr& shape) {
     if (!shape || shape->GetOCCTShape().IsNull()) {
         return false;
@@ -109,68 +261,153 @@ ShapePtr BooleanOperations::FixShape(const ShapePtr& shape) {
     return shape;
 }
 
-ShapePtr BooleanOperations::SimplifyShape(const ShapePtr& shape) {
+ShapePtr BooleanOperations::SimplifyShape(const ShapePtr& shape, SimplifyReport* report) {
     if (!shape || shape->GetOCCTShape().IsNull()) {
         return nullptr;
     }
     
-    // 简化形状的实现可以在这里添加
-    // 目前返回原形状
-    return shape;
-}
-
-ShapePtr BooleanOperations::PerformUnion(const ShapePtr& shape1, const ShapePtr& shape2) {
-    if (!ValidateInputs(shape1, shape2)) {
-        return nullptr;
-    }
-    
     try {
-        BRepAlgoAPI_Fuse fuseOp(shape1->GetOCCTShape(), shape2->GetOCCTShape());
-        fuseOp.Build();
+        const TopoDS_Shape& source = shape->GetOCCTShape();
+        const int facesBefore = CountSubShapes(source, TopAbs_FACE);
+        const int edgesBefore = CountSubShapes(source, TopAbs_EDGE);
+        
+        // 合并同域的面和边；不拼接B样条，避免改变曲面类型
+        ShapeUpgrade_UnifySameDomain unifier(source, Standard_True, Standard_True, Standard_False);
+        unifier.AllowInternalEdges(Standard_False);
+        unifier.Build();
         
-        if (fuseOp.IsDone()) {
-            TopoDS_Shape result = fuseOp.Shape();
-            return PostProcessResult(result);
+        const TopoDS_Shape& simplified = unifier.Shape();
+        if (simplified.IsNull()) {
+            return shape;
         }
-    } catch (const Standard_Failure& e) {
-        // 布尔运算失败
+        
+        const int facesAfter = CountSubShapes(simplified, TopAbs_FACE);
+        const int edgesAfter = CountSubShapes(simplified, TopAbs_EDGE);
+        
+        g_simplifyRuns.fetch_add(1);
+        g_simplifyFacesBefore.fetch_add(facesBefore);
+        g_simplifyFacesAfter.fetch_add(facesAfter);
+        g_simplifyEdgesBefore.fetch_add(edgesBefore);
+        g_simplifyEdgesAfter.fetch_add(edgesAfter);
+        
+        if (report) {
+            report->facesBefore = facesBefore;
+            report->facesAfter = facesAfter;
+            report->edgesBefore = edgesBefore;
+            report->edgesAfter = edgesAfter;
+            report->history = unifier.History();
+        }
+        
+        // 没有合并任何面和边时保留原对象，已有的选择和显示不受影响
+        if (facesAfter == facesBefore && edgesAfter == edgesBefore) {
+            return shape;
+        }
+        return std::make_shared<Shape>(simplified);
+    } catch (const Standard_Failure&) {
+        // 简化失败，返回原形状
     }
     
-    return nullptr;
+    return shape;
 }
 
-ShapePtr BooleanOperations::PerformIntersection(const ShapePtr& shape1, const ShapePtr& shape2) {
-    if (!ValidateInputs(shape1, shape2)) {
-        return nullptr;
+std::vector<TopoDS_Shape> BooleanOperations::TrackSubShape(const SimplifyReport& report, const TopoDS_Shape& subShape) {
+    std::vector<TopoDS_Shape> tracked;
+    if (subShape.IsNull()) {
+        return tracked;
     }
-    
-    try {
-        BRepAlgoAPI_Common commonOp(shape1->GetOCCTShape(), shape2->GetOCCTShape());
-        commonOp.Build();
-        
-        if (commonOp.IsDone()) {
-            TopoDS_Shape result = commonOp.Shape();
-            return PostProcessResult(result);
-        }
-    } catch (const Standard_Failure& e) {
-        // 布尔运算失败
+    if (report.history.IsNull()) {
+        tracked.push_back(subShape);
+        return tracked;
+    }
+    if (report.history->IsRemoved(subShape)) {
+        return tracked;
     }
     
-    return nullptr;
+    const TopTools_ListOfShape& modified = report.history->Modified(subShape);
+    if (modified.IsEmpty()) {
+        tracked.push_back(subShape);
+        return tracked;
+    }
+    for (TopTools_ListIteratorOfListOfShape it(modified); it.More(); it.Next()) {
+        tracked.push_back(it.Value());
+    }
+    return tracked;
+}
+
+void BooleanOperations::SetAutoSimplify(bool enabled) {
+    g_autoSimplify.store(enabled);
+}
+
+bool BooleanOperations::IsAutoSimplify() {
+    return g_autoSimplify.load();
+}
+
+SimplifyStatistics BooleanOperations::GetSimplifyStatistics() {
+    SimplifyStatistics statistics;
+    statistics.runs = g_simplifyRuns.load();
+    statistics.facesBefore = g_simplifyFacesBefore.load();
+    statistics.facesAfter = g_simplifyFacesAfter.load();
+    statistics.edgesBefore = g_simplifyEdgesBefore.load();
+    statistics.edgesAfter = g_simplifyEdgesAfter.load();
+    return statistics;
+}
+
+void BooleanOperations::ResetSimplifyStatistics() {
+    g_simplifyRuns.store(0);
+    g_simplifyFacesBefore.store(0);
+    g_simplifyFacesAfter.store(0);
+    g_simplifyEdgesBefore.store(0);
+    g_simplifyEdgesAfter.store(0);
+}
+
+ShapePtr BooleanOperations::PerformUnion(const ShapePtr& shape1, const ShapePtr& shape2, const BooleanOptions& options,
+                                         const Message_ProgressRange& range) {
+    return PerformOperation(BooleanType::Union, shape1, shape2, options, range);
 }
 
-ShapePtr BooleanOperations::PerformDifference(const ShapePtr& shape1, const ShapePtr& shape2) {
+ShapePtr BooleanOperations::PerformIntersection(const ShapePtr& shape1, const ShapePtr& shape2,
+                                                const BooleanOptions& options, const Message_ProgressRange& range) {
+    return PerformOperation(BooleanType::Intersection, shape1, shape2, options, range);
+}
+
+ShapePtr BooleanOperations::PerformDifference(const ShapePtr& shape1, const ShapePtr& shape2,
+                                              const BooleanOptions& options, const Message_ProgressRange& range) {
+    return PerformOperation(BooleanType::Difference, shape1, shape2, options, range);
+}
+
+ShapePtr BooleanOperations::PerformOperation(BooleanType type, const ShapePtr& shape1, const ShapePtr& shape2,
+                                             const BooleanOptions& options, const Message_ProgressRange& range,
+                                             Handle(BRepTools_History)* history) {
     if (!ValidateInputs(shape1, shape2)) {
         return nullptr;
     }
     
     try {
-        BRepAlgoAPI_Cut cutOp(shape1->GetOCCTShape(), shape2->GetOCCTShape());
-        cutOp.Build();
+        std::unique_ptr<BRepAlgoAPI_BooleanOperation> operation;
+        switch (type) {
+            case BooleanType::Union:
+                operation.reset(new BRepAlgoAPI_Fuse());
+                break;
+            case BooleanType::Intersection:
+                operation.reset(new BRepAlgoAPI_Common());
+                break;
+            case BooleanType::Difference:
+                operation.reset(new BRepAlgoAPI_Cut());
+                break;
+        }
         
-        if (cutOp.IsDone()) {
-            TopoDS_Shape result = cutOp.Shape();
-            return PostProcessResult(result);
+        TopTools_ListOfShape arguments;
+        TopTools_ListOfShape tools;
+        arguments.Append(shape1->GetOCCTShape());
+        tools.Append(shape2->GetOCCTShape());
+        operation->SetArguments(arguments);
+        operation->SetTools(tools);
+        ConfigureOperation(*operation, options);
+        operation->Build(range);
+        
+        if (operation->IsDone() && !range.UserBreak()) {
+            TopoDS_Shape result = operation->Shape();
+            return PostProcessResult(result, options, operation->History(), history);
         }
     } catch (const Standard_Failure& e) {
         // 布尔运算失败
@@ -191,7 +428,9 @@ bool BooleanOperations::ValidateInputs(const ShapePtr& shape1, const ShapePtr& s
     return true;
 }
 
-ShapePtr BooleanOperations::PostProcessResult(const TopoDS_Shape& result) {
+ShapePtr BooleanOperations::PostProcessResult(const TopoDS_Shape& result, const BooleanOptions& options,
+                                              const Handle(BRepTools_History)& operationHistory,
+                                              Handle(BRepTools_History)* history) {
     if (result.IsNull()) {
         return nullptr;
     }
@@ -199,12 +438,30 @@ ShapePtr BooleanOperations::PostProcessResult(const TopoDS_Shape& result) {
     // 创建结果形状
     ShapePtr resultShape = std::make_shared<Shape>(result);
     
+    Handle(BRepTools_History) combined = options.history ? operationHistory : Handle(BRepTools_History)();
+    
     // 验证结果
     if (!IsValidShape(resultShape)) {
-        // 尝试修复
+        // 尝试修复；修复会替换子形状，布尔历史不再对应结果
         resultShape = FixShape(resultShape);
+        combined.Nullify();
+    }
+    
+    // 合并布尔运算拆分出的共面/共柱面，后续运算、网格化和拾取都更快
+    if (resultShape && options.simplify) {
+        SimplifyReport report;
+        ShapePtr simplified = SimplifyShape(resultShape, options.history ? &report : nullptr);
+        
+        // 布尔历史（输入 -> 运算结果）接上简化历史（运算结果 -> 简化结果）
+        if (simplified != resultShape && !combined.IsNull() && !report.history.IsNull()) {
+            combined->Merge(report.history);
+        }
+        resultShape = simplified;
     }
     
+    if (history != nullptr) {
+        *history = combined;
+    }
     return resultShape;
 }
 
@@ -0,0 +1,19 @@
+﻿#include "cad_core/CancellationToken.h"
+
+namespace cad_core {
+
+CancellationProgress::CancellationProgress(const CancellationTokenPtr& token)
+    : m_token(token) {
+}
+
+Standard_Boolean CancellationProgress::UserBreak() {
+    return m_token && m_token->IsCancelled();
+}
+
+void CancellationProgress::Show(const Message_ProgressScope& scope, const Standard_Boolean force) {
+    // 只用于取消，不显示进度
+    (void)scope;
+    (void)force;
+}
+
+} // namespace cad_core
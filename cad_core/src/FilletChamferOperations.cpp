@@ -11,12 +11,176 @@
 #include <GProp_GProps.hxx>
 #include <BRepGProp.hxx>
 #include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <Message_ProgressScope.hxx>
+#include <OSD_Parallel.hxx>
+#include <BRepAdaptor_Curve.hxx>
+#include <BRepAdaptor_Surface.hxx>
+#include <BRepLProp_CLProps.hxx>
+#include <BRepLProp_SLProps.hxx>
+#include <BRepBuilderAPI_MakeVertex.hxx>
+#include <BRepExtrema_DistShapeShape.hxx>
+#include <BRep_Builder.hxx>
+#include <ChFi3d.hxx>
+#include <Geom2d_Curve.hxx>
+#include <TopoDS_Compound.hxx>
+#include <Precision.hxx>
+#include <Bnd_Box.hxx>
+#include <BRepBndLib.hxx>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <Standard_Failure.hxx>
 
 namespace cad_core {
 
-ShapePtr FilletChamferOperations::CreateFillet(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius) {
-    return PerformFillet(shape, edges, radius);
+namespace {
+
+// 拓扑副本及其上对应的边：副本与原形状的边按 MapShapes 序号一一对应
+ShapePtr CopyWithEdges(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges,
+                       std::vector<TopoDS_Edge>& copiedEdges) {
+    BRepBuilderAPI_Copy copier(shape->GetOCCTShape(), Standard_False, Standard_False);
+    ShapePtr copy = std::make_shared<Shape>(copier.Shape());
+    
+    TopTools_IndexedMapOfShape sourceEdges;
+    TopTools_IndexedMapOfShape copyEdges;
+    TopExp::MapShapes(shape->GetOCCTShape(), TopAbs_EDGE, sourceEdges);
+    TopExp::MapShapes(copy->GetOCCTShape(), TopAbs_EDGE, copyEdges);
+    copiedEdges.clear();
+    for (const auto& edge : edges) {
+        const Standard_Integer index = sourceEdges.FindIndex(edge);
+        if (index > 0 && index <= copyEdges.Extent()) {
+            copiedEdges.push_back(TopoDS::Edge(copyEdges(index)));
+        }
+    }
+    return copy;
+}
+
+// 面在边上某参数处的外法向
+bool FaceNormalOnEdge(const TopoDS_Face& face, const TopoDS_Edge& edge, double parameter, gp_Dir& normal) {
+    Standard_Real first = 0.0;
+    Standard_Real last = 0.0;
+    Handle(Geom2d_Curve) pcurve = BRep_Tool::CurveOnSurface(edge, face, first, last);
+    if (pcurve.IsNull()) {
+        return false;
+    }
+    
+    gp_Pnt2d uv = pcurve->Value(parameter);
+    BRepAdaptor_Surface surface(face);
+    BRepLProp_SLProps props(surface, uv.X(), uv.Y(), 1, Precision::Confusion());
+    if (!props.IsNormalDefined()) {
+        return false;
+    }
+    normal = props.Normal();
+    if (face.Orientation() == TopAbs_REVERSED) {
+        normal.Reverse();
+    }
+    return true;
+}
+
+// 面上与该边不相接的边界边，用于度量面在边法向上的宽度
+TopoDS_Compound OppositeBoundary(const TopoDS_Face& face, const TopoDS_Edge& edge, bool& hasEdges) {
+    TopoDS_Vertex v1;
+    TopoDS_Vertex v2;
+    TopExp::Vertices(edge, v1, v2);
+    
+    TopoDS_Compound boundary;
+    BRep_Builder builder;
+    builder.MakeCompound(boundary);
+    hasEdges = false;
+    for (TopExp_Explorer exp(face, TopAbs_EDGE); exp.More(); exp.Next()) {
+        const TopoDS_Edge& other = TopoDS::Edge(exp.Current());
+        if (other.IsSame(edge)) {
+            continue;
+        }
+        TopoDS_Vertex o1;
+        TopoDS_Vertex o2;
+        TopExp::Vertices(other, o1, o2);
+        if (o1.IsSame(v1) || o1.IsSame(v2) || o2.IsSame(v1) || o2.IsSame(v2)) {
+            continue;
+        }
+        builder.Add(boundary, other);
+        hasEdges = true;
+    }
+    return boundary;
+}
+
+// GetSuggestedFilletRadius 使用的进程内缓存
+FilletRadiusCache& SuggestionCache() {
+    static FilletRadiusCache cache;
+    return cache;
+}
+
+} // anonymous namespace
+
+FilletRadiusCache::Key FilletRadiusCache::MakeKey(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges,
+                                                  std::vector<Handle(Standard_Transient)>* holders) {
+    // 半径只与几何有关，位置和方向不影响，按 TShape 区分；边的顺序无关
+    std::vector<Handle(Standard_Transient)> edgeShapes;
+    for (const auto& edge : edges) {
+        if (!edge.IsNull()) {
+            edgeShapes.push_back(edge.TShape());
+        }
+    }
+    std::sort(edgeShapes.begin(), edgeShapes.end(),
+              [](const Handle(Standard_Transient)& a, const Handle(Standard_Transient)& b) { return a.get() < b.get(); });
+    edgeShapes.erase(std::unique(edgeShapes.begin(), edgeShapes.end()), edgeShapes.end());
+    
+    Key key;
+    key.push_back(shape->GetOCCTShape().TShape().get());
+    for (const auto& edgeShape : edgeShapes) {
+        key.push_back(edgeShape.get());
+    }
+    if (holders != nullptr) {
+        holders->clear();
+        holders->push_back(shape->GetOCCTShape().TShape());
+        holders->insert(holders->end(), edgeShapes.begin(), edgeShapes.end());
+    }
+    return key;
+}
+
+bool FilletRadiusCache::Find(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges,
+                             FilletRadiusRange& range) const {
+    if (!shape || shape->GetOCCTShape().IsNull()) {
+        return false;
+    }
+    
+    const Key key = MakeKey(shape, edges, nullptr);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return false;
+    }
+    range = it->second.range;
+    return true;
+}
+
+void FilletRadiusCache::Store(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges,
+                              const FilletRadiusRange& range) {
+    if (!shape || shape->GetOCCTShape().IsNull() || !range.estimated) {
+        return;
+    }
+    
+    Entry entry;
+    const Key key = MakeKey(shape, edges, &entry.holders);
+    entry.range = range;
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_entries.size() >= MaxEntries && m_entries.find(key) == m_entries.end()) {
+        m_entries.clear();
+    }
+    m_entries[key] = std::move(entry);
+}
+
+void FilletRadiusCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+ShapePtr FilletChamferOperations::CreateFillet(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius,
+                                               const Message_ProgressRange& range) {
+    return PerformFillet(shape, edges, radius, range);
 }
 
 ShapePtr FilletChamferOperations::CreateFillet(const ShapePtr& shape, const TopoDS_Edge& edge, double radius) {
@@ -45,8 +209,9 @@ ShapePtr FilletChamferOperations::CreateVariableFillet(const ShapePtr& shape, co
     return nullptr;
 }
 
-ShapePtr FilletChamferOperations::CreateChamfer(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double distance) {
-    return PerformChamfer(shape, edges, distance);
+ShapePtr FilletChamferOperations::CreateChamfer(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double distance,
+                                                const Message_ProgressRange& range) {
+    return PerformChamfer(shape, edges, distance, range);
 }
 
 ShapePtr FilletChamferOperations::CreateChamfer(const ShapePtr& shape, const TopoDS_Edge& edge, double distance) {
@@ -106,6 +271,48 @@ ShapePtr FilletChamferOperations::CreateChamferByAngle(const ShapePtr& shape, co
     return nullptr;
 }
 
+std::vector<ShapePtr> FilletChamferOperations::CreateFillets(const std::vector<EdgeBlendJob>& jobs, double radius,
+                                                            bool parallel) {
+    return PerformBatch(jobs, parallel, true, radius);
+}
+
+std::vector<ShapePtr> FilletChamferOperations::CreateChamfers(const std::vector<EdgeBlendJob>& jobs, double distance,
+                                                             bool parallel) {
+    return PerformBatch(jobs, parallel, false, distance);
+}
+
+std::vector<ShapePtr> FilletChamferOperations::PerformBatch(const std::vector<EdgeBlendJob>& jobs, bool parallel,
+                                                            bool fillet, double size) {
+    std::vector<ShapePtr> results(jobs.size());
+    const bool concurrent = parallel && jobs.size() > 1;
+    
+    // 每个实体独立运算，结果写入各自的槽位，顺序与调用方给出的一致
+    auto runJob = [&](const Standard_Integer index) {
+        const EdgeBlendJob& job = jobs[index];
+        if (!job.shape || job.shape->GetOCCTShape().IsNull() || job.edges.empty()) {
+            return;
+        }
+        
+        try {
+            ShapePtr shape = job.shape;
+            std::vector<TopoDS_Edge> edges = job.edges;
+            
+            // 并行时在拓扑副本上运算：圆角算法会更新输入边的容差和参数曲线，
+            // 而不同实体可能共享同一个 TShape
+            if (concurrent) {
+                shape = CopyWithEdges(job.shape, job.edges, edges);
+            }
+            
+            results[index] = fillet ? PerformFillet(shape, edges, size) : PerformChamfer(shape, edges, size);
+        } catch (const Standard_Failure&) {
+            // 单个实体失败不影响其他实体
+        }
+    };
+    
+    OSD_Parallel::For(0, static_cast<Standard_Integer>(jobs.size()), runJob, !concurrent);
+    return results;
+}
+
 ShapePtr FilletChamferOperations::CreateFaceFillet(const ShapePtr& shape, const std::vector<TopoDS_Face>& faces, double radius) {
     if (!shape || shape->GetOCCTShape().IsNull() || faces.empty()) {
         return nullptr;
@@ -218,6 +425,17 @@ double FilletChamferOperations::GetSuggestedFilletRadius(const ShapePtr& shape,
         suggestedRadius = minRadius * 0.8;
     }
     
+    // 同时不超过几何上界，留出余量；估计结果按边缓存
+    FilletRadiusRange range;
+    if (!SuggestionCache().Find(shape, {edge}, range)) {
+        range = EstimateMaxFilletRadius(shape, edge);
+        SuggestionCache().Store(shape, {edge}, range);
+    }
+    if (range.valid) {
+        suggestedRadius = std::min(suggestedRadius, range.maxRadius * 0.8);
+        suggestedRadius = std::max(suggestedRadius, range.minRadius);
+    }
+    
     return suggestedRadius;
 }
 
@@ -225,7 +443,200 @@ double FilletChamferOperations::GetSuggestedChamferDistance(const ShapePtr& shap
     return GetSuggestedFilletRadius(shape, edge); // 使用相同的逻辑
 }
 
-ShapePtr FilletChamferOperations::PerformFillet(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius) {
+FilletFailureReport FilletChamferOperations::AnalyzeFilletFailure(const ShapePtr& shape,
+                                                                  const std::vector<TopoDS_Edge>& edges,
+                                                                  double radius,
+                                                                  const Message_ProgressRange& range) {
+    FilletFailureReport report;
+    if (!shape || shape->GetOCCTShape().IsNull() || edges.empty() || radius <= 0.0) {
+        return report;
+    }
+    
+    try {
+        BRepFilletAPI_MakeFillet fillet(shape->GetOCCTShape());
+        for (const auto& edge : edges) {
+            if (!edge.IsNull() && IsValidEdgeForFillet(shape, edge)) {
+                fillet.Add(radius, edge);
+            }
+        }
+        
+        fillet.Build(range);
+        if (fillet.IsDone()) {
+            report.succeeded = true;
+            return report;
+        }
+        
+        // 失败的轮廓（相切连续的一串边）整体报告
+        for (Standard_Integer i = 1; i <= fillet.NbFaultyContours(); ++i) {
+            const Standard_Integer contour = fillet.FaultyContour(i);
+            for (Standard_Integer j = 1; j <= fillet.NbEdges(contour); ++j) {
+                report.faultyEdges.push_back(fillet.Edge(contour, j));
+            }
+        }
+        for (Standard_Integer i = 1; i <= fillet.NbFaultyVertices(); ++i) {
+            report.faultyVertices.push_back(fillet.FaultyVertex(i));
+        }
+    } catch (const Standard_Failure&) {
+        // 算法异常中断，没有轮廓信息
+    }
+    
+    return report;
+}
+
+FilletFailureReport FilletChamferOperations::AnalyzeChamferFailure(const ShapePtr& shape,
+                                                                   const std::vector<TopoDS_Edge>& edges,
+                                                                   double distance,
+                                                                   const Message_ProgressRange& range) {
+    FilletFailureReport report;
+    if (!shape || shape->GetOCCTShape().IsNull() || edges.empty() || distance <= 0.0) {
+        return report;
+    }
+    
+    // 倒角算法不报告失败轮廓，逐条边单独试算
+    Message_ProgressScope scope(range, "Chamfer analysis", static_cast<Standard_Real>(edges.size()));
+    bool allBuilt = true;
+    for (const auto& edge : edges) {
+        if (scope.UserBreak()) {
+            return report;
+        }
+        if (!PerformChamfer(shape, {edge}, distance, scope.Next())) {
+            report.faultyEdges.push_back(edge);
+            allBuilt = false;
+        }
+    }
+    
+    // 单条边都能倒角时再确认组合结果
+    if (allBuilt) {
+        report.succeeded = PerformChamfer(shape, edges, distance) != nullptr;
+    }
+    
+    return report;
+}
+
+FilletRadiusRange FilletChamferOperations::EstimateMaxFilletRadius(const ShapePtr& shape, const TopoDS_Edge& edge) {
+    return EstimateFilletRadiusRange(shape, {edge});
+}
+
+FilletRadiusRange FilletChamferOperations::EstimateFilletRadiusRange(const ShapePtr& shape,
+                                                                     const std::vector<TopoDS_Edge>& edges,
+                                                                     bool refine, int iterations,
+                                                                     const Message_ProgressRange& range,
+                                                                     FilletRadiusRange* progress) {
+    FilletRadiusRange result;
+    if (!shape || shape->GetOCCTShape().IsNull() || edges.empty()) {
+        return result;
+    }
+    
+    try {
+        if (progress != nullptr && progress->estimated) {
+            // 几何估计已完成（可能还有部分试算），直接继续
+            result = *progress;
+        } else {
+            TopTools_IndexedDataMapOfShapeListOfShape edgeFaces;
+            TopExp::MapShapesAndAncestors(shape->GetOCCTShape(), TopAbs_EDGE, TopAbs_FACE, edgeFaces);
+            
+            // 各边的几何上界互不相关，并行计算（只读访问形状）
+            std::vector<double> bounds(edges.size(), 0.0);
+            OSD_Parallel::For(0, static_cast<Standard_Integer>(edges.size()), [&](const Standard_Integer index) {
+                try {
+                    bounds[index] = ComputeRadiusUpperBound(edgeFaces, edges[index]);
+                } catch (const Standard_Failure&) {
+                    bounds[index] = 0.0;
+                }
+            }, edges.size() < 2);
+            
+            double bound = *std::min_element(bounds.begin(), bounds.end());
+            Bnd_Box box;
+            BRepBndLib::Add(shape->GetOCCTShape(), box);
+            if (!box.IsVoid()) {
+                bound = std::min(bound, std::sqrt(box.SquareExtent()) * 0.5);
+            }
+            
+            // 下界：半径需明显大于边的容差
+            double minRadius = Precision::Confusion() * 10.0;
+            for (const auto& edge : edges) {
+                minRadius = std::max(minRadius, BRep_Tool::Tolerance(edge) * 10.0);
+            }
+            
+            result.estimated = true;
+            result.boundRadius = bound;
+            result.minRadius = minRadius;
+            result.valid = bound > minRadius;
+            result.maxRadius = result.valid ? bound : 0.0;
+            if (progress != nullptr) {
+                *progress = result;
+            }
+        }
+        if (!result.valid || !refine || result.refined) {
+            return result;
+        }
+        
+        // 试算细化：在拓扑副本上只对所选边建圆角，先试上界，失败再二分。
+        // 每次试算后写回进度；因取消而失败的试算不记录
+        std::vector<TopoDS_Edge> trialEdges;
+        ShapePtr trialShape = CopyWithEdges(shape, edges, trialEdges);
+        Message_ProgressScope scope(range, "Fillet radius refinement", static_cast<Standard_Real>(iterations + 1));
+        auto trial = [&](double radius) {
+            return PerformFillet(trialShape, trialEdges, radius, scope.Next()) != nullptr;
+        };
+        auto save = [&]() {
+            if (progress != nullptr) {
+                *progress = result;
+            }
+        };
+        
+        const double top = result.boundRadius * (1.0 - 1.0e-3);
+        if (result.passedRadius <= 0.0 && result.failedRadius <= 0.0) {
+            if (trial(top)) {
+                result.passedRadius = top;
+                result.maxRadius = top;
+                result.refined = true;
+                save();
+                return result;
+            }
+            if (scope.UserBreak()) {
+                return result;
+            }
+            result.failedRadius = top;
+            save();
+        }
+        
+        double low = (result.passedRadius > 0.0) ? result.passedRadius : result.minRadius;
+        double high = result.failedRadius;
+        while (result.bisectionSteps < iterations) {
+            if (scope.UserBreak()) {
+                return result;
+            }
+            const double middle = 0.5 * (low + high);
+            const bool passed = trial(middle);
+            if (!passed && scope.UserBreak()) {
+                return result;
+            }
+            if (passed) {
+                low = middle;
+                result.passedRadius = middle;
+            } else {
+                high = middle;
+                result.failedRadius = middle;
+            }
+            ++result.bisectionSteps;
+            save();
+        }
+        
+        result.valid = result.passedRadius > 0.0;
+        result.maxRadius = result.passedRadius;
+        result.refined = true;
+        save();
+    } catch (const Standard_Failure&) {
+        // 估计失败
+        result.valid = false;
+    }
+    
+    return result;
+}
+
+ShapePtr FilletChamferOperations::PerformFillet(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius,
+                                                const Message_ProgressRange& range) {
     if (!shape || shape->GetOCCTShape().IsNull() || edges.empty() || radius <= 0.0) {
         return nullptr;
     }
@@ -239,9 +650,9 @@ ShapePtr FilletChamferOperations::PerformFillet(const ShapePtr& shape, const std
             }
         }
         
-        fillet.Build();
+        fillet.Build(range);
         
-        if (fillet.IsDone()) {
+        if (fillet.IsDone() && !range.UserBreak()) {
             TopoDS_Shape result = fillet.Shape();
             return PostProcessResult(result);
         }
@@ -252,7 +663,8 @@ ShapePtr FilletChamferOperations::PerformFillet(const ShapePtr& shape, const std
     return nullptr;
 }
 
-ShapePtr FilletChamferOperations::PerformChamfer(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double distance) {
+ShapePtr FilletChamferOperations::PerformChamfer(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double distance,
+                                                 const Message_ProgressRange& range) {
     if (!shape || shape->GetOCCTShape().IsNull() || edges.empty() || distance <= 0.0) {
         return nullptr;
     }
@@ -269,9 +681,9 @@ ShapePtr FilletChamferOperations::PerformChamfer(const ShapePtr& shape, const st
             }
         }
         
-        chamfer.Build();
+        chamfer.Build(range);
         
-        if (chamfer.IsDone()) {
+        if (chamfer.IsDone() && !range.UserBreak()) {
             TopoDS_Shape result = chamfer.Shape();
             return PostProcessResult(result);
         }
@@ -319,6 +731,113 @@ double FilletChamferOperations::GetEdgeLength(const TopoDS_Edge& edge) {
     return props.Mass();
 }
 
+double FilletChamferOperations::ComputeRadiusUpperBound(const TopTools_IndexedDataMapOfShapeListOfShape& edgeFaces,
+                                                       const TopoDS_Edge& edge) {
+    if (edge.IsNull() || !edgeFaces.Contains(edge)) {
+        return 0.0;
+    }
+    
+    // 相邻的两个面（缝合边会重复出现同一个面）
+    std::vector<TopoDS_Face> faces;
+    for (TopTools_ListIteratorOfListOfShape it(edgeFaces.FindFromKey(edge)); it.More(); it.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(it.Value());
+        bool duplicate = false;
+        for (const auto& known : faces) {
+            duplicate = duplicate || known.IsSame(face);
+        }
+        if (!duplicate) {
+            faces.push_back(face);
+        }
+    }
+    if (faces.size() != 2) {
+        return 0.0;
+    }
+    
+    double bound = std::numeric_limits<double>::max();
+    const ChFiDS_TypeOfConcavity concavity = ChFi3d::DefineConnectType(edge, faces[0], faces[1],
+                                                                       1.0e-6, Standard_False);
+    
+    bool hasOpposite[2] = {false, false};
+    TopoDS_Compound opposite[2] = {
+        OppositeBoundary(faces[0], edge, hasOpposite[0]),
+        OppositeBoundary(faces[1], edge, hasOpposite[1])
+    };
+    
+    BRepAdaptor_Curve curve(edge);
+    const double first = curve.FirstParameter();
+    const double last = curve.LastParameter();
+    double maxHalfAngleTan = 0.0;
+    
+    for (double fraction : {0.1, 0.5, 0.9}) {
+        const double parameter = first + (last - first) * fraction;
+        gp_Dir n1;
+        gp_Dir n2;
+        if (!FaceNormalOnEdge(faces[0], edge, parameter, n1) || !FaceNormalOnEdge(faces[1], edge, parameter, n2)) {
+            continue;
+        }
+        
+        // 二面角 φ 处半径 r 的圆角在两个面上各切入 r·tan(φ/2)
+        const double halfAngleTan = std::tan(0.5 * n1.Angle(n2));
+        maxHalfAngleTan = std::max(maxHalfAngleTan, halfAngleTan);
+        const gp_Pnt point = curve.Value(parameter);
+        
+        // 面宽度：切入距离不能超过该处到面上对边的距离
+        if (halfAngleTan > Precision::Angular()) {
+            TopoDS_Vertex probe = BRepBuilderAPI_MakeVertex(point);
+            for (int i = 0; i < 2; ++i) {
+                if (!hasOpposite[i]) {
+                    continue;
+                }
+                BRepExtrema_DistShapeShape distance(probe, opposite[i]);
+                if (distance.IsDone() && distance.Value() > Precision::Confusion()) {
+                    bound = std::min(bound, distance.Value() / halfAngleTan);
+                }
+            }
+        }
+        
+        // 边曲率：圆角中心偏向曲率中心一侧时，圆角管道会在曲率中心处自交
+        BRepLProp_CLProps curveProps(curve, parameter, 2, Precision::Confusion());
+        if (curveProps.IsTangentDefined() && curveProps.Curvature() > Precision::Confusion()) {
+            gp_Dir towardsCenter;
+            curveProps.Normal(towardsCenter);
+            gp_Vec bisector = gp_Vec(n1) + gp_Vec(n2);
+            if (bisector.Magnitude() > Precision::Confusion()) {
+                // 凸边的圆角中心在材料内侧，与两面外法向之和相反
+                if (concavity == ChFiDS_Convex) {
+                    bisector.Reverse();
+                }
+                const double alignment = gp_Vec(towardsCenter).Dot(bisector.Normalized());
+                if (alignment > 0.1) {
+                    bound = std::min(bound, 1.0 / (curveProps.Curvature() * alignment));
+                }
+            }
+        }
+    }
+    
+    // 相邻边：圆角在端点处沿相邻边切入，不能超过相邻边的长度
+    if (maxHalfAngleTan > Precision::Angular()) {
+        TopoDS_Vertex v1;
+        TopoDS_Vertex v2;
+        TopExp::Vertices(edge, v1, v2);
+        for (const auto& face : faces) {
+            for (TopExp_Explorer exp(face, TopAbs_EDGE); exp.More(); exp.Next()) {
+                const TopoDS_Edge& other = TopoDS::Edge(exp.Current());
+                if (other.IsSame(edge)) {
+                    continue;
+                }
+                TopoDS_Vertex o1;
+                TopoDS_Vertex o2;
+                TopExp::Vertices(other, o1, o2);
+                if (o1.IsSame(v1) || o1.IsSame(v2) || o2.IsSame(v1) || o2.IsSame(v2)) {
+                    bound = std::min(bound, GetEdgeLength(other) / maxHalfAngleTan);
+                }
+            }
+        }
+    }
+    
+    return bound;
+}
+
 double FilletChamferOperations::GetMinimumRadius(const ShapePtr& shape, const TopoDS_Edge& edge) {
     if (!shape || shape->GetOCCTShape().IsNull() || edge.IsNull()) {
         return 0.0;
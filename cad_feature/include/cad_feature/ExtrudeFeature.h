@@ -11,6 +11,18 @@ public:
     ExtrudeFeature(const std::string& name);
     virtual ~ExtrudeFeature() = default;
 
+    // 参数索引，名称和默认值见 Schema()
+    enum Parameter : int {
+        Distance,
+        DirectionX,
+        DirectionY,
+        DirectionZ,
+        TaperAngle,
+        Midplane,
+        ParameterCount
+    };
+    static const ParameterSchema& Schema();
+
     // Sketch operations
     void SetSketch(const cad_sketch::SketchPtr& sketch);
     const cad_sketch::SketchPtr& GetSketch() const;
@@ -22,6 +34,7 @@ public:
     void SetDirection(double x, double y, double z);
     void GetDirection(double& x, double& y, double& z) const;
     
+    // 拔模角暂不支持：非0时 ValidateParameters 失败
     void SetTaperAngle(double angle);
     double GetTaperAngle() const;
     
@@ -30,14 +43,18 @@ public:
     
     // Feature interface
     cad_core::ShapePtr CreateShape() const override;
+    cad_core::ShapePtr CreatePreviewShape() const override;
     bool ValidateParameters() const override;
     std::shared_ptr<cad_core::ICommand> CreateCommand() const override;
+    FeaturePtr Clone() const override;
+    std::vector<cad_sketch::SketchPtr> GetInputSketches() const override;
 
 private:
     cad_sketch::SketchPtr m_sketch;
     
     bool IsSketchValid() const;
-    cad_core::ShapePtr ExtrudeSketch() const;
+    // preview 为 true 时按 PreviewOptions 降低精度
+    cad_core::ShapePtr ExtrudeSketch(bool preview) const;
 };
 
 using ExtrudeFeaturePtr = std::shared_ptr<ExtrudeFeature>;
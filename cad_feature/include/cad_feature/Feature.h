@@ -8,7 +8,6 @@
  * 特征系统是参数化建模的灵魂，让用户能够轻松修改设计参数，
  * 而整个模型会自动重新计算和更新。这就是现代CAD的神奇之处！🪄
  * 
- * TODO: 添加特征依赖关系管理
  * TODO: 实现特征的自动错误恢复
  * TODO: 支持特征模板和预设
  * TODO: 添加特征性能分析工具
@@ -18,9 +17,17 @@
 
 #include "cad_core/Shape.h"    // 几何形状基础 - 特征的"原材料"
 #include "cad_core/ICommand.h" // 命令接口 - 让特征具备撤销/重做能力
+#include "ParameterSchema.h"   // 参数表 - 每种特征有哪些"旋钮"
+#include "cad_core/CancellationToken.h" // 取消标志 - 预览过期时及时"收手"
+#include <map>                 // 有序映射 - 草图到轮廓快照
 #include <memory>              // 智能指针 - 现代C++的内存管家
 #include <string>              // 字符串 - 特征名称和参数的载体
-#include <map>                 // 映射容器 - 参数名到参数值的字典
+#include <vector>              // 动态数组 - 输入草图列表
+
+namespace cad_sketch {
+class Sketch;                  // 前向声明 - 特征只需要知道草图"是谁"
+struct SketchProfile;
+}
 
 namespace cad_feature {
 
@@ -42,7 +49,8 @@ enum class FeatureType {
     Shell,        // 抽壳 - 把实体掏空，做个容器
     Cut,          // 切除 - 用一个几何体去"咬"另一个
     Union,        // 合并 - 把多个几何体合成一个
-    Intersection  // 相交 - 只保留重叠的部分
+    Intersection, // 相交 - 只保留重叠的部分
+    Pattern       // 阵列 - 一个孔变一排孔，一次切完不用排队
 };
 
 /**
@@ -59,6 +67,34 @@ enum class FeatureState {
     Failed       // 执行失败 - 出了点小意外，需要调试
 };
 
+/**
+ * @struct PreviewOptions
+ * @brief 预览精度设置 - 预览要的是"快"，不是"准"
+ * 
+ * 预览路径用更松的容差、更粗的近似，跳过参数验证和形状修复；
+ * 正式构建始终用完整精度，不受这些设置影响。
+ */
+struct PreviewOptions {
+    double tolerance = 1.0e-3;             // 构造容差，正式构建用 Precision::Confusion()
+    int maxDegree = 3;                     // 扫掠/放样近似曲面的最高阶次
+    int maxSegments = 4;                   // 扫掠/放样近似曲面的最多段数
+    bool meshOnly = false;                 // 只要网格 - 在计算线程上粗网格化，显示时不用再算
+    double meshRelativeDeflection = 0.01;  // 网格弦高（相对包围盒对角线）
+};
+
+/**
+ * @struct KernelTimings
+ * @brief 一次正式构建的内核耗时 - 时间都花到哪儿去了？
+ * 
+ * 单位为毫秒。构建时间是 CreateShape 的总耗时扣掉修复和检查，
+ * 不走 FinalizeShape 的特征全部算作构建。
+ */
+struct KernelTimings {
+    double buildMs = 0.0;      // 生成几何
+    double validateMs = 0.0;   // BRepCheck 有效性检查
+    double healMs = 0.0;       // ShapeFix 修复
+};
+
 /**
  * @class Feature
  * @brief 特征基类 - 所有建模操作的"祖师爷"
@@ -78,6 +114,14 @@ public:
      */
     Feature(FeatureType type, const std::string& name);
     
+    /**
+     * 带参数表的构造函数 - 参数值初始化为参数表中的默认值
+     * @param type 特征类型
+     * @param name 特征名称
+     * @param schema 该特征类型的静态参数表，需比特征活得久
+     */
+    Feature(FeatureType type, const std::string& name, const ParameterSchema& schema);
+    
     /** 虚析构函数 - 确保派生类能优雅地"告别江湖" */
     virtual ~Feature() = default;
 
@@ -138,16 +182,36 @@ public:
     // ========== 参数管理 - 特征的"控制面板" ==========
     
     /** 
-     * 设置参数 - 调整特征的"旋钮"
+     * 按索引获取参数 - 热路径用这个，就是一次数组访问
+     * @param index 特征类中参数枚举的值
+     * @return 参数的当前值
+     */
+    double GetParameter(int index) const { return m_values[index]; }
+    
+    /** 
+     * 按索引设置参数 - 值真的变了才标记为已修改
+     * @param index 特征类中参数枚举的值
+     * @param value 参数值
+     */
+    void SetParameter(int index, double value) {
+        if (m_values[index] != value) {
+            m_values[index] = value;
+            MarkModified();
+        }
+    }
+    
+    /** 
+     * 设置参数 - 按名称调整"旋钮"，给界面和序列化用
+     * 参数表里没有的名称会被忽略
      * @param name 参数名称，比如"拉伸距离"、"旋转角度"等
      * @param value 参数值，数字说话最直接
      */
     void SetParameter(const std::string& name, double value);
     
     /** 
-     * 获取参数值 - 看看某个"旋钮"调到了多少
+     * 获取参数值 - 按名称看看某个"旋钮"调到了多少
      * @param name 参数名称
-     * @return 参数的当前值
+     * @return 参数的当前值，没有该参数时为0
      */
     double GetParameter(const std::string& name) const;
     
@@ -158,6 +222,82 @@ public:
      */
     bool HasParameter(const std::string& name) const;
     
+    /** 
+     * 获取参数表 - 界面靠它列出所有参数名称
+     * @return 该特征类型的参数表
+     */
+    const ParameterSchema& GetSchema() const;
+    
+    /** 
+     * 获取全部参数值 - 顺序与参数表一致
+     * @return 参数值数组
+     */
+    const std::vector<double>& GetParameterValues() const;
+    
+    // ========== 依赖与脏标记 - 只重算真正受影响的特征 ==========
+    
+    /** 
+     * 检查特征是否"脏了" - 参数或输入变化后需要重新计算
+     * @return true表示需要重建
+     */
+    bool IsDirty() const;
+    
+    /** 标记为脏 - 下次重建时会重新计算，版本号不变 */
+    void MarkDirty();
+    
+    /** 标记为已修改 - 参数或输入真的变了，版本号加一并标记为脏 */
+    void MarkModified();
+    
+    /** 清除脏标记 - 重建完成后由 FeatureManager 调用 */
+    void ClearDirty();
+    
+    /** 
+     * 获取版本号 - 每次参数或输入变化都会加一
+     * @return 当前版本号
+     */
+    unsigned long GetVersion() const;
+    
+    /** 
+     * 获取输入草图 - FeatureManager 靠它发现草图被改过
+     * 默认没有草图输入，基于草图的特征需要重写
+     * @return 输入草图列表
+     */
+    virtual std::vector<std::shared_ptr<cad_sketch::Sketch>> GetInputSketches() const;
+    
+    /** 
+     * 获取最近一次执行的结果 - 没重建的特征直接用它
+     * @return 结果形状，未执行或失败时为空
+     */
+    const cad_core::ShapePtr& GetResultShape() const;
+    
+    /** 
+     * 设置执行结果
+     * @param shape 新生成的形状
+     * @param key 结果对应的缓存键，0表示不参与缓存
+     */
+    void SetResultShape(const cad_core::ShapePtr& shape, std::size_t key = 0);
+    
+    /** 
+     * 获取结果的缓存键 - 和新算出的键一样就不用重算了
+     * @return 上一次结果的缓存键
+     */
+    std::size_t GetResultKey() const;
+    
+    /** 
+     * 计算缓存键 - 特征类型、参数、输入草图内容和上游结果键的"指纹"
+     * 只要这些都没变，结果就一定没变
+     * @param inputKeys 各输入特征结果的缓存键
+     * @return 缓存键
+     */
+    std::size_t ComputeCacheKey(const std::vector<std::size_t>& inputKeys) const;
+    
+    /** 
+     * 接收上游特征的结果 - 重建前由 FeatureManager 按依赖顺序传入
+     * 默认不使用上游形状，需要"吃"上游实体的特征自己重写
+     * @param shapes 各输入特征的结果形状
+     */
+    virtual void SetInputShapes(const std::vector<cad_core::ShapePtr>& shapes);
+    
     // ========== 形状操作 - 特征的"表演时刻" ==========
     
     /** 
@@ -167,13 +307,39 @@ public:
      */
     virtual cad_core::ShapePtr CreateShape() const = 0;
     
+    /** 
+     * 计时创建形状 - 和 CreateShape 一样，顺便记下各阶段耗时
+     * 重建分析器用它找出拖慢重建的"元凶"
+     * @return 生成的几何形状
+     */
+    cad_core::ShapePtr CreateShapeTimed() const;
+    
+    /** 
+     * 获取最近一次计时构建的各阶段耗时
+     * @return 内核耗时
+     */
+    const KernelTimings& GetLastKernelTimings() const;
+    
     /** 
      * 创建预览形状 - 让用户提前"试看"效果
-     * 默认和正式创建一样，但可以做得更快一些
+     * 默认和正式创建一样；基于草图的特征走按 PreviewOptions 降低精度的快速路径
+     * 重写时不做完整的参数验证和形状修复，只排除根本算不出来的输入
      * @return 预览用的几何形状
      */
     virtual cad_core::ShapePtr CreatePreviewShape() const;
     
+    /** 
+     * 设置预览精度 - 想要更快还是更准，自己拿主意
+     * @param options 预览精度设置
+     */
+    void SetPreviewOptions(const PreviewOptions& options);
+    
+    /** 
+     * 获取预览精度设置
+     * @return 当前的预览精度设置
+     */
+    const PreviewOptions& GetPreviewOptions() const;
+    
     /** 
      * 验证参数 - 检查参数设置是否合理
      * 避免用户设置奇葩参数导致程序崩溃
@@ -188,8 +354,73 @@ public:
      * @return 对应的命令对象
      */
     virtual std::shared_ptr<cad_core::ICommand> CreateCommand() const = 0;
+    
+    // ========== 后台计算 - 让慢特征不卡界面 ==========
+    
+    /** 
+     * 复制特征 - 工作线程拿副本去算，界面继续改原件互不干扰
+     * 草图和输入形状是共享的，只复制参数和状态
+     * @return 特征副本，不支持复制时返回nullptr（只能在GUI线程计算）
+     */
+    virtual std::shared_ptr<Feature> Clone() const;
+    
+    /** 
+     * 脱离共享输入 - 在GUI线程上对副本调用，之后才能交给工作线程
+     * 输入草图的轮廓在这里建好并记下，工作线程不再读草图元素；
+     * 有输入形状的特征重写它，再把形状换成拓扑副本
+     */
+    virtual void DetachInputs();
+    
+    /** 
+     * 设置取消标志 - 耗时的特征在计算中检查它，过期了就提前收工
+     * @param token 取消标志
+     */
+    void SetCancellationToken(const cad_core::CancellationTokenPtr& token);
+    
+    /** 
+     * 检查是否已被取消
+     * @return true表示结果已经没人要了
+     */
+    bool IsCancelled() const;
 
 protected:
+    /** 
+     * 参数之外的输入哈希 - 比如直接设置的刀具形状、布尔选项
+     * 默认没有额外输入
+     * @return 额外输入的哈希值
+     */
+    virtual std::size_t ComputeInputHash() const;
+    
+    /** 
+     * 正式构建的收尾 - 修复形状并检查有效性，不合格的结果不交出去
+     * 空形状原样返回
+     * @param shape 刚构建出的形状
+     * @return 修复后的形状，无效时返回nullptr
+     */
+    cad_core::ShapePtr FinalizeShape(const cad_core::ShapePtr& shape) const;
+    
+    /** 
+     * 预览的收尾 - 不修复也不检查，需要时顺手粗网格化
+     * @param shape 预览形状
+     * @return 预览形状本身
+     */
+    cad_core::ShapePtr FinalizePreviewShape(const cad_core::ShapePtr& shape) const;
+    
+    /** 
+     * 取草图轮廓 - 脱离后用记下的快照，否则直接问草图
+     * @param sketch 输入草图
+     * @return 轮廓，草图为空或构建失败时返回nullptr
+     */
+    std::shared_ptr<const cad_sketch::SketchProfile> GetSketchProfile(
+        const std::shared_ptr<cad_sketch::Sketch>& sketch) const;
+    
+    /** 
+     * 草图是否有内容 - 脱离后看快照，不碰草图本身
+     * @param sketch 输入草图
+     * @return true表示草图非空
+     */
+    bool HasSketchContent(const std::shared_ptr<cad_sketch::Sketch>& sketch) const;
+    
     /** 特征类型 - 这个特征属于哪个"门派" */
     FeatureType m_type;
     
@@ -205,8 +436,38 @@ protected:
     /** 激活状态 - 这个特征是"上班"还是"摸鱼" */
     bool m_active;
     
-    /** 参数映射表 - 特征的"控制面板"，存储所有可调参数 */
-    std::map<std::string, double> m_parameters;
+    /** 参数表 - 参数名称和默认值，同类特征共享一份 */
+    const ParameterSchema* m_schema;
+    
+    /** 参数值 - 按参数表索引连续存放的"控制面板" */
+    std::vector<double> m_values;
+    
+    /** 脏标记 - 新建的特征当然需要计算一次 */
+    bool m_dirty;
+    
+    /** 版本号 - 参数和输入的修改计数 */
+    unsigned long m_version;
+    
+    /** 执行结果 - 上一次重建留下的"成果" */
+    cad_core::ShapePtr m_resultShape;
+    
+    /** 结果缓存键 - 这份"成果"是用哪套输入算出来的 */
+    std::size_t m_resultKey;
+    
+    /** 取消标志 - 后台计算的"叫停按钮" */
+    cad_core::CancellationTokenPtr m_cancellationToken;
+    
+    /** 预览精度 - 快速路径的"粗糙程度" */
+    PreviewOptions m_previewOptions;
+    
+    /** 内核耗时 - CreateShape 是 const 的，计时结果只能记在 mutable 里 */
+    mutable KernelTimings m_kernelTimings;
+    
+    /** 轮廓快照 - DetachInputs 记下的各输入草图轮廓，工作线程只读它 */
+    std::map<const cad_sketch::Sketch*, std::shared_ptr<const cad_sketch::SketchProfile>> m_profileSnapshots;
+    
+    /** 是否已脱离共享输入 */
+    bool m_inputsDetached;
     
     /** 静态ID计数器 - 用来分配唯一ID的"号码机" */
     static int s_nextId;
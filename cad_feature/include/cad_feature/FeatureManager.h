@@ -1,16 +1,42 @@
 #pragma once
 
 #include "Feature.h"
+#include "FeatureResultCache.h"
+#include "FeatureProfiler.h"
 #include <vector>
 #include <memory>
 #include <string>
+#include <map>
+#include <functional>
+#include <atomic>
+#include <set>
+
+class QThreadPool;
 
 namespace cad_feature {
 
+// 最近一次重建中结果的来源
+struct FeatureCacheStatistics {
+    int memoryHits = 0;     // 缓存键未变，沿用已有结果
+    int diskHits = 0;       // 从磁盘缓存读回
+    int computed = 0;       // 重新计算
+};
+
+// 检查点中一个特征的状态
+struct FeatureSnapshot {
+    FeaturePtr feature;
+    unsigned long version = 0;
+    cad_core::ShapePtr shape;
+    std::size_t key = 0;
+    FeatureState state = FeatureState::Created;
+    bool active = true;                      // 激活状态和输入不改变版本号，单独记录
+    std::vector<FeaturePtr> dependencies;
+};
+
 class FeatureManager {
 public:
     FeatureManager();
-    ~FeatureManager() = default;
+    ~FeatureManager();
 
     // 特征管理
     void AddFeature(const FeaturePtr& feature);
@@ -28,14 +54,75 @@ public:
     void SetFeatureActive(const FeaturePtr& feature, bool active);
     void SetAllFeaturesActive(bool active);
     
-    // 特征排序
+    // 特征排序：不能移到自己的输入之前或下游之后，移动后从最近的检查点重建
     void MoveFeatureUp(const FeaturePtr& feature);
     void MoveFeatureDown(const FeaturePtr& feature);
     void MoveFeatureToIndex(const FeaturePtr& feature, int index);
+    bool CanMoveFeatureToIndex(const FeaturePtr& feature, int index) const;
+    
+    // 插入特征并从最近的检查点重建
+    bool InsertFeature(const FeaturePtr& feature, int index);
+    
+    // 回滚标记：index 及之后的特征暂不参与重建，新添加的特征插入到标记处
+    void SetRollbackIndex(int index);
+    int GetRollbackIndex() const;
+    void RollToEnd();
+    bool IsRolledBack(const FeaturePtr& feature) const;
+    
+    // 检查点：重建后保存前 index 个特征的结果。
+    // interval 为每隔多少个特征自动设一个检查点，0 表示只用手动添加的检查点
+    void SetCheckpointInterval(int interval);
+    int GetCheckpointInterval() const;
+    void AddCheckpoint(int index);
+    void RemoveCheckpoint(int index);
+    std::vector<int> GetCheckpoints() const;
+    // 从 index 处的改动开始重建：不晚于 index 的最近有效检查点之前的特征直接恢复，不再计算
+    bool RebuildFromIndex(int index);
+    // 最近一次 RebuildFromIndex 使用的检查点，0 表示从头重建
+    int GetLastRestoredCheckpoint() const;
+    
+    // 依赖关系：feature 使用 input 的结果。会形成环时返回 false
+    bool AddDependency(const FeaturePtr& feature, const FeaturePtr& input);
+    void RemoveDependency(const FeaturePtr& feature, const FeaturePtr& input);
+    std::vector<FeaturePtr> GetDependencies(const FeaturePtr& feature) const;
+    std::vector<FeaturePtr> GetDependents(const FeaturePtr& feature) const;
+    // input 是否为 feature 的直接或间接上游
+    bool DependsOn(const FeaturePtr& feature, const FeaturePtr& input) const;
+    
+    // 拓扑顺序，无依赖关系的特征保持列表顺序
+    std::vector<FeaturePtr> GetTopologicalOrder() const;
+    
+    // 脏标记：标记特征及其全部下游
+    void MarkFeatureDirty(const FeaturePtr& feature);
+    // 下次重建需要计算的特征（拓扑顺序），包括输入草图已修改的特征
+    std::vector<FeaturePtr> GetDirtyFeatures() const;
     
     // 更新和重建
     void UpdateFeature(const FeaturePtr& feature);
     void RebuildAllFeatures();
+    // 只重建脏特征及其下游
+    bool RebuildDirtyFeatures();
+    int GetLastRebuildCount() const;
+    
+    // 并行重建：输入都已就绪的特征在线程池上同时计算，结果与串行重建一致
+    void SetParallelRebuild(bool parallel);
+    bool IsParallelRebuild() const;
+    void SetMaxThreadCount(int count);
+    
+    // 结果缓存：参数和输入的缓存键没变时直接返回已有结果。
+    // 设置了缓存目录后，内存中没有的结果会先到磁盘上找
+    void SetCacheDirectory(const std::string& directory);
+    const std::string& GetCacheDirectory() const;
+    // 把当前所有结果写到磁盘（如保存文档时），返回写入的数量
+    int SpillResultsToDisk() const;
+    void ClearDiskCache() const;
+    FeatureCacheStatistics GetLastCacheStatistics() const;
+    
+    // 重建分析：记录每次特征执行的耗时、内核各阶段耗时、面/边数和缓存命中，默认关闭
+    void SetProfilingEnabled(bool enabled);
+    bool IsProfilingEnabled() const;
+    FeatureProfiler& GetProfiler();
+    const FeatureProfiler& GetProfiler() const;
     
     // 实用方法
     int GetFeatureCount() const;
@@ -45,19 +132,66 @@ public:
     void SetFeatureAddedCallback(std::function<void(const FeaturePtr&)> callback);
     void SetFeatureRemovedCallback(std::function<void(const FeaturePtr&)> callback);
     void SetFeatureUpdatedCallback(std::function<void(const FeaturePtr&)> callback);
+    // 每次重建（含单独执行一个特征）结束后调用，分析面板借此刷新
+    void SetRebuildFinishedCallback(std::function<void()> callback);
 
 private:
     std::vector<FeaturePtr> m_features;
     
+    // 依赖图（按特征ID）
+    std::map<int, std::vector<int>> m_inputs;       // 特征 -> 输入特征
+    std::map<int, std::vector<int>> m_dependents;   // 特征 -> 下游特征
+    // 上次执行时各输入草图的版本
+    std::map<int, std::vector<unsigned long>> m_sketchVersions;
+    int m_lastRebuildCount;
+    
+    bool m_parallelRebuild;
+    std::unique_ptr<QThreadPool> m_threadPool;
+    
+    FeatureResultCache m_diskCache;
+    std::atomic<int> m_memoryHits;
+    std::atomic<int> m_diskHits;
+    std::atomic<int> m_computed;
+    
+    FeatureProfiler m_profiler;
+    
+    int m_rollbackIndex;                 // -1 表示在末尾
+    int m_checkpointInterval;
+    std::set<int> m_checkpointIndices;   // 手动添加的检查点
+    std::map<int, std::vector<FeatureSnapshot>> m_checkpoints;
+    int m_lastRestoredCheckpoint;
+    
     // 回调函数
     std::function<void(const FeaturePtr&)> m_featureAddedCallback;
     std::function<void(const FeaturePtr&)> m_featureRemovedCallback;
     std::function<void(const FeaturePtr&)> m_featureUpdatedCallback;
+    std::function<void()> m_rebuildFinishedCallback;
     
     int FindFeatureIndex(const FeaturePtr& feature) const;
+    bool IsSketchStale(const FeaturePtr& feature) const;
+    void RecordSketchVersions(const FeaturePtr& feature);
+    void RemoveFeatureEdges(int featureId);
+    // 在重建过程中执行一个特征：取输入、计算、更新版本记录
+    bool RunFeature(const FeaturePtr& feature);
+    // 按拓扑顺序确定需要重建的特征，不执行
+    std::vector<FeaturePtr> CollectRebuildSet() const;
+    // 有多个下游的输入会复制一份，串行和并行重建用同一套规则；只读依赖图，可在工作线程调用
+    void CollectInputs(const FeaturePtr& feature, std::vector<cad_core::ShapePtr>& inputShapes,
+                       std::vector<std::size_t>& inputKeys) const;
+    // 只计算特征本身（或取缓存），不修改依赖图和版本记录，可在工作线程调用
+    bool ComputeFeature(const FeaturePtr& feature, const std::vector<cad_core::ShapePtr>& inputShapes,
+                        const std::vector<std::size_t>& inputKeys);
+    // 计算完成后在调用线程上更新版本记录并通知界面
+    void FinishFeature(const FeaturePtr& feature, bool succeeded);
+    bool RebuildInParallel(const std::vector<FeaturePtr>& features);
+    int GetEffectiveRollbackIndex() const;
+    std::vector<int> GetCheckpointIndices() const;
+    bool IsCheckpointValid(int index) const;
+    void UpdateCheckpoints();
     void NotifyFeatureAdded(const FeaturePtr& feature);
     void NotifyFeatureRemoved(const FeaturePtr& feature);
     void NotifyFeatureUpdated(const FeaturePtr& feature);
+    void NotifyRebuildFinished();
 };
 
 } // namespace cad_feature
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Feature.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cad_feature {
+
+// 特征结果的来源
+enum class FeatureCacheResult {
+    Computed,     // 缓存未命中，重新计算
+    MemoryHit,    // 缓存键未变，沿用已有结果
+    DiskHit       // 从磁盘缓存读回
+};
+
+// 一次特征执行的记录，时间单位为毫秒
+struct FeatureProfileRecord {
+    int featureId = 0;
+    std::string featureName;
+    FeatureType featureType = FeatureType::Extrude;
+    int rebuild = 0;                // 第几次重建
+    double wallTimeMs = 0.0;        // 含取缓存，不含统计面/边数
+    double buildTimeMs = 0.0;       // 以下三项只在重新计算时有值
+    double validateTimeMs = 0.0;
+    double healTimeMs = 0.0;
+    int faceCount = 0;
+    int edgeCount = 0;
+    FeatureCacheResult cacheResult = FeatureCacheResult::Computed;
+    bool succeeded = false;
+};
+
+// 一个特征在所有重建中的累计
+struct FeatureProfileSummary {
+    int featureId = 0;
+    std::string featureName;
+    int executions = 0;
+    int cacheHits = 0;
+    double totalWallTimeMs = 0.0;
+    double maxWallTimeMs = 0.0;
+};
+
+// 重建分析器
+// 记录每次特征执行的耗时、内核各阶段耗时、结果规模和缓存命中情况。
+// 并行重建时由工作线程写入，内部加锁
+class FeatureProfiler {
+public:
+    FeatureProfiler();
+    ~FeatureProfiler() = default;
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const;
+
+    // 开始/结束一次重建，wallTimeMs 为整次重建的耗时
+    void BeginRebuild();
+    void EndRebuild(double wallTimeMs);
+    void AddRecord(FeatureProfileRecord record);
+
+    std::vector<FeatureProfileRecord> GetLastRebuildRecords() const;
+    std::vector<FeatureProfileSummary> GetSummaries() const;
+    double GetLastRebuildWallTime() const;
+    int GetRebuildCount() const;
+    void Clear();
+
+    static const char* GetCacheResultName(FeatureCacheResult result);
+    static const char* GetFeatureTypeName(FeatureType type);
+
+    // 输出报告（JSON）：最近一次重建的明细和各特征的累计
+    std::string ToJson() const;
+    bool ExportJson(const std::string& path) const;
+
+private:
+    mutable std::mutex m_mutex;
+    bool m_enabled;
+    int m_rebuildCount;
+    double m_lastRebuildWallTimeMs;
+    std::vector<FeatureProfileRecord> m_lastRecords;
+    std::map<int, FeatureProfileSummary> m_summaries;
+};
+
+} // namespace cad_feature
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "cad_core/Shape.h"
+#include <cstddef>
+#include <string>
+
+namespace cad_feature {
+
+// 特征结果的磁盘缓存
+// 以缓存键为文件名、BinTools 二进制格式保存形状，文件头记录完整的键，读回时核对，
+// 重新打开文档时参数和输入没变的特征可以直接读回结果，不必冷启动全量重建
+class FeatureResultCache {
+public:
+    FeatureResultCache() = default;
+    explicit FeatureResultCache(const std::string& directory);
+
+    // 目录为空时缓存关闭
+    void SetDirectory(const std::string& directory);
+    const std::string& GetDirectory() const;
+    bool IsEnabled() const;
+
+    // 不同键对应不同文件，可在工作线程上并发调用
+    bool Contains(std::size_t key) const;
+    cad_core::ShapePtr Load(std::size_t key) const;
+    bool Store(std::size_t key, const cad_core::ShapePtr& shape) const;
+    
+    // 删除目录下的所有缓存文件
+    void Clear() const;
+
+private:
+    std::string m_directory;
+    
+    std::string GetFilePath(std::size_t key) const;
+};
+
+} // namespace cad_feature
@@ -1,18 +1,28 @@
 #pragma once
 
 #include "Feature.h"
+#include "cad_core/CancellationToken.h"
 #include <QObject>
 #include <QTimer>
+#include <QThreadPool>
 #include <functional>
+#include <memory>
 
 namespace cad_feature {
 
+struct LivePreviewTask;
+
+// 特征实时预览
+// 参数变化后先防抖，再在工作线程上对特征的副本调用 CreatePreviewShape；
+// 副本在GUI线程上先脱离共享输入（见 Feature::DetachInputs）。
+// 每次参数变化都让代数加一并取消进行中的计算，过期结果直接丢弃；
+// 防抖时间随最近几次预览的耗时自适应。
 class LivePreview : public QObject {
     Q_OBJECT
 
 public:
     explicit LivePreview(QObject* parent = nullptr);
-    ~LivePreview() = default;
+    ~LivePreview();
 
     void SetFeature(const FeaturePtr& feature);
     const FeaturePtr& GetFeature() const;
@@ -24,15 +34,31 @@ public:
     bool IsPreviewActive() const;
     void SetPreviewActive(bool active);
     
+    // 固定防抖时间（关闭自适应）
     void SetUpdateDelay(int milliseconds);
+    // 当前使用的防抖时间
     int GetUpdateDelay() const;
     
+    // 自适应防抖：防抖时间取最近预览耗时的滑动平均，限制在 [min, max] 内
+    void SetAdaptiveDelayRange(int minMilliseconds, int maxMilliseconds);
+    bool IsAdaptiveDelay() const;
+    // 最近一次预览的耗时（毫秒），-1 表示还没有完成过
+    qint64 GetLastPreviewDuration() const;
+    
+    // 是否有计算正在进行
+    bool IsComputing() const;
+    
     // Callbacks
     void SetPreviewUpdateCallback(std::function<void(const cad_core::ShapePtr&)> callback);
     void SetPreviewClearCallback(std::function<void()> callback);
 
+signals:
+    // 工作线程内部使用，排队到GUI线程
+    void previewFinished(quint64 generation);
+
 private slots:
     void OnUpdateTimer();
+    void OnPreviewFinished(quint64 generation);
 
 private:
     FeaturePtr m_feature;
@@ -40,11 +66,23 @@ private:
     bool m_previewActive;
     int m_updateDelay;
     
+    bool m_adaptiveDelay;
+    int m_minUpdateDelay;
+    int m_maxUpdateDelay;
+    double m_averageDuration;
+    qint64 m_lastDuration;
+    
+    QThreadPool* m_threadPool;
+    std::shared_ptr<LivePreviewTask> m_task;
+    quint64 m_generation;
+    
     std::function<void(const cad_core::ShapePtr&)> m_previewUpdateCallback;
     std::function<void()> m_previewClearCallback;
     
     void UpdatePreviewShape();
     void ClearPreviewShape();
+    void CancelPendingPreview();
+    void RecordDuration(qint64 milliseconds);
 };
 
-} // namespace cad_feature
\ No newline at end of file
+} // namespace cad_feature
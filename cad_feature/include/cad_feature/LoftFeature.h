@@ -2,6 +2,8 @@
 
 #include "Feature.h"
 #include "cad_sketch/Sketch.h"
+#include <TopoDS_Wire.hxx>
+#include <gp_Pln.hxx>
 #include <vector>
 
 namespace cad_feature {
@@ -12,7 +14,18 @@ public:
     LoftFeature(const std::string& name);
     virtual ~LoftFeature() = default;
 
+    // 参数索引，名称和默认值见 Schema()
+    enum Parameter : int {
+        Solid,
+        Ruled,
+        Closed,
+        ParameterCount
+    };
+    static const ParameterSchema& Schema();
+
     // Section operations
+    // 相邻截面必须位于不同平面；草图目前没有放置平面，轮廓都在 XY 平面上，
+    // 所以现在的草图截面都会被 ValidateParameters 拒绝
     void AddSection(const cad_sketch::SketchPtr& section);
     void RemoveSection(const cad_sketch::SketchPtr& section);
     void ClearSections();
@@ -21,6 +34,7 @@ public:
     int GetSectionCount() const;
     
     // Guide curve operations
+    // 引导线暂不支持：设置了引导线时 ValidateParameters 失败
     void AddGuideCurve(const cad_sketch::SketchPtr& guide);
     void RemoveGuideCurve(const cad_sketch::SketchPtr& guide);
     void ClearGuideCurves();
@@ -40,16 +54,29 @@ public:
     
     // Feature interface
     cad_core::ShapePtr CreateShape() const override;
+    cad_core::ShapePtr CreatePreviewShape() const override;
     bool ValidateParameters() const override;
     std::shared_ptr<cad_core::ICommand> CreateCommand() const override;
+    FeaturePtr Clone() const override;
+    std::vector<cad_sketch::SketchPtr> GetInputSketches() const override;
 
 private:
     std::vector<cad_sketch::SketchPtr> m_sections;
     std::vector<cad_sketch::SketchPtr> m_guideCurves;
     
+    // 一个截面：外环、按面积从大到小排列的孔和所在平面
+    struct Section {
+        TopoDS_Wire outer;
+        std::vector<TopoDS_Wire> holes;
+        gp_Pln plane;
+    };
+    
     bool AreSectionsValid() const;
     bool AreGuideCurvesValid() const;
-    cad_core::ShapePtr LoftSections() const;
+    // 每个截面必须恰好是一个平面上的面，各截面孔数相同，相邻截面不共面，否则返回 false
+    bool CollectSections(std::vector<Section>& sections) const;
+    // preview 为 true 时按 PreviewOptions 降低精度
+    cad_core::ShapePtr LoftSections(bool preview) const;
 };
 
 using LoftFeaturePtr = std::shared_ptr<LoftFeature>;
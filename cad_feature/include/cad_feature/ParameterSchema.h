@@ -0,0 +1,40 @@
+#pragma once
+
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cad_feature {
+
+// 参数声明：index 为特征类中参数枚举的值
+struct ParameterInfo {
+    int index;
+    const char* name;
+    double defaultValue;
+};
+
+// 每种特征类型的参数表（静态，所有实例共享）
+// 数值按索引存放在特征的连续数组中，名称只在界面和序列化时使用
+class ParameterSchema {
+public:
+    explicit ParameterSchema(std::initializer_list<ParameterInfo> parameters);
+
+    int GetCount() const { return static_cast<int>(m_names.size()); }
+    const std::string& GetName(int index) const { return m_names[index]; }
+    double GetDefault(int index) const { return m_defaults[index]; }
+    const std::vector<double>& GetDefaults() const { return m_defaults; }
+    
+    // 没有该参数时返回 -1
+    int FindIndex(const std::string& name) const;
+
+    // 没有声明参数的特征使用
+    static const ParameterSchema& Empty();
+
+private:
+    std::vector<std::string> m_names;
+    std::vector<double> m_defaults;
+    std::unordered_map<std::string, int> m_indexByName;
+};
+
+} // namespace cad_feature
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Feature.h"
+#include "cad_core/BooleanOperations.h"
+#include <gp_Pnt.hxx>
+#include <gp_Dir.hxx>
+#include <gp_Trsf.hxx>
+#include <vector>
+
+namespace cad_feature {
+
+enum class PatternType {
+    Linear,     // 线性阵列：沿一个或两个方向等距排列
+    Circular    // 环形阵列：绕轴等角度排列
+};
+
+// 阵列特征：把刀具体（或孔）复制成 N 个带位置的实例，一次多工具布尔运算从目标上切除。
+// 所有实例通过 TopLoc_Location 共享同一个 TShape，不复制几何。
+class PatternFeature : public Feature {
+public:
+    PatternFeature();
+    PatternFeature(const std::string& name);
+    virtual ~PatternFeature() = default;
+
+    // 参数索引，名称和默认值见 Schema()
+    enum Parameter : int {
+        Type,
+        Direction1X,
+        Direction1Y,
+        Direction1Z,
+        Spacing1,
+        Count1,
+        Direction2X,
+        Direction2Y,
+        Direction2Z,
+        Spacing2,
+        Count2,
+        AxisOriginX,
+        AxisOriginY,
+        AxisOriginZ,
+        AxisDirectionX,
+        AxisDirectionY,
+        AxisDirectionZ,
+        CircularCount,
+        TotalAngle,
+        ParameterCount
+    };
+    static const ParameterSchema& Schema();
+
+    // Inputs
+    void SetTargetShape(const cad_core::ShapePtr& target);
+    const cad_core::ShapePtr& GetTargetShape() const;
+    
+    // 刀具体位于第一个实例的位置
+    void SetToolShape(const cad_core::ShapePtr& tool);
+    const cad_core::ShapePtr& GetToolShape() const;
+    
+    // 孔刀具：从 position 沿 direction 钻入 depth 深的圆柱
+    static cad_core::ShapePtr MakeHoleTool(const gp_Pnt& position, const gp_Dir& direction,
+                                           double diameter, double depth);
+    
+    // Pattern parameters
+    void SetPatternType(PatternType type);
+    PatternType GetPatternType() const;
+    
+    // 线性阵列，count 包含第一个实例；第二方向 count 为1时为单排
+    void SetLinearDirection1(double x, double y, double z, double spacing, int count);
+    void SetLinearDirection2(double x, double y, double z, double spacing, int count);
+    
+    // 环形阵列，totalAngle 为度；360度时首尾不重合
+    void SetCircularAxis(double originX, double originY, double originZ,
+                         double directionX, double directionY, double directionZ);
+    void SetCircularParameters(int count, double totalAngle);
+    
+    int GetInstanceCount() const;
+    
+    // 布尔运算选项（与主窗口的设置一致）
+    void SetBooleanOptions(const cad_core::BooleanOptions& options);
+    
+    // 各实例相对刀具体的变换，第一个为恒等变换
+    std::vector<gp_Trsf> ComputeInstanceTransforms() const;
+    // 共享刀具 TShape 的实例
+    std::vector<cad_core::ShapePtr> CreateInstances() const;
+    
+    // Feature interface
+    cad_core::ShapePtr CreateShape() const override;
+    cad_core::ShapePtr CreatePreviewShape() const override;
+    bool ValidateParameters() const override;
+    std::shared_ptr<cad_core::ICommand> CreateCommand() const override;
+    FeaturePtr Clone() const override;
+    // 第一个输入特征的结果作为目标实体
+    void SetInputShapes(const std::vector<cad_core::ShapePtr>& shapes) override;
+    // 目标和刀具换成拓扑副本，工作线程不再访问GUI持有的形状
+    void DetachInputs() override;
+
+protected:
+    // 刀具（按内容）、直接设置的目标和影响结果的布尔选项；来自输入特征的目标已包含在输入键中
+    std::size_t ComputeInputHash() const override;
+
+private:
+    cad_core::ShapePtr m_targetShape;
+    cad_core::ShapePtr m_toolShape;
+    cad_core::BooleanOptions m_booleanOptions;
+    std::size_t m_toolContentHash;
+    std::size_t m_targetContentHash;   // 目标来自输入特征时为0
+    
+    cad_core::ShapePtr CreateInstanceCompound() const;
+    // 形状的 BinTools 序列化内容的哈希，与内存地址无关，可跨会话用作缓存键
+    static std::size_t ComputeContentHash(const cad_core::ShapePtr& shape);
+};
+
+using PatternFeaturePtr = std::shared_ptr<PatternFeature>;
+
+} // namespace cad_feature
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "FeatureProfiler.h"
+#include <QWidget>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+
+namespace cad_feature {
+
+// 重建耗时面板：最近一次重建中每个特征一行，点表头按该列排序
+class ProfilerPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit ProfilerPanel(QWidget* parent = nullptr);
+    ~ProfilerPanel() = default;
+
+    void SetProfiler(const FeatureProfiler* profiler);
+    const FeatureProfiler* GetProfiler() const;
+    
+    void UpdateRecords();
+    void ClearRecords();
+
+private slots:
+    void OnExportJson();
+
+private:
+    enum Column {
+        NameColumn,
+        TypeColumn,
+        WallTimeColumn,
+        BuildTimeColumn,
+        ValidateTimeColumn,
+        HealTimeColumn,
+        FaceColumn,
+        EdgeColumn,
+        CacheColumn,
+        ColumnCount
+    };
+
+    const FeatureProfiler* m_profiler;
+    
+    QVBoxLayout* m_mainLayout;
+    QLabel* m_summaryLabel;
+    QTableWidget* m_table;
+    QPushButton* m_refreshButton;
+    QPushButton* m_exportButton;
+    
+    void AddRow(int row, const FeatureProfileRecord& record);
+    void SetTextItem(int row, int column, const QString& text);
+    // 数值按数值排序，不按字符串
+    void SetNumberItem(int row, int column, double value);
+};
+
+} // namespace cad_feature
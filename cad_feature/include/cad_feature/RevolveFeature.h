@@ -11,6 +11,20 @@ public:
     RevolveFeature(const std::string& name);
     virtual ~RevolveFeature() = default;
 
+    // 参数索引，名称和默认值见 Schema()
+    enum Parameter : int {
+        Angle,
+        AxisX,
+        AxisY,
+        AxisZ,
+        AxisOriginX,
+        AxisOriginY,
+        AxisOriginZ,
+        Midplane,
+        ParameterCount
+    };
+    static const ParameterSchema& Schema();
+
     // Sketch operations
     void SetSketch(const cad_sketch::SketchPtr& sketch);
     const cad_sketch::SketchPtr& GetSketch() const;
@@ -30,13 +44,17 @@ public:
     
     // Feature interface
     cad_core::ShapePtr CreateShape() const override;
+    cad_core::ShapePtr CreatePreviewShape() const override;
     bool ValidateParameters() const override;
     std::shared_ptr<cad_core::ICommand> CreateCommand() const override;
+    FeaturePtr Clone() const override;
+    std::vector<cad_sketch::SketchPtr> GetInputSketches() const override;
 
 private:
     cad_sketch::SketchPtr m_sketch;
     
     bool IsSketchValid() const;
+    // 旋转没有近似步骤，预览和正式构建共用
     cad_core::ShapePtr RevolveSketch() const;
 };
 
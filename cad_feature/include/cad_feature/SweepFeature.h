@@ -12,6 +12,15 @@ public:
     SweepFeature(const std::string& name);
     virtual ~SweepFeature() = default;
 
+    // 参数索引，名称和默认值见 Schema()
+    enum Parameter : int {
+        TwistAngle,
+        ScaleFactor,
+        KeepOrientation,
+        ParameterCount
+    };
+    static const ParameterSchema& Schema();
+
     // Profile and path operations
     void SetProfile(const cad_sketch::SketchPtr& profile);
     const cad_sketch::SketchPtr& GetProfile() const;
@@ -20,6 +29,7 @@ public:
     const cad_sketch::SketchPtr& GetPath() const;
     
     // Sweep parameters
+    // 扭转角暂不支持：非0时 ValidateParameters 失败
     void SetTwistAngle(double angle);
     double GetTwistAngle() const;
     
@@ -31,8 +41,11 @@ public:
     
     // Feature interface
     cad_core::ShapePtr CreateShape() const override;
+    cad_core::ShapePtr CreatePreviewShape() const override;
     bool ValidateParameters() const override;
     std::shared_ptr<cad_core::ICommand> CreateCommand() const override;
+    FeaturePtr Clone() const override;
+    std::vector<cad_sketch::SketchPtr> GetInputSketches() const override;
 
 private:
     cad_sketch::SketchPtr m_profile;
@@ -40,7 +53,8 @@ private:
     
     bool IsProfileValid() const;
     bool IsPathValid() const;
-    cad_core::ShapePtr SweepProfile() const;
+    // preview 为 true 时按 PreviewOptions 降低精度
+    cad_core::ShapePtr SweepProfile(bool preview) const;
 };
 
 using SweepFeaturePtr = std::shared_ptr<SweepFeature>;
@@ -1,70 +1,82 @@
 ﻿#include "cad_feature/ExtrudeFeature.h"
 #include "cad_core/CreateBoxCommand.h"
 #include <BRepPrimAPI_MakePrism.hxx>
+#include <Standard_Failure.hxx>
+#include <TopLoc_Location.hxx>
+#include <gp_Trsf.hxx>
 #include <gp_Vec.hxx>
+#include <cmath>
 
 namespace cad_feature {
 
-ExtrudeFeature::ExtrudeFeature() : Feature(FeatureType::Extrude, "Extrude") {
-    SetParameter("distance", 10.0);
-    SetParameter("direction_x", 0.0);
-    SetParameter("direction_y", 0.0);
-    SetParameter("direction_z", 1.0);
-    SetParameter("taper_angle", 0.0);
-    SetParameter("midplane", 0.0);
+const ParameterSchema& ExtrudeFeature::Schema() {
+    static const ParameterSchema schema({
+        {Distance, "distance", 10.0},
+        {DirectionX, "direction_x", 0.0},
+        {DirectionY, "direction_y", 0.0},
+        {DirectionZ, "direction_z", 1.0},
+        {TaperAngle, "taper_angle", 0.0},
+        {Midplane, "midplane", 0.0}
+    });
+    return schema;
 }
 
-ExtrudeFeature::ExtrudeFeature(const std::string& name) : Feature(FeatureType::Extrude, name) {
-    SetParameter("distance", 10.0);
-    SetParameter("direction_x", 0.0);
-    SetParameter("direction_y", 0.0);
-    SetParameter("direction_z", 1.0);
-    SetParameter("taper_angle", 0.0);
-    SetParameter("midplane", 0.0);
+ExtrudeFeature::ExtrudeFeature() : Feature(FeatureType::Extrude, "Extrude", Schema()) {
+}
+
+ExtrudeFeature::ExtrudeFeature(const std::string& name) : Feature(FeatureType::Extrude, name, Schema()) {
 }
 
 void ExtrudeFeature::SetSketch(const cad_sketch::SketchPtr& sketch) {
     m_sketch = sketch;
+    MarkModified();
 }
 
 const cad_sketch::SketchPtr& ExtrudeFeature::GetSketch() const {
     return m_sketch;
 }
 
+std::vector<cad_sketch::SketchPtr> ExtrudeFeature::GetInputSketches() const {
+    if (m_sketch) {
+        return {m_sketch};
+    }
+    return {};
+}
+
 void ExtrudeFeature::SetDistance(double distance) {
-    SetParameter("distance", distance);
+    SetParameter(Distance, distance);
 }
 
 double ExtrudeFeature::GetDistance() const {
-    return GetParameter("distance");
+    return GetParameter(Distance);
 }
 
 void ExtrudeFeature::SetDirection(double x, double y, double z) {
-    SetParameter("direction_x", x);
-    SetParameter("direction_y", y);
-    SetParameter("direction_z", z);
+    SetParameter(DirectionX, x);
+    SetParameter(DirectionY, y);
+    SetParameter(DirectionZ, z);
 }
 
 void ExtrudeFeature::GetDirection(double& x, double& y, double& z) const {
-    x = GetParameter("direction_x");
-    y = GetParameter("direction_y");
-    z = GetParameter("direction_z");
+    x = GetParameter(DirectionX);
+    y = GetParameter(DirectionY);
+    z = GetParameter(DirectionZ);
 }
 
 void ExtrudeFeature::SetTaperAngle(double angle) {
-    SetParameter("taper_angle", angle);
+    SetParameter(TaperAngle, angle);
 }
 
 double ExtrudeFeature::GetTaperAngle() const {
-    return GetParameter("taper_angle");
+    return GetParameter(TaperAngle);
 }
 
 void ExtrudeFeature::SetMidplane(bool midplane) {
-    SetParameter("midplane", midplane ? 1.0 : 0.0);
+    SetParameter(Midplane, midplane ? 1.0 : 0.0);
 }
 
 bool ExtrudeFeature::GetMidplane() const {
-    return GetParameter("midplane") != 0.0;
+    return GetParameter(Midplane) != 0.0;
 }
 
 cad_core::ShapePtr ExtrudeFeature::CreateShape() const {
@@ -72,7 +84,15 @@ cad_core::ShapePtr ExtrudeFeature::CreateShape() const {
         return nullptr;
     }
     
-    return ExtrudeSketch();
+    return FinalizeShape(ExtrudeSketch(false));
+}
+
+cad_core::ShapePtr ExtrudeFeature::CreatePreviewShape() const {
+    if (!IsSketchValid() || GetTaperAngle() != 0.0) {
+        return nullptr;
+    }
+    
+    return FinalizePreviewShape(ExtrudeSketch(true));
 }
 
 bool ExtrudeFeature::ValidateParameters() const {
@@ -92,6 +112,11 @@ bool ExtrudeFeature::ValidateParameters() const {
         return false;
     }
     
+    // 拔模角还没有实现，不能悄悄忽略
+    if (GetTaperAngle() != 0.0) {
+        return false;
+    }
+    
     return true;
 }
 
@@ -100,30 +125,50 @@ std::shared_ptr<cad_core::ICommand> ExtrudeFeature::CreateCommand() const {
     return std::make_shared<cad_core::CreateBoxCommand>(GetDistance(), GetDistance(), GetDistance());
 }
 
+FeaturePtr ExtrudeFeature::Clone() const {
+    return std::make_shared<ExtrudeFeature>(*this);
+}
+
 bool ExtrudeFeature::IsSketchValid() const {
-    return m_sketch && !m_sketch->IsEmpty();
+    return HasSketchContent(m_sketch);
 }
 
-cad_core::ShapePtr ExtrudeFeature::ExtrudeSketch() const {
+cad_core::ShapePtr ExtrudeFeature::ExtrudeSketch(bool preview) const {
     if (!IsSketchValid()) {
         return nullptr;
     }
     
+    // 轮廓缓存在草图上，同一草图反复预览/重建不会重新拼拓扑
+    cad_sketch::SketchProfilePtr profile = GetSketchProfile(m_sketch);
+    if (!profile || !profile->HasFaces()) {
+        return nullptr;
+    }
+    
+    double dx, dy, dz;
+    GetDirection(dx, dy, dz);
+    double length = std::sqrt(dx*dx + dy*dy + dz*dz);
+    if (length < 1e-10) {
+        return nullptr;
+    }
+    gp_Vec vector(dx / length, dy / length, dz / length);
+    vector *= GetDistance();
+    
     try {
-        // In a real implementation, this would:
-        // 1. Convert sketch elements to OCCT wire/face
-        // 2. Create extrusion vector from direction and distance
-        // 3. Use BRepPrimAPI_MakePrism to create the solid
-        
-        // For now, return a simple box as placeholder
-        double distance = GetDistance();
-        auto shape = std::make_shared<cad_core::Shape>();
-        
-        // Placeholder: create a simple box
-        // In real implementation, this would properly extrude the sketch
+        TopoDS_Shape base = profile->faceCompound;
+        if (GetMidplane()) {
+            gp_Trsf offset;
+            offset.SetTranslation(-0.5 * vector);
+            base = base.Moved(TopLoc_Location(offset));
+        }
         
-        return shape;
-    } catch (...) {
+        // 轮廓被多个线程共享，让 MakePrism 复制底面而不是直接引用
+        // 预览不做曲面规范化，省一点时间
+        BRepPrimAPI_MakePrism prism(base, vector, Standard_True, preview ? Standard_False : Standard_True);
+        if (!prism.IsDone()) {
+            return nullptr;
+        }
+        return std::make_shared<cad_core::Shape>(prism.Shape());
+    } catch (const Standard_Failure&) {
         return nullptr;
     }
 }
@@ -1,11 +1,37 @@
 ﻿#include "cad_feature/Feature.h"
+#include "cad_sketch/Sketch.h"
+#include <BRepBndLib.hxx>
+#include <BRepCheck_Analyzer.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <Bnd_Box.hxx>
+#include <Precision.hxx>
+#include <ShapeFix_Shape.hxx>
+#include <Standard_Failure.hxx>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include <functional>
 
 namespace cad_feature {
 
+namespace {
+
+void HashCombine(std::size_t& seed, std::size_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+} // namespace
+
 int Feature::s_nextId = 1;
 
 Feature::Feature(FeatureType type, const std::string& name)
-    : m_type(type), m_name(name), m_id(s_nextId++), m_state(FeatureState::Created), m_active(true) {
+    : Feature(type, name, ParameterSchema::Empty()) {
+}
+
+Feature::Feature(FeatureType type, const std::string& name, const ParameterSchema& schema)
+    : m_type(type), m_name(name), m_id(s_nextId++), m_state(FeatureState::Created), m_active(true),
+      m_schema(&schema), m_values(schema.GetDefaults()), m_dirty(true), m_version(0), m_resultKey(0),
+      m_inputsDetached(false) {
 }
 
 FeatureType Feature::GetType() const {
@@ -45,23 +71,208 @@ void Feature::SetActive(bool active) {
 }
 
 void Feature::SetParameter(const std::string& name, double value) {
-    m_parameters[name] = value;
+    int index = m_schema->FindIndex(name);
+    if (index >= 0) {
+        SetParameter(index, value);
+    }
 }
 
 double Feature::GetParameter(const std::string& name) const {
-    auto it = m_parameters.find(name);
-    if (it != m_parameters.end()) {
-        return it->second;
-    }
-    return 0.0;
+    int index = m_schema->FindIndex(name);
+    return index >= 0 ? m_values[index] : 0.0;
 }
 
 bool Feature::HasParameter(const std::string& name) const {
-    return m_parameters.find(name) != m_parameters.end();
+    return m_schema->FindIndex(name) >= 0;
+}
+
+const ParameterSchema& Feature::GetSchema() const {
+    return *m_schema;
+}
+
+const std::vector<double>& Feature::GetParameterValues() const {
+    return m_values;
+}
+
+bool Feature::IsDirty() const {
+    return m_dirty;
+}
+
+void Feature::MarkDirty() {
+    m_dirty = true;
+}
+
+void Feature::MarkModified() {
+    m_dirty = true;
+    ++m_version;
+}
+
+void Feature::ClearDirty() {
+    m_dirty = false;
+}
+
+unsigned long Feature::GetVersion() const {
+    return m_version;
+}
+
+std::vector<std::shared_ptr<cad_sketch::Sketch>> Feature::GetInputSketches() const {
+    return {};
+}
+
+const cad_core::ShapePtr& Feature::GetResultShape() const {
+    return m_resultShape;
+}
+
+void Feature::SetResultShape(const cad_core::ShapePtr& shape, std::size_t key) {
+    m_resultShape = shape;
+    m_resultKey = shape ? key : 0;
+}
+
+std::size_t Feature::GetResultKey() const {
+    return m_resultKey;
+}
+
+std::size_t Feature::ComputeCacheKey(const std::vector<std::size_t>& inputKeys) const {
+    std::size_t seed = 0;
+    HashCombine(seed, static_cast<std::size_t>(m_type));
+    // 参数表由特征类型决定，只需哈希数值
+    for (double value : m_values) {
+        HashCombine(seed, std::hash<double>()(value));
+    }
+    for (const auto& sketch : GetInputSketches()) {
+        HashCombine(seed, sketch ? sketch->ComputeContentHash() : 0);
+    }
+    for (std::size_t key : inputKeys) {
+        HashCombine(seed, key);
+    }
+    HashCombine(seed, ComputeInputHash());
+    // 0 留给"没有键"
+    return seed != 0 ? seed : 1;
+}
+
+std::size_t Feature::ComputeInputHash() const {
+    return 0;
+}
+
+void Feature::SetInputShapes(const std::vector<cad_core::ShapePtr>& shapes) {
+    (void)shapes;
+}
+
+std::shared_ptr<Feature> Feature::Clone() const {
+    return nullptr;
+}
+
+void Feature::DetachInputs() {
+    m_profileSnapshots.clear();
+    for (const auto& sketch : GetInputSketches()) {
+        if (sketch && !sketch->IsEmpty()) {
+            m_profileSnapshots[sketch.get()] = sketch->GetProfile();
+        }
+    }
+    m_inputsDetached = true;
+}
+
+cad_sketch::SketchProfilePtr Feature::GetSketchProfile(const cad_sketch::SketchPtr& sketch) const {
+    if (!sketch) {
+        return nullptr;
+    }
+    if (!m_inputsDetached) {
+        return sketch->GetProfile();
+    }
+    auto it = m_profileSnapshots.find(sketch.get());
+    return it != m_profileSnapshots.end() ? it->second : nullptr;
+}
+
+bool Feature::HasSketchContent(const cad_sketch::SketchPtr& sketch) const {
+    if (!sketch) {
+        return false;
+    }
+    if (!m_inputsDetached) {
+        return !sketch->IsEmpty();
+    }
+    return m_profileSnapshots.find(sketch.get()) != m_profileSnapshots.end();
+}
+
+void Feature::SetCancellationToken(const cad_core::CancellationTokenPtr& token) {
+    m_cancellationToken = token;
+}
+
+bool Feature::IsCancelled() const {
+    return m_cancellationToken && m_cancellationToken->IsCancelled();
 }
 
 cad_core::ShapePtr Feature::CreatePreviewShape() const {
     return CreateShape();
 }
 
+void Feature::SetPreviewOptions(const PreviewOptions& options) {
+    m_previewOptions = options;
+}
+
+const PreviewOptions& Feature::GetPreviewOptions() const {
+    return m_previewOptions;
+}
+
+cad_core::ShapePtr Feature::CreateShapeTimed() const {
+    m_kernelTimings = KernelTimings();
+    
+    QElapsedTimer timer;
+    timer.start();
+    cad_core::ShapePtr shape = CreateShape();
+    double totalMs = timer.nsecsElapsed() / 1.0e6;
+    
+    m_kernelTimings.buildMs = std::max(0.0, totalMs - m_kernelTimings.validateMs - m_kernelTimings.healMs);
+    return shape;
+}
+
+const KernelTimings& Feature::GetLastKernelTimings() const {
+    return m_kernelTimings;
+}
+
+cad_core::ShapePtr Feature::FinalizeShape(const cad_core::ShapePtr& shape) const {
+    if (!shape || shape->GetOCCTShape().IsNull()) {
+        return shape;
+    }
+    
+    try {
+        QElapsedTimer timer;
+        timer.start();
+        ShapeFix_Shape fixer(shape->GetOCCTShape());
+        fixer.Perform();
+        m_kernelTimings.healMs += timer.nsecsElapsed() / 1.0e6;
+        
+        timer.restart();
+        BRepCheck_Analyzer analyzer(fixer.Shape());
+        bool valid = analyzer.IsValid();
+        m_kernelTimings.validateMs += timer.nsecsElapsed() / 1.0e6;
+        if (!valid) {
+            return nullptr;
+        }
+        return std::make_shared<cad_core::Shape>(fixer.Shape());
+    } catch (const Standard_Failure&) {
+        return nullptr;
+    }
+}
+
+cad_core::ShapePtr Feature::FinalizePreviewShape(const cad_core::ShapePtr& shape) const {
+    if (!m_previewOptions.meshOnly || !shape || shape->GetOCCTShape().IsNull()) {
+        return shape;
+    }
+    
+    // 预览形状是新建的，可以在计算线程上直接网格化
+    try {
+        const TopoDS_Shape& occtShape = shape->GetOCCTShape();
+        Bnd_Box box;
+        BRepBndLib::Add(occtShape, box, Standard_False);
+        double deflection = m_previewOptions.meshRelativeDeflection;
+        if (!box.IsVoid()) {
+            deflection = std::max(std::sqrt(box.SquareExtent()) * deflection, Precision::Confusion());
+        }
+        BRepMesh_IncrementalMesh mesher(occtShape, deflection, Standard_False, 0.5, Standard_False);
+    } catch (const Standard_Failure&) {
+        // 网格化失败时交给视图自己处理
+    }
+    return shape;
+}
+
 } // namespace cad_feature
\ No newline at end of file
@@ -1,19 +1,87 @@
 ﻿#include "cad_feature/FeatureManager.h"
+#include "cad_sketch/Sketch.h"
+#include <BRepBuilderAPI_Copy.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <QElapsedTimer>
+#include <QRunnable>
+#include <QThreadPool>
 #include <algorithm>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <set>
 
 namespace cad_feature {
 
-FeatureManager::FeatureManager() {
+namespace {
+
+// 并行重建中的一个特征
+struct RebuildTask {
+    FeaturePtr feature;
+    std::vector<int> dependents;     // 集合内的下游任务
+    int pendingInputs = 0;           // 集合内尚未完成的输入任务
+    bool succeeded = false;
+};
+
+int CountSubShapes(const cad_core::ShapePtr& shape, TopAbs_ShapeEnum type) {
+    if (!shape || shape->GetOCCTShape().IsNull()) {
+        return 0;
+    }
+    TopTools_IndexedMapOfShape map;
+    TopExp::MapShapes(shape->GetOCCTShape(), type, map);
+    return map.Extent();
+}
+
+} // namespace
+
+FeatureManager::FeatureManager()
+    : m_lastRebuildCount(0), m_parallelRebuild(true), m_threadPool(new QThreadPool()),
+      m_memoryHits(0), m_diskHits(0), m_computed(0),
+      m_rollbackIndex(-1), m_checkpointInterval(10), m_lastRestoredCheckpoint(0) {
+}
+
+FeatureManager::~FeatureManager() {
+    m_threadPool->waitForDone();
 }
 
 void FeatureManager::AddFeature(const FeaturePtr& feature) {
-    m_features.push_back(feature);
+    if (m_rollbackIndex >= 0) {
+        // 回滚状态下新特征放在标记处，标记随之后移
+        m_features.insert(m_features.begin() + m_rollbackIndex, feature);
+        ++m_rollbackIndex;
+    } else {
+        m_features.push_back(feature);
+    }
     NotifyFeatureAdded(feature);
 }
 
+bool FeatureManager::InsertFeature(const FeaturePtr& feature, int index) {
+    if (!feature || index < 0 || index > static_cast<int>(m_features.size())) {
+        return false;
+    }
+    
+    m_features.insert(m_features.begin() + index, feature);
+    if (m_rollbackIndex >= 0 && index <= m_rollbackIndex) {
+        ++m_rollbackIndex;
+    }
+    NotifyFeatureAdded(feature);
+    return RebuildFromIndex(index);
+}
+
 void FeatureManager::RemoveFeature(const FeaturePtr& feature) {
     auto it = std::find(m_features.begin(), m_features.end(), feature);
     if (it != m_features.end()) {
+        // 下游失去了一个输入，需要重建
+        for (const auto& dependent : GetDependents(feature)) {
+            MarkFeatureDirty(dependent);
+        }
+        RemoveFeatureEdges(feature->GetId());
+        if (m_rollbackIndex >= 0 && std::distance(m_features.begin(), it) < m_rollbackIndex) {
+            --m_rollbackIndex;
+        }
         m_features.erase(it);
         NotifyFeatureRemoved(feature);
     }
@@ -21,6 +89,15 @@ void FeatureManager::RemoveFeature(const FeaturePtr& feature) {
 
 void FeatureManager::ClearFeatures() {
     m_features.clear();
+    m_inputs.clear();
+    m_dependents.clear();
+    m_sketchVersions.clear();
+    
+    // 检查点和回滚状态都属于被清掉的模型，一并复位
+    m_checkpoints.clear();
+    m_checkpointIndices.clear();
+    m_lastRestoredCheckpoint = 0;
+    m_rollbackIndex = -1;
 }
 
 const std::vector<FeaturePtr>& FeatureManager::GetFeatures() const {
@@ -50,72 +127,747 @@ bool FeatureManager::ExecuteFeature(const FeaturePtr& feature) {
         return false;
     }
     
-    if (!feature->ValidateParameters()) {
-        feature->SetState(FeatureState::Failed);
-        return false;
+    // 在重建之外单独执行也算一次重建，分析器的记录才有所属的那次重建
+    QElapsedTimer timer;
+    timer.start();
+    const bool profiling = m_profiler.IsEnabled();
+    if (profiling) {
+        m_profiler.BeginRebuild();
+    }
+    
+    bool succeeded = RunFeature(feature);
+    
+    if (profiling) {
+        m_profiler.EndRebuild(timer.nsecsElapsed() / 1.0e6);
+    }
+    NotifyRebuildFinished();
+    return succeeded;
+}
+
+bool FeatureManager::RunFeature(const FeaturePtr& feature) {
+    std::vector<cad_core::ShapePtr> inputShapes;
+    std::vector<std::size_t> inputKeys;
+    CollectInputs(feature, inputShapes, inputKeys);
+    
+    bool succeeded = ComputeFeature(feature, inputShapes, inputKeys);
+    FinishFeature(feature, succeeded);
+    return succeeded;
+}
+
+void FeatureManager::CollectInputs(const FeaturePtr& feature, std::vector<cad_core::ShapePtr>& inputShapes,
+                                   std::vector<std::size_t>& inputKeys) const {
+    // 把上游结果和它们的缓存键交给特征。
+    // 输入有多个下游时各自拿一份拓扑副本：并行时避免两个布尔运算同时修改共享子形状的容差，
+    // 串行重建和单独执行也按同样的规则复制，结果与并行重建一致
+    for (const auto& input : GetDependencies(feature)) {
+        if (!input->IsActive()) {
+            continue;
+        }
+        cad_core::ShapePtr shape = input->GetResultShape();
+        if (shape && GetDependents(input).size() > 1) {
+            BRepBuilderAPI_Copy copier(shape->GetOCCTShape(), Standard_False, Standard_False);
+            shape = std::make_shared<cad_core::Shape>(copier.Shape());
+        }
+        inputShapes.push_back(shape);
+        inputKeys.push_back(input->GetResultKey());
     }
+}
+
+bool FeatureManager::ComputeFeature(const FeaturePtr& feature, const std::vector<cad_core::ShapePtr>& inputShapes,
+                                    const std::vector<std::size_t>& inputKeys) {
+    QElapsedTimer timer;
+    timer.start();
+    feature->SetInputShapes(inputShapes);
+    
+    FeatureProfileRecord record;
+    record.succeeded = true;
     
-    auto shape = feature->CreateShape();
-    if (shape) {
+    // 缓存键没变时结果一定没变
+    const std::size_t key = feature->ComputeCacheKey(inputKeys);
+    if (feature->GetResultShape() && feature->GetResultKey() == key) {
         feature->SetState(FeatureState::Executed);
-        NotifyFeatureUpdated(feature);
-        return true;
+        ++m_memoryHits;
+        record.cacheResult = FeatureCacheResult::MemoryHit;
+    } else if (cad_core::ShapePtr cached = m_diskCache.Load(key)) {
+        feature->SetResultShape(cached, key);
+        feature->SetState(FeatureState::Executed);
+        ++m_diskHits;
+        record.cacheResult = FeatureCacheResult::DiskHit;
     } else {
-        feature->SetState(FeatureState::Failed);
-        return false;
+        ++m_computed;
+        cad_core::ShapePtr shape;
+        try {
+            if (feature->ValidateParameters()) {
+                shape = feature->CreateShapeTimed();
+                const KernelTimings& timings = feature->GetLastKernelTimings();
+                record.buildTimeMs = timings.buildMs;
+                record.validateTimeMs = timings.validateMs;
+                record.healTimeMs = timings.healMs;
+            }
+        } catch (const Standard_Failure&) {
+            shape = nullptr;
+        } catch (const std::exception&) {
+            shape = nullptr;
+        }
+        
+        feature->SetResultShape(shape, key);
+        feature->SetState(shape ? FeatureState::Executed : FeatureState::Failed);
+        record.succeeded = shape != nullptr;
+    }
+    
+    if (m_profiler.IsEnabled()) {
+        record.wallTimeMs = timer.nsecsElapsed() / 1.0e6;
+        record.featureId = feature->GetId();
+        record.featureName = feature->GetName();
+        record.featureType = feature->GetType();
+        record.faceCount = CountSubShapes(feature->GetResultShape(), TopAbs_FACE);
+        record.edgeCount = CountSubShapes(feature->GetResultShape(), TopAbs_EDGE);
+        m_profiler.AddRecord(record);
     }
+    return record.succeeded;
 }
 
-bool FeatureManager::ExecuteAllFeatures() {
-    bool allSucceeded = true;
+void FeatureManager::FinishFeature(const FeaturePtr& feature, bool succeeded) {
+    // 失败也算处理过，参数或输入再变化时才会重试
+    feature->ClearDirty();
+    RecordSketchVersions(feature);
     
-    for (const auto& feature : m_features) {
-        if (!ExecuteFeature(feature)) {
-            allSucceeded = false;
-        }
+    // 结果已变化，直接下游需要跟着重建
+    for (const auto& dependent : GetDependents(feature)) {
+        dependent->MarkDirty();
     }
     
-    return allSucceeded;
+    if (succeeded) {
+        NotifyFeatureUpdated(feature);
+    }
+}
+
+bool FeatureManager::ExecuteAllFeatures() {
+    // 全量重建不沿用内存中的结果
+    for (const auto& feature : m_features) {
+        feature->SetResultShape(feature->GetResultShape(), 0);
+        feature->MarkDirty();
+    }
+    return RebuildDirtyFeatures();
 }
 
 void FeatureManager::SetFeatureActive(const FeaturePtr& feature, bool active) {
-    feature->SetActive(active);
+    if (feature->IsActive() != active) {
+        feature->SetActive(active);
+        MarkFeatureDirty(feature);
+    }
     NotifyFeatureUpdated(feature);
 }
 
 void FeatureManager::SetAllFeaturesActive(bool active) {
     for (const auto& feature : m_features) {
-        feature->SetActive(active);
+        if (feature->IsActive() != active) {
+            feature->SetActive(active);
+            MarkFeatureDirty(feature);
+        }
     }
 }
 
 void FeatureManager::MoveFeatureUp(const FeaturePtr& feature) {
     int index = FindFeatureIndex(feature);
     if (index > 0) {
-        std::swap(m_features[index], m_features[index - 1]);
-        NotifyFeatureUpdated(feature);
+        MoveFeatureToIndex(feature, index - 1);
     }
 }
 
 void FeatureManager::MoveFeatureDown(const FeaturePtr& feature) {
     int index = FindFeatureIndex(feature);
     if (index >= 0 && index < static_cast<int>(m_features.size()) - 1) {
-        std::swap(m_features[index], m_features[index + 1]);
-        NotifyFeatureUpdated(feature);
+        MoveFeatureToIndex(feature, index + 1);
     }
 }
 
 void FeatureManager::MoveFeatureToIndex(const FeaturePtr& feature, int newIndex) {
     int currentIndex = FindFeatureIndex(feature);
-    if (currentIndex >= 0 && newIndex >= 0 && newIndex < static_cast<int>(m_features.size())) {
-        m_features.erase(m_features.begin() + currentIndex);
-        m_features.insert(m_features.begin() + newIndex, feature);
-        NotifyFeatureUpdated(feature);
+    if (currentIndex < 0 || currentIndex == newIndex || !CanMoveFeatureToIndex(feature, newIndex)) {
+        return;
+    }
+    
+    m_features.erase(m_features.begin() + currentIndex);
+    m_features.insert(m_features.begin() + newIndex, feature);
+    NotifyFeatureUpdated(feature);
+    RebuildFromIndex(std::min(currentIndex, newIndex));
+}
+
+bool FeatureManager::CanMoveFeatureToIndex(const FeaturePtr& feature, int newIndex) const {
+    int currentIndex = FindFeatureIndex(feature);
+    if (currentIndex < 0 || newIndex < 0 || newIndex >= static_cast<int>(m_features.size())) {
+        return false;
+    }
+    
+    // 列表顺序必须仍是合法的拓扑顺序：输入在前，下游在后
+    for (const auto& input : GetDependencies(feature)) {
+        int inputIndex = FindFeatureIndex(input);
+        if (newIndex < currentIndex && inputIndex >= newIndex && inputIndex < currentIndex) {
+            return false;
+        }
+    }
+    for (const auto& dependent : GetDependents(feature)) {
+        int dependentIndex = FindFeatureIndex(dependent);
+        if (newIndex > currentIndex && dependentIndex > currentIndex && dependentIndex <= newIndex) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FeatureManager::AddDependency(const FeaturePtr& feature, const FeaturePtr& input) {
+    if (!feature || !input || feature == input) {
+        return false;
+    }
+    // 输入必须排在使用者之前，回滚和检查点都依赖这一点
+    int featureIndex = FindFeatureIndex(feature);
+    int inputIndex = FindFeatureIndex(input);
+    if (featureIndex < 0 || inputIndex < 0 || inputIndex > featureIndex) {
+        return false;
+    }
+    // input 已经依赖 feature 时会形成环
+    if (DependsOn(input, feature)) {
+        return false;
+    }
+    
+    auto& inputs = m_inputs[feature->GetId()];
+    if (std::find(inputs.begin(), inputs.end(), input->GetId()) != inputs.end()) {
+        return true;
+    }
+    inputs.push_back(input->GetId());
+    m_dependents[input->GetId()].push_back(feature->GetId());
+    MarkFeatureDirty(feature);
+    return true;
+}
+
+void FeatureManager::RemoveDependency(const FeaturePtr& feature, const FeaturePtr& input) {
+    if (!feature || !input) {
+        return;
+    }
+    
+    auto inputsIt = m_inputs.find(feature->GetId());
+    if (inputsIt == m_inputs.end()) {
+        return;
+    }
+    auto& inputs = inputsIt->second;
+    auto it = std::find(inputs.begin(), inputs.end(), input->GetId());
+    if (it == inputs.end()) {
+        return;
+    }
+    inputs.erase(it);
+    
+    auto& dependents = m_dependents[input->GetId()];
+    dependents.erase(std::remove(dependents.begin(), dependents.end(), feature->GetId()), dependents.end());
+    MarkFeatureDirty(feature);
+}
+
+std::vector<FeaturePtr> FeatureManager::GetDependencies(const FeaturePtr& feature) const {
+    std::vector<FeaturePtr> result;
+    if (!feature) {
+        return result;
+    }
+    auto it = m_inputs.find(feature->GetId());
+    if (it != m_inputs.end()) {
+        for (int id : it->second) {
+            if (auto input = GetFeatureById(id)) {
+                result.push_back(input);
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<FeaturePtr> FeatureManager::GetDependents(const FeaturePtr& feature) const {
+    std::vector<FeaturePtr> result;
+    if (!feature) {
+        return result;
+    }
+    auto it = m_dependents.find(feature->GetId());
+    if (it != m_dependents.end()) {
+        for (int id : it->second) {
+            if (auto dependent = GetFeatureById(id)) {
+                result.push_back(dependent);
+            }
+        }
+    }
+    return result;
+}
+
+bool FeatureManager::DependsOn(const FeaturePtr& feature, const FeaturePtr& input) const {
+    if (!feature || !input) {
+        return false;
+    }
+    
+    // 从 feature 沿输入边向上搜索
+    std::set<int> visited;
+    std::vector<int> stack{feature->GetId()};
+    while (!stack.empty()) {
+        int id = stack.back();
+        stack.pop_back();
+        auto it = m_inputs.find(id);
+        if (it == m_inputs.end()) {
+            continue;
+        }
+        for (int inputId : it->second) {
+            if (inputId == input->GetId()) {
+                return true;
+            }
+            if (visited.insert(inputId).second) {
+                stack.push_back(inputId);
+            }
+        }
+    }
+    return false;
+}
+
+std::vector<FeaturePtr> FeatureManager::GetTopologicalOrder() const {
+    // Kahn 算法，入度为0的特征中优先取列表中靠前的
+    std::map<int, int> indexById;
+    for (int i = 0; i < static_cast<int>(m_features.size()); ++i) {
+        indexById[m_features[i]->GetId()] = i;
+    }
+    
+    std::vector<int> inDegree(m_features.size(), 0);
+    for (int i = 0; i < static_cast<int>(m_features.size()); ++i) {
+        auto it = m_inputs.find(m_features[i]->GetId());
+        if (it != m_inputs.end()) {
+            for (int inputId : it->second) {
+                if (indexById.count(inputId)) {
+                    ++inDegree[i];
+                }
+            }
+        }
+    }
+    
+    std::priority_queue<int, std::vector<int>, std::greater<int>> ready;
+    for (int i = 0; i < static_cast<int>(inDegree.size()); ++i) {
+        if (inDegree[i] == 0) {
+            ready.push(i);
+        }
+    }
+    
+    std::vector<FeaturePtr> order;
+    order.reserve(m_features.size());
+    while (!ready.empty()) {
+        int index = ready.top();
+        ready.pop();
+        order.push_back(m_features[index]);
+        
+        auto it = m_dependents.find(m_features[index]->GetId());
+        if (it == m_dependents.end()) {
+            continue;
+        }
+        for (int dependentId : it->second) {
+            auto indexIt = indexById.find(dependentId);
+            if (indexIt != indexById.end() && --inDegree[indexIt->second] == 0) {
+                ready.push(indexIt->second);
+            }
+        }
+    }
+    
+    return order;
+}
+
+void FeatureManager::MarkFeatureDirty(const FeaturePtr& feature) {
+    if (!feature) {
+        return;
+    }
+    
+    std::set<int> visited{feature->GetId()};
+    std::vector<FeaturePtr> stack{feature};
+    while (!stack.empty()) {
+        FeaturePtr current = stack.back();
+        stack.pop_back();
+        current->MarkDirty();
+        for (const auto& dependent : GetDependents(current)) {
+            if (visited.insert(dependent->GetId()).second) {
+                stack.push_back(dependent);
+            }
+        }
+    }
+}
+
+std::vector<FeaturePtr> FeatureManager::GetDirtyFeatures() const {
+    return CollectRebuildSet();
+}
+
+std::vector<FeaturePtr> FeatureManager::CollectRebuildSet() const {
+    // 按拓扑顺序传播：自身脏、草图已修改或任一输入要重建时都要重建
+    std::vector<FeaturePtr> rebuildSet;
+    std::set<int> rebuilding;
+    
+    // 回滚标记之后的特征不参与
+    std::set<int> rolledBack;
+    for (int i = GetEffectiveRollbackIndex(); i < static_cast<int>(m_features.size()); ++i) {
+        rolledBack.insert(m_features[i]->GetId());
+    }
+    
+    for (const auto& feature : GetTopologicalOrder()) {
+        if (rolledBack.count(feature->GetId())) {
+            continue;
+        }
+        bool needsRebuild = feature->IsDirty() || IsSketchStale(feature);
+        if (!needsRebuild) {
+            auto it = m_inputs.find(feature->GetId());
+            if (it != m_inputs.end()) {
+                for (int inputId : it->second) {
+                    if (rebuilding.count(inputId)) {
+                        needsRebuild = true;
+                        break;
+                    }
+                }
+            }
+        }
+        if (needsRebuild) {
+            rebuilding.insert(feature->GetId());
+            rebuildSet.push_back(feature);
+        }
+    }
+    return rebuildSet;
+}
+
+bool FeatureManager::RebuildDirtyFeatures() {
+    QElapsedTimer timer;
+    timer.start();
+    const bool profiling = m_profiler.IsEnabled();
+    if (profiling) {
+        m_profiler.BeginRebuild();
+    }
+    
+    std::vector<FeaturePtr> features;
+    for (const auto& feature : CollectRebuildSet()) {
+        if (!feature->IsActive()) {
+            // 抑制的特征不执行，下游照样已在重建集合中
+            feature->ClearDirty();
+            RecordSketchVersions(feature);
+            continue;
+        }
+        features.push_back(feature);
+    }
+    m_lastRebuildCount = static_cast<int>(features.size());
+    m_memoryHits = 0;
+    m_diskHits = 0;
+    m_computed = 0;
+    
+    bool allSucceeded = true;
+    if (m_parallelRebuild && features.size() > 1 && m_threadPool->maxThreadCount() > 1) {
+        allSucceeded = RebuildInParallel(features);
+    } else {
+        for (const auto& feature : features) {
+            if (!RunFeature(feature)) {
+                allSucceeded = false;
+            }
+        }
+    }
+    
+    UpdateCheckpoints();
+    
+    if (profiling) {
+        m_profiler.EndRebuild(timer.nsecsElapsed() / 1.0e6);
     }
+    NotifyRebuildFinished();
+    return allSucceeded;
+}
+
+bool FeatureManager::RebuildInParallel(const std::vector<FeaturePtr>& features) {
+    // features 已按拓扑顺序排列
+    std::vector<RebuildTask> tasks(features.size());
+    std::map<int, int> taskById;
+    for (int i = 0; i < static_cast<int>(features.size()); ++i) {
+        tasks[i].feature = features[i];
+        taskById[features[i]->GetId()] = i;
+    }
+    
+    for (int i = 0; i < static_cast<int>(tasks.size()); ++i) {
+        for (const auto& input : GetDependencies(tasks[i].feature)) {
+            auto it = taskById.find(input->GetId());
+            if (it != taskById.end()) {
+                tasks[it->second].dependents.push_back(i);
+                ++tasks[i].pendingInputs;
+            }
+        }
+    }
+    
+    std::mutex mutex;
+    std::function<void(int)> startTask;
+    startTask = [&](int index) {
+        m_threadPool->start(QRunnable::create([&, index]() {
+            RebuildTask& task = tasks[index];
+            
+            // 输入任务都已完成，这里读取它们的结果是安全的
+            std::vector<cad_core::ShapePtr> inputShapes;
+            std::vector<std::size_t> inputKeys;
+            CollectInputs(task.feature, inputShapes, inputKeys);
+            
+            task.succeeded = ComputeFeature(task.feature, inputShapes, inputKeys);
+            
+            // 释放输入已全部就绪的下游
+            std::lock_guard<std::mutex> lock(mutex);
+            for (int dependent : task.dependents) {
+                if (--tasks[dependent].pendingInputs == 0) {
+                    startTask(dependent);
+                }
+            }
+        }));
+    };
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < static_cast<int>(tasks.size()); ++i) {
+            if (tasks[i].pendingInputs == 0) {
+                startTask(i);
+            }
+        }
+    }
+    m_threadPool->waitForDone();
+    
+    // 版本记录和界面通知按拓扑顺序在调用线程上完成，与串行重建一致
+    bool allSucceeded = true;
+    for (const auto& task : tasks) {
+        FinishFeature(task.feature, task.succeeded);
+        if (!task.succeeded) {
+            allSucceeded = false;
+        }
+    }
+    return allSucceeded;
+}
+
+int FeatureManager::GetLastRebuildCount() const {
+    return m_lastRebuildCount;
+}
+
+void FeatureManager::SetParallelRebuild(bool parallel) {
+    m_parallelRebuild = parallel;
+}
+
+bool FeatureManager::IsParallelRebuild() const {
+    return m_parallelRebuild;
+}
+
+void FeatureManager::SetMaxThreadCount(int count) {
+    m_threadPool->setMaxThreadCount(count);
+}
+
+void FeatureManager::SetCacheDirectory(const std::string& directory) {
+    m_diskCache.SetDirectory(directory);
+}
+
+const std::string& FeatureManager::GetCacheDirectory() const {
+    return m_diskCache.GetDirectory();
+}
+
+int FeatureManager::SpillResultsToDisk() const {
+    if (!m_diskCache.IsEnabled()) {
+        return 0;
+    }
+    
+    int stored = 0;
+    for (const auto& feature : m_features) {
+        const std::size_t key = feature->GetResultKey();
+        if (!feature->GetResultShape() || key == 0 || m_diskCache.Contains(key)) {
+            continue;
+        }
+        if (m_diskCache.Store(key, feature->GetResultShape())) {
+            ++stored;
+        }
+    }
+    return stored;
+}
+
+void FeatureManager::ClearDiskCache() const {
+    m_diskCache.Clear();
+}
+
+void FeatureManager::SetRollbackIndex(int index) {
+    if (index < 0 || index >= static_cast<int>(m_features.size())) {
+        RollToEnd();
+        return;
+    }
+    
+    int previous = GetEffectiveRollbackIndex();
+    m_rollbackIndex = index;
+    // 向后滚动时，新加入的特征可能在回滚期间被改过，补算它们
+    if (index > previous) {
+        RebuildDirtyFeatures();
+    }
+}
+
+int FeatureManager::GetRollbackIndex() const {
+    return GetEffectiveRollbackIndex();
+}
+
+void FeatureManager::RollToEnd() {
+    if (m_rollbackIndex < 0) {
+        return;
+    }
+    m_rollbackIndex = -1;
+    RebuildDirtyFeatures();
+}
+
+bool FeatureManager::IsRolledBack(const FeaturePtr& feature) const {
+    int index = FindFeatureIndex(feature);
+    return index >= 0 && index >= GetEffectiveRollbackIndex();
+}
+
+int FeatureManager::GetEffectiveRollbackIndex() const {
+    return m_rollbackIndex >= 0 ? m_rollbackIndex : static_cast<int>(m_features.size());
+}
+
+void FeatureManager::SetCheckpointInterval(int interval) {
+    m_checkpointInterval = std::max(0, interval);
+}
+
+int FeatureManager::GetCheckpointInterval() const {
+    return m_checkpointInterval;
+}
+
+void FeatureManager::AddCheckpoint(int index) {
+    if (index > 0) {
+        m_checkpointIndices.insert(index);
+    }
+}
+
+void FeatureManager::RemoveCheckpoint(int index) {
+    m_checkpointIndices.erase(index);
+    m_checkpoints.erase(index);
+}
+
+std::vector<int> FeatureManager::GetCheckpoints() const {
+    return GetCheckpointIndices();
+}
+
+std::vector<int> FeatureManager::GetCheckpointIndices() const {
+    std::set<int> indices(m_checkpointIndices);
+    if (m_checkpointInterval > 0) {
+        for (int index = m_checkpointInterval; index <= static_cast<int>(m_features.size()); index += m_checkpointInterval) {
+            indices.insert(index);
+        }
+    }
+    return std::vector<int>(indices.begin(), indices.end());
+}
+
+bool FeatureManager::IsCheckpointValid(int index) const {
+    auto it = m_checkpoints.find(index);
+    if (it == m_checkpoints.end() || index > static_cast<int>(m_features.size())) {
+        return false;
+    }
+    
+    // 前缀中的特征、顺序、参数、激活状态和输入都必须和保存时一致，且没有待重建的改动
+    const auto& snapshots = it->second;
+    if (static_cast<int>(snapshots.size()) != index) {
+        return false;
+    }
+    for (int i = 0; i < index; ++i) {
+        const FeaturePtr& feature = m_features[i];
+        const FeatureSnapshot& snapshot = snapshots[i];
+        if (feature != snapshot.feature || feature->GetVersion() != snapshot.version || feature->IsDirty() ||
+            feature->IsActive() != snapshot.active || GetDependencies(feature) != snapshot.dependencies ||
+            IsSketchStale(feature)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FeatureManager::UpdateCheckpoints() {
+    const int limit = GetEffectiveRollbackIndex();
+    
+    // 第一个脏特征之后的前缀都不干净
+    int cleanPrefix = 0;
+    while (cleanPrefix < limit && !m_features[cleanPrefix]->IsDirty()) {
+        ++cleanPrefix;
+    }
+    
+    for (int index : GetCheckpointIndices()) {
+        if (index > cleanPrefix) {
+            break;
+        }
+        if (IsCheckpointValid(index)) {
+            continue;
+        }
+        
+        std::vector<FeatureSnapshot> snapshots;
+        snapshots.reserve(index);
+        for (int i = 0; i < index; ++i) {
+            const FeaturePtr& feature = m_features[i];
+            FeatureSnapshot snapshot;
+            snapshot.feature = feature;
+            snapshot.version = feature->GetVersion();
+            snapshot.shape = feature->GetResultShape();
+            snapshot.key = feature->GetResultKey();
+            snapshot.state = feature->GetState();
+            snapshot.active = feature->IsActive();
+            snapshot.dependencies = GetDependencies(feature);
+            snapshots.push_back(snapshot);
+        }
+        m_checkpoints[index] = std::move(snapshots);
+    }
+}
+
+bool FeatureManager::RebuildFromIndex(int index) {
+    const int limit = GetEffectiveRollbackIndex();
+    index = std::max(0, std::min(index, limit));
+    
+    // 不晚于改动位置的最近有效检查点
+    int checkpoint = 0;
+    for (int candidate : GetCheckpointIndices()) {
+        if (candidate > index) {
+            break;
+        }
+        if (IsCheckpointValid(candidate)) {
+            checkpoint = candidate;
+        }
+    }
+    m_lastRestoredCheckpoint = checkpoint;
+    
+    // 检查点之前的特征恢复保存的结果，不再计算
+    if (checkpoint > 0) {
+        for (const auto& snapshot : m_checkpoints[checkpoint]) {
+            snapshot.feature->SetResultShape(snapshot.shape, snapshot.key);
+            snapshot.feature->SetState(snapshot.state);
+            snapshot.feature->ClearDirty();
+        }
+    }
+    
+    // 检查点之后的特征重新求值（缓存键没变的仍直接沿用结果）
+    for (int i = checkpoint; i < limit; ++i) {
+        m_features[i]->MarkDirty();
+    }
+    return RebuildDirtyFeatures();
+}
+
+int FeatureManager::GetLastRestoredCheckpoint() const {
+    return m_lastRestoredCheckpoint;
+}
+
+FeatureCacheStatistics FeatureManager::GetLastCacheStatistics() const {
+    FeatureCacheStatistics statistics;
+    statistics.memoryHits = m_memoryHits;
+    statistics.diskHits = m_diskHits;
+    statistics.computed = m_computed;
+    return statistics;
+}
+
+void FeatureManager::SetProfilingEnabled(bool enabled) {
+    m_profiler.SetEnabled(enabled);
+}
+
+bool FeatureManager::IsProfilingEnabled() const {
+    return m_profiler.IsEnabled();
+}
+
+FeatureProfiler& FeatureManager::GetProfiler() {
+    return m_profiler;
+}
+
+const FeatureProfiler& FeatureManager::GetProfiler() const {
+    return m_profiler;
 }
 
 void FeatureManager::UpdateFeature(const FeaturePtr& feature) {
-    ExecuteFeature(feature);
+    MarkFeatureDirty(feature);
+    RebuildDirtyFeatures();
 }
 
 void FeatureManager::RebuildAllFeatures() {
@@ -142,6 +894,10 @@ void FeatureManager::SetFeatureUpdatedCallback(std::function<void(const FeatureP
     m_featureUpdatedCallback = callback;
 }
 
+void FeatureManager::SetRebuildFinishedCallback(std::function<void()> callback) {
+    m_rebuildFinishedCallback = callback;
+}
+
 int FeatureManager::FindFeatureIndex(const FeaturePtr& feature) const {
     auto it = std::find(m_features.begin(), m_features.end(), feature);
     if (it != m_features.end()) {
@@ -150,6 +906,55 @@ int FeatureManager::FindFeatureIndex(const FeaturePtr& feature) const {
     return -1;
 }
 
+bool FeatureManager::IsSketchStale(const FeaturePtr& feature) const {
+    auto sketches = feature->GetInputSketches();
+    auto it = m_sketchVersions.find(feature->GetId());
+    if (it == m_sketchVersions.end()) {
+        return !sketches.empty();
+    }
+    
+    const auto& versions = it->second;
+    if (versions.size() != sketches.size()) {
+        return true;
+    }
+    for (size_t i = 0; i < sketches.size(); ++i) {
+        if (!sketches[i] || sketches[i]->GetVersion() != versions[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FeatureManager::RecordSketchVersions(const FeaturePtr& feature) {
+    std::vector<unsigned long> versions;
+    for (const auto& sketch : feature->GetInputSketches()) {
+        versions.push_back(sketch ? sketch->GetVersion() : 0);
+    }
+    m_sketchVersions[feature->GetId()] = versions;
+}
+
+void FeatureManager::RemoveFeatureEdges(int featureId) {
+    auto inputsIt = m_inputs.find(featureId);
+    if (inputsIt != m_inputs.end()) {
+        for (int inputId : inputsIt->second) {
+            auto& dependents = m_dependents[inputId];
+            dependents.erase(std::remove(dependents.begin(), dependents.end(), featureId), dependents.end());
+        }
+        m_inputs.erase(inputsIt);
+    }
+    
+    auto dependentsIt = m_dependents.find(featureId);
+    if (dependentsIt != m_dependents.end()) {
+        for (int dependentId : dependentsIt->second) {
+            auto& inputs = m_inputs[dependentId];
+            inputs.erase(std::remove(inputs.begin(), inputs.end(), featureId), inputs.end());
+        }
+        m_dependents.erase(dependentsIt);
+    }
+    
+    m_sketchVersions.erase(featureId);
+}
+
 void FeatureManager::NotifyFeatureAdded(const FeaturePtr& feature) {
     if (m_featureAddedCallback) {
         m_featureAddedCallback(feature);
@@ -168,4 +973,10 @@ void FeatureManager::NotifyFeatureUpdated(const FeaturePtr& feature) {
     }
 }
 
+void FeatureManager::NotifyRebuildFinished() {
+    if (m_rebuildFinishedCallback) {
+        m_rebuildFinishedCallback();
+    }
+}
+
 } // namespace cad_feature
\ No newline at end of file
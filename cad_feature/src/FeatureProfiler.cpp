@@ -0,0 +1,167 @@
+﻿#include "cad_feature/FeatureProfiler.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <algorithm>
+
+namespace cad_feature {
+
+FeatureProfiler::FeatureProfiler()
+    : m_enabled(false), m_rebuildCount(0), m_lastRebuildWallTimeMs(0.0) {
+}
+
+void FeatureProfiler::SetEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_enabled = enabled;
+}
+
+bool FeatureProfiler::IsEnabled() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_enabled;
+}
+
+void FeatureProfiler::BeginRebuild() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_rebuildCount;
+    m_lastRecords.clear();
+    m_lastRebuildWallTimeMs = 0.0;
+}
+
+void FeatureProfiler::EndRebuild(double wallTimeMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lastRebuildWallTimeMs = wallTimeMs;
+}
+
+void FeatureProfiler::AddRecord(FeatureProfileRecord record) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    record.rebuild = m_rebuildCount;
+    
+    FeatureProfileSummary& summary = m_summaries[record.featureId];
+    summary.featureId = record.featureId;
+    summary.featureName = record.featureName;
+    ++summary.executions;
+    if (record.cacheResult != FeatureCacheResult::Computed) {
+        ++summary.cacheHits;
+    }
+    summary.totalWallTimeMs += record.wallTimeMs;
+    summary.maxWallTimeMs = std::max(summary.maxWallTimeMs, record.wallTimeMs);
+    
+    m_lastRecords.push_back(std::move(record));
+}
+
+std::vector<FeatureProfileRecord> FeatureProfiler::GetLastRebuildRecords() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastRecords;
+}
+
+std::vector<FeatureProfileSummary> FeatureProfiler::GetSummaries() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<FeatureProfileSummary> summaries;
+    summaries.reserve(m_summaries.size());
+    for (const auto& entry : m_summaries) {
+        summaries.push_back(entry.second);
+    }
+    return summaries;
+}
+
+double FeatureProfiler::GetLastRebuildWallTime() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastRebuildWallTimeMs;
+}
+
+int FeatureProfiler::GetRebuildCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rebuildCount;
+}
+
+void FeatureProfiler::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rebuildCount = 0;
+    m_lastRebuildWallTimeMs = 0.0;
+    m_lastRecords.clear();
+    m_summaries.clear();
+}
+
+const char* FeatureProfiler::GetCacheResultName(FeatureCacheResult result) {
+    switch (result) {
+        case FeatureCacheResult::Computed:
+            return "miss";
+        case FeatureCacheResult::MemoryHit:
+            return "memory";
+        case FeatureCacheResult::DiskHit:
+            return "disk";
+    }
+    return "unknown";
+}
+
+const char* FeatureProfiler::GetFeatureTypeName(FeatureType type) {
+    switch (type) {
+        case FeatureType::Extrude: return "Extrude";
+        case FeatureType::Revolve: return "Revolve";
+        case FeatureType::Sweep: return "Sweep";
+        case FeatureType::Loft: return "Loft";
+        case FeatureType::Fillet: return "Fillet";
+        case FeatureType::Chamfer: return "Chamfer";
+        case FeatureType::Draft: return "Draft";
+        case FeatureType::Shell: return "Shell";
+        case FeatureType::Cut: return "Cut";
+        case FeatureType::Union: return "Union";
+        case FeatureType::Intersection: return "Intersection";
+        case FeatureType::Pattern: return "Pattern";
+    }
+    return "Unknown";
+}
+
+std::string FeatureProfiler::ToJson() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    QJsonArray features;
+    for (const auto& record : m_lastRecords) {
+        QJsonObject object;
+        object["id"] = record.featureId;
+        object["name"] = QString::fromStdString(record.featureName);
+        object["type"] = GetFeatureTypeName(record.featureType);
+        object["wallTimeMs"] = record.wallTimeMs;
+        object["buildTimeMs"] = record.buildTimeMs;
+        object["validateTimeMs"] = record.validateTimeMs;
+        object["healTimeMs"] = record.healTimeMs;
+        object["faces"] = record.faceCount;
+        object["edges"] = record.edgeCount;
+        object["cache"] = GetCacheResultName(record.cacheResult);
+        object["succeeded"] = record.succeeded;
+        features.append(object);
+    }
+    
+    QJsonArray summaries;
+    for (const auto& entry : m_summaries) {
+        const FeatureProfileSummary& summary = entry.second;
+        QJsonObject object;
+        object["id"] = summary.featureId;
+        object["name"] = QString::fromStdString(summary.featureName);
+        object["executions"] = summary.executions;
+        object["cacheHits"] = summary.cacheHits;
+        object["totalWallTimeMs"] = summary.totalWallTimeMs;
+        object["maxWallTimeMs"] = summary.maxWallTimeMs;
+        summaries.append(object);
+    }
+    
+    QJsonObject root;
+    root["rebuild"] = m_rebuildCount;
+    root["rebuildWallTimeMs"] = m_lastRebuildWallTimeMs;
+    root["features"] = features;
+    root["summaries"] = summaries;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented).toStdString();
+}
+
+bool FeatureProfiler::ExportJson(const std::string& path) const {
+    QFile file(QString::fromStdString(path));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    const std::string json = ToJson();
+    return file.write(json.data(), static_cast<qint64>(json.size())) == static_cast<qint64>(json.size());
+}
+
+} // namespace cad_feature
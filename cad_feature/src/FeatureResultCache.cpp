@@ -0,0 +1,125 @@
+﻿#include "cad_feature/FeatureResultCache.h"
+#include <BinTools.hxx>
+#include <Standard_Failure.hxx>
+#include <TopoDS_Shape.hxx>
+#include <QDir>
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace cad_feature {
+
+namespace {
+
+const char* const kCacheFileSuffix = ".fbin";
+
+// 文件头：标识 + 完整的缓存键，读回时核对，文件名冲突或旧格式的文件当作未命中
+const char kCacheFileMagic[4] = {'F', 'R', 'C', '1'};
+
+struct CacheFileHeader {
+    char magic[4];
+    std::uint64_t key;
+};
+
+} // namespace
+
+FeatureResultCache::FeatureResultCache(const std::string& directory) {
+    SetDirectory(directory);
+}
+
+void FeatureResultCache::SetDirectory(const std::string& directory) {
+    m_directory = directory;
+    if (!m_directory.empty()) {
+        QDir().mkpath(QString::fromStdString(m_directory));
+    }
+}
+
+const std::string& FeatureResultCache::GetDirectory() const {
+    return m_directory;
+}
+
+bool FeatureResultCache::IsEnabled() const {
+    return !m_directory.empty();
+}
+
+bool FeatureResultCache::Contains(std::size_t key) const {
+    return IsEnabled() && key != 0 && QFile::exists(QString::fromStdString(GetFilePath(key)));
+}
+
+cad_core::ShapePtr FeatureResultCache::Load(std::size_t key) const {
+    if (!Contains(key)) {
+        return nullptr;
+    }
+    
+    const QByteArray path = QString::fromStdString(GetFilePath(key)).toLocal8Bit();
+    std::ifstream stream(path.constData(), std::ios::binary);
+    CacheFileHeader header;
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, kCacheFileMagic, sizeof(kCacheFileMagic)) != 0 ||
+        header.key != static_cast<std::uint64_t>(key)) {
+        return nullptr;
+    }
+    
+    try {
+        TopoDS_Shape shape;
+        BinTools::Read(shape, stream);
+        if (!stream.fail() && !shape.IsNull()) {
+            return std::make_shared<cad_core::Shape>(shape);
+        }
+    } catch (const Standard_Failure&) {
+        // 缓存文件损坏时当作未命中
+    }
+    
+    return nullptr;
+}
+
+bool FeatureResultCache::Store(std::size_t key, const cad_core::ShapePtr& shape) const {
+    if (!IsEnabled() || key == 0 || !shape || shape->GetOCCTShape().IsNull()) {
+        return false;
+    }
+    
+    // 先写临时文件再改名，读的一方不会看到写了一半的文件
+    const QString path = QString::fromStdString(GetFilePath(key));
+    const QString temporaryPath = path + ".tmp";
+    
+    try {
+        std::ofstream stream(temporaryPath.toLocal8Bit().constData(), std::ios::binary | std::ios::trunc);
+        CacheFileHeader header;
+        std::memcpy(header.magic, kCacheFileMagic, sizeof(kCacheFileMagic));
+        header.key = static_cast<std::uint64_t>(key);
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        BinTools::Write(shape->GetOCCTShape(), stream);
+        stream.close();
+        if (stream.fail()) {
+            QFile::remove(temporaryPath);
+            return false;
+        }
+    } catch (const Standard_Failure&) {
+        QFile::remove(temporaryPath);
+        return false;
+    }
+    
+    QFile::remove(path);
+    return QFile::rename(temporaryPath, path);
+}
+
+void FeatureResultCache::Clear() const {
+    if (!IsEnabled()) {
+        return;
+    }
+    
+    QDir directory(QString::fromStdString(m_directory));
+    const QStringList files = directory.entryList(QStringList() << QString("*") + kCacheFileSuffix, QDir::Files);
+    for (const QString& file : files) {
+        directory.remove(file);
+    }
+}
+
+std::string FeatureResultCache::GetFilePath(std::size_t key) const {
+    const QString fileName = QString::number(static_cast<qulonglong>(key), 16) + kCacheFileSuffix;
+    return QDir(QString::fromStdString(m_directory)).filePath(fileName).toStdString();
+}
+
+} // namespace cad_feature
@@ -1,12 +1,47 @@
 ﻿#include "cad_feature/LivePreview.h"
+#include <QElapsedTimer>
+#include <QRunnable>
+#include <Standard_Failure.hxx>
+#include <algorithm>
+#include <exception>
 
 namespace cad_feature {
 
-LivePreview::LivePreview(QObject* parent) : QObject(parent), m_previewActive(false), m_updateDelay(500) {
+// 一次预览计算：工作线程只写 result 和 duration，完成后通过排队信号交给GUI线程
+struct LivePreviewTask {
+    quint64 generation = 0;
+    FeaturePtr feature;     // 脱离了共享输入的副本，GUI线程继续修改原特征和草图也不受影响
+    cad_core::CancellationTokenPtr token;
+    cad_core::ShapePtr result;
+    qint64 duration = 0;
+};
+
+namespace {
+
+// 新耗时在滑动平均中的权重
+const double kDurationSmoothing = 0.3;
+
+} // namespace
+
+LivePreview::LivePreview(QObject* parent)
+    : QObject(parent), m_previewActive(false), m_updateDelay(500),
+      m_adaptiveDelay(true), m_minUpdateDelay(30), m_maxUpdateDelay(500),
+      m_averageDuration(-1.0), m_lastDuration(-1), m_generation(0) {
     m_updateTimer = new QTimer(this);
     m_updateTimer->setSingleShot(true);
     
+    // 两个线程：被取消的计算收尾时，新的计算可以先开始
+    m_threadPool = new QThreadPool(this);
+    m_threadPool->setMaxThreadCount(2);
+    
     connect(m_updateTimer, &QTimer::timeout, this, &LivePreview::OnUpdateTimer);
+    connect(this, &LivePreview::previewFinished, this, &LivePreview::OnPreviewFinished, Qt::QueuedConnection);
+}
+
+LivePreview::~LivePreview() {
+    // 工作线程持有本对象的信号，销毁前取消并等待其结束
+    CancelPendingPreview();
+    m_threadPool->waitForDone();
 }
 
 void LivePreview::SetFeature(const FeaturePtr& feature) {
@@ -29,6 +64,7 @@ void LivePreview::StartPreview() {
 void LivePreview::StopPreview() {
     m_previewActive = false;
     m_updateTimer->stop();
+    CancelPendingPreview();
     ClearPreviewShape();
 }
 
@@ -37,8 +73,11 @@ void LivePreview::UpdatePreview() {
         return;
     }
     
+    // 参数已变化，进行中的计算作废
+    CancelPendingPreview();
+    
     // Restart the timer to delay the update
-    m_updateTimer->start(m_updateDelay);
+    m_updateTimer->start(GetUpdateDelay());
 }
 
 bool LivePreview::IsPreviewActive() const {
@@ -55,10 +94,36 @@ void LivePreview::SetPreviewActive(bool active) {
 
 void LivePreview::SetUpdateDelay(int milliseconds) {
     m_updateDelay = milliseconds;
+    m_adaptiveDelay = false;
 }
 
 int LivePreview::GetUpdateDelay() const {
-    return m_updateDelay;
+    if (!m_adaptiveDelay) {
+        return m_updateDelay;
+    }
+    // 还没有耗时数据时用上限，宁可慢一点也不要白算
+    if (m_averageDuration < 0.0) {
+        return m_maxUpdateDelay;
+    }
+    return std::max(m_minUpdateDelay, std::min(m_maxUpdateDelay, static_cast<int>(m_averageDuration)));
+}
+
+void LivePreview::SetAdaptiveDelayRange(int minMilliseconds, int maxMilliseconds) {
+    m_minUpdateDelay = std::max(0, minMilliseconds);
+    m_maxUpdateDelay = std::max(m_minUpdateDelay, maxMilliseconds);
+    m_adaptiveDelay = true;
+}
+
+bool LivePreview::IsAdaptiveDelay() const {
+    return m_adaptiveDelay;
+}
+
+qint64 LivePreview::GetLastPreviewDuration() const {
+    return m_lastDuration;
+}
+
+bool LivePreview::IsComputing() const {
+    return m_task != nullptr;
 }
 
 void LivePreview::SetPreviewUpdateCallback(std::function<void(const cad_core::ShapePtr&)> callback) {
@@ -83,12 +148,71 @@ void LivePreview::UpdatePreviewShape() {
     // Set feature state to previewing
     m_feature->SetState(FeatureState::Previewing);
     
-    // Create preview shape
-    auto previewShape = m_feature->CreatePreviewShape();
+    FeaturePtr snapshot = m_feature->Clone();
+    if (!snapshot) {
+        // 不支持复制的特征只能在GUI线程上计算
+        QElapsedTimer timer;
+        timer.start();
+        auto previewShape = m_feature->CreatePreviewShape();
+        RecordDuration(timer.elapsed());
+        
+        if (m_previewUpdateCallback) {
+            m_previewUpdateCallback(previewShape);
+        }
+        return;
+    }
+    
+    // 草图轮廓和输入形状在GUI线程上做好快照，工作线程只访问副本
+    try {
+        snapshot->DetachInputs();
+    } catch (const Standard_Failure&) {
+        if (m_previewUpdateCallback) {
+            m_previewUpdateCallback(nullptr);
+        }
+        return;
+    }
+    
+    auto task = std::make_shared<LivePreviewTask>();
+    task->generation = ++m_generation;
+    task->feature = snapshot;
+    task->token = std::make_shared<cad_core::CancellationToken>();
+    snapshot->SetCancellationToken(task->token);
+    m_task = task;
+    
+    m_threadPool->start(QRunnable::create([this, task]() {
+        if (!task->token->IsCancelled()) {
+            QElapsedTimer timer;
+            timer.start();
+            try {
+                task->result = task->feature->CreatePreviewShape();
+            } catch (const Standard_Failure&) {
+                task->result.reset();
+            } catch (const std::exception&) {
+                task->result.reset();
+            }
+            task->duration = timer.elapsed();
+        }
+        emit previewFinished(task->generation);
+    }));
+}
+
+void LivePreview::OnPreviewFinished(quint64 generation) {
+    // 参数已变化或预览已停止：丢弃过期结果
+    if (!m_task || m_task->generation != generation || generation != m_generation) {
+        return;
+    }
+    
+    std::shared_ptr<LivePreviewTask> task = m_task;
+    m_task.reset();
+    if (task->token->IsCancelled()) {
+        return;
+    }
+    
+    RecordDuration(task->duration);
     
     // Notify callback
     if (m_previewUpdateCallback) {
-        m_previewUpdateCallback(previewShape);
+        m_previewUpdateCallback(task->result);
     }
 }
 
@@ -98,6 +222,23 @@ void LivePreview::ClearPreviewShape() {
     }
 }
 
+void LivePreview::CancelPendingPreview() {
+    ++m_generation;
+    if (m_task && m_task->token) {
+        m_task->token->Cancel();
+    }
+    m_task.reset();
+}
+
+void LivePreview::RecordDuration(qint64 milliseconds) {
+    m_lastDuration = milliseconds;
+    if (m_averageDuration < 0.0) {
+        m_averageDuration = static_cast<double>(milliseconds);
+    } else {
+        m_averageDuration += kDurationSmoothing * (static_cast<double>(milliseconds) - m_averageDuration);
+    }
+}
+
 } // namespace cad_feature
 
-#include "LivePreview.moc"
\ No newline at end of file
+#include "LivePreview.moc"
@@ -1,35 +1,55 @@
 ﻿#include "cad_feature/LoftFeature.h"
 #include "cad_core/CreateSphereCommand.h"
+#include <BRepAdaptor_Surface.hxx>
+#include <BRepAlgoAPI_Cut.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepOffsetAPI_ThruSections.hxx>
+#include <BRepTools.hxx>
+#include <BRep_Builder.hxx>
+#include <GeomAbs_SurfaceType.hxx>
+#include <Precision.hxx>
+#include <ShapeAnalysis.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
 #include <algorithm>
+#include <cmath>
+#include <utility>
 
 namespace cad_feature {
 
-LoftFeature::LoftFeature() : Feature(FeatureType::Loft, "Loft") {
-    SetParameter("solid", 1.0);
-    SetParameter("ruled", 0.0);
-    SetParameter("closed", 0.0);
+const ParameterSchema& LoftFeature::Schema() {
+    static const ParameterSchema schema({
+        {Solid, "solid", 1.0},
+        {Ruled, "ruled", 0.0},
+        {Closed, "closed", 0.0}
+    });
+    return schema;
 }
 
-LoftFeature::LoftFeature(const std::string& name) : Feature(FeatureType::Loft, name) {
-    SetParameter("solid", 1.0);
-    SetParameter("ruled", 0.0);
-    SetParameter("closed", 0.0);
+LoftFeature::LoftFeature() : Feature(FeatureType::Loft, "Loft", Schema()) {
+}
+
+LoftFeature::LoftFeature(const std::string& name) : Feature(FeatureType::Loft, name, Schema()) {
 }
 
 void LoftFeature::AddSection(const cad_sketch::SketchPtr& section) {
     m_sections.push_back(section);
+    MarkModified();
 }
 
 void LoftFeature::RemoveSection(const cad_sketch::SketchPtr& section) {
     auto it = std::find(m_sections.begin(), m_sections.end(), section);
     if (it != m_sections.end()) {
         m_sections.erase(it);
+        MarkModified();
     }
 }
 
 void LoftFeature::ClearSections() {
     m_sections.clear();
+    MarkModified();
 }
 
 const std::vector<cad_sketch::SketchPtr>& LoftFeature::GetSections() const {
@@ -42,49 +62,58 @@ int LoftFeature::GetSectionCount() const {
 
 void LoftFeature::AddGuideCurve(const cad_sketch::SketchPtr& guide) {
     m_guideCurves.push_back(guide);
+    MarkModified();
 }
 
 void LoftFeature::RemoveGuideCurve(const cad_sketch::SketchPtr& guide) {
     auto it = std::find(m_guideCurves.begin(), m_guideCurves.end(), guide);
     if (it != m_guideCurves.end()) {
         m_guideCurves.erase(it);
+        MarkModified();
     }
 }
 
 void LoftFeature::ClearGuideCurves() {
     m_guideCurves.clear();
+    MarkModified();
 }
 
 const std::vector<cad_sketch::SketchPtr>& LoftFeature::GetGuideCurves() const {
     return m_guideCurves;
 }
 
+std::vector<cad_sketch::SketchPtr> LoftFeature::GetInputSketches() const {
+    std::vector<cad_sketch::SketchPtr> sketches(m_sections);
+    sketches.insert(sketches.end(), m_guideCurves.begin(), m_guideCurves.end());
+    return sketches;
+}
+
 int LoftFeature::GetGuideCurveCount() const {
     return static_cast<int>(m_guideCurves.size());
 }
 
 void LoftFeature::SetSolid(bool solid) {
-    SetParameter("solid", solid ? 1.0 : 0.0);
+    SetParameter(Solid, solid ? 1.0 : 0.0);
 }
 
 bool LoftFeature::GetSolid() const {
-    return GetParameter("solid") != 0.0;
+    return GetParameter(Solid) != 0.0;
 }
 
 void LoftFeature::SetRuled(bool ruled) {
-    SetParameter("ruled", ruled ? 1.0 : 0.0);
+    SetParameter(Ruled, ruled ? 1.0 : 0.0);
 }
 
 bool LoftFeature::GetRuled() const {
-    return GetParameter("ruled") != 0.0;
+    return GetParameter(Ruled) != 0.0;
 }
 
 void LoftFeature::SetClosed(bool closed) {
-    SetParameter("closed", closed ? 1.0 : 0.0);
+    SetParameter(Closed, closed ? 1.0 : 0.0);
 }
 
 bool LoftFeature::GetClosed() const {
-    return GetParameter("closed") != 0.0;
+    return GetParameter(Closed) != 0.0;
 }
 
 cad_core::ShapePtr LoftFeature::CreateShape() const {
@@ -92,7 +121,15 @@ cad_core::ShapePtr LoftFeature::CreateShape() const {
         return nullptr;
     }
     
-    return LoftSections();
+    return FinalizeShape(LoftSections(false));
+}
+
+cad_core::ShapePtr LoftFeature::CreatePreviewShape() const {
+    if (GetSectionCount() < 2 || GetGuideCurveCount() > 0) {
+        return nullptr;
+    }
+    
+    return FinalizePreviewShape(LoftSections(true));
 }
 
 bool LoftFeature::ValidateParameters() const {
@@ -104,7 +141,13 @@ bool LoftFeature::ValidateParameters() const {
         return false;
     }
     
-    return true;
+    // 引导线还没有实现，不能悄悄忽略
+    if (GetGuideCurveCount() > 0) {
+        return false;
+    }
+    
+    std::vector<Section> sections;
+    return CollectSections(sections);
 }
 
 std::shared_ptr<cad_core::ICommand> LoftFeature::CreateCommand() const {
@@ -112,9 +155,13 @@ std::shared_ptr<cad_core::ICommand> LoftFeature::CreateCommand() const {
     return std::make_shared<cad_core::CreateSphereCommand>(5.0);
 }
 
+FeaturePtr LoftFeature::Clone() const {
+    return std::make_shared<LoftFeature>(*this);
+}
+
 bool LoftFeature::AreSectionsValid() const {
     for (const auto& section : m_sections) {
-        if (!section || section->IsEmpty()) {
+        if (!HasSketchContent(section)) {
             return false;
         }
     }
@@ -123,33 +170,143 @@ bool LoftFeature::AreSectionsValid() const {
 
 bool LoftFeature::AreGuideCurvesValid() const {
     for (const auto& guide : m_guideCurves) {
-        if (!guide || guide->IsEmpty()) {
+        if (!HasSketchContent(guide)) {
             return false;
         }
     }
     return true;
 }
 
-cad_core::ShapePtr LoftFeature::LoftSections() const {
+bool LoftFeature::CollectSections(std::vector<Section>& sections) const {
+    sections.clear();
+    for (const auto& sketch : m_sections) {
+        // 一个截面只能有一个区域，多个不相连的区域无法一一对应
+        cad_sketch::SketchProfilePtr profile = GetSketchProfile(sketch);
+        if (!profile || profile->faces.size() != 1) {
+            return false;
+        }
+        
+        const TopoDS_Face& face = profile->faces.front();
+        Section section;
+        section.outer = BRepTools::OuterWire(face);
+        std::vector<std::pair<double, TopoDS_Wire>> holes;
+        for (TopExp_Explorer explorer(face, TopAbs_WIRE); explorer.More(); explorer.Next()) {
+            const TopoDS_Wire& wire = TopoDS::Wire(explorer.Current());
+            if (!wire.IsSame(section.outer)) {
+                holes.emplace_back(std::abs(ShapeAnalysis::ContourArea(wire)), wire);
+            }
+        }
+        // 孔按面积对应到相邻截面
+        std::stable_sort(holes.begin(), holes.end(),
+                         [](const std::pair<double, TopoDS_Wire>& a, const std::pair<double, TopoDS_Wire>& b) {
+                             return a.first > b.first;
+                         });
+        for (const auto& hole : holes) {
+            section.holes.push_back(hole.second);
+        }
+        
+        if (!sections.empty() && section.holes.size() != sections.front().holes.size()) {
+            return false;
+        }
+        
+        // 草图还没有放置平面，轮廓都在 XY 平面上；相邻截面共面时放样只会得到退化的形状
+        BRepAdaptor_Surface surface(face);
+        if (surface.GetType() != GeomAbs_Plane) {
+            return false;
+        }
+        section.plane = surface.Plane();
+        if (!sections.empty()) {
+            const gp_Pln& previous = sections.back().plane;
+            if (previous.Axis().IsParallel(section.plane.Axis(), Precision::Angular()) &&
+                previous.Distance(section.plane.Location()) <= Precision::Confusion()) {
+                return false;
+            }
+        }
+        sections.push_back(std::move(section));
+    }
+    return sections.size() >= 2;
+}
+
+cad_core::ShapePtr LoftFeature::LoftSections(bool preview) const {
     if (!AreSectionsValid() || GetSectionCount() < 2) {
         return nullptr;
     }
     
+    std::vector<Section> sections;
+    if (!CollectSections(sections)) {
+        return nullptr;
+    }
+    
+    const PreviewOptions& options = GetPreviewOptions();
+    
     try {
-        // In a real implementation, this would:
-        // 1. Convert section sketches to OCCT wires
-        // 2. Optionally convert guide curves to OCCT wires
-        // 3. Use BRepOffsetAPI_ThruSections to create the lofted solid
-        // 4. Apply solid/ruled/closed parameters
+        // 预览放宽容差、不检查截面兼容性，并限制近似曲面阶次
+        auto loftWires = [&](const std::vector<TopoDS_Wire>& wires) -> TopoDS_Shape {
+            BRepOffsetAPI_ThruSections loft(GetSolid(), GetRuled(),
+                                            preview ? options.tolerance : Precision::Confusion());
+            loft.CheckCompatibility(preview ? Standard_False : Standard_True);
+            if (preview) {
+                loft.SetMaxDegree(options.maxDegree);
+            }
+            
+            // 轮廓被多个线程共享，放样前各自复制一份
+            for (const auto& wire : wires) {
+                loft.AddWire(TopoDS::Wire(BRepBuilderAPI_Copy(wire).Shape()));
+            }
+            if (GetClosed()) {
+                loft.AddWire(TopoDS::Wire(BRepBuilderAPI_Copy(wires.front()).Shape()));
+            }
+            
+            loft.Build();
+            if (!loft.IsDone()) {
+                return TopoDS_Shape();
+            }
+            return loft.Shape();
+        };
         
-        // For now, return a simple shape as placeholder
-        auto shape = std::make_shared<cad_core::Shape>();
+        std::vector<TopoDS_Wire> outers;
+        for (const auto& section : sections) {
+            outers.push_back(section.outer);
+        }
+        TopoDS_Shape result = loftWires(outers);
+        if (result.IsNull()) {
+            return nullptr;
+        }
         
-        // Placeholder: create a simple sphere-like shape
-        // In real implementation, this would properly loft between sections
+        // 预览只放样外环；正式构建把对应的孔逐个放样，实体时挖掉，曲面时一起输出
+        if (!preview) {
+            TopoDS_Compound shells;
+            BRep_Builder builder;
+            if (!GetSolid()) {
+                builder.MakeCompound(shells);
+                builder.Add(shells, result);
+            }
+            for (std::size_t hole = 0; hole < sections.front().holes.size(); ++hole) {
+                std::vector<TopoDS_Wire> wires;
+                for (const auto& section : sections) {
+                    wires.push_back(section.holes[hole]);
+                }
+                TopoDS_Shape tool = loftWires(wires);
+                if (tool.IsNull()) {
+                    return nullptr;
+                }
+                if (!GetSolid()) {
+                    builder.Add(shells, tool);
+                    continue;
+                }
+                BRepAlgoAPI_Cut cut(result, tool);
+                if (!cut.IsDone()) {
+                    return nullptr;
+                }
+                result = cut.Shape();
+            }
+            if (!GetSolid()) {
+                result = shells;
+            }
+        }
         
-        return shape;
-    } catch (...) {
+        return std::make_shared<cad_core::Shape>(result);
+    } catch (const Standard_Failure&) {
         return nullptr;
     }
 }
@@ -0,0 +1,28 @@
+﻿#include "cad_feature/ParameterSchema.h"
+#include <cassert>
+
+namespace cad_feature {
+
+ParameterSchema::ParameterSchema(std::initializer_list<ParameterInfo> parameters)
+    : m_names(parameters.size()), m_defaults(parameters.size(), 0.0) {
+    // 按索引放置，声明顺序与枚举顺序不一致也没关系
+    for (const auto& parameter : parameters) {
+        assert(parameter.index >= 0 && parameter.index < static_cast<int>(parameters.size()));
+        assert(m_names[parameter.index].empty());
+        m_names[parameter.index] = parameter.name;
+        m_defaults[parameter.index] = parameter.defaultValue;
+        m_indexByName[parameter.name] = parameter.index;
+    }
+}
+
+int ParameterSchema::FindIndex(const std::string& name) const {
+    auto it = m_indexByName.find(name);
+    return it != m_indexByName.end() ? it->second : -1;
+}
+
+const ParameterSchema& ParameterSchema::Empty() {
+    static const ParameterSchema schema({});
+    return schema;
+}
+
+} // namespace cad_feature
@@ -0,0 +1,355 @@
+﻿#include "cad_feature/PatternFeature.h"
+#include "cad_core/BooleanDifferenceCommand.h"
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRep_Builder.hxx>
+#include <BinTools.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopLoc_Location.hxx>
+#include <gp_Ax1.hxx>
+#include <gp_Ax2.hxx>
+#include <gp_Vec.hxx>
+#include <Standard_Failure.hxx>
+#include <cmath>
+#include <functional>
+#include <sstream>
+
+namespace cad_feature {
+
+const ParameterSchema& PatternFeature::Schema() {
+    static const ParameterSchema schema({
+        {Type, "pattern_type", 0.0},
+        {Direction1X, "direction1_x", 1.0},
+        {Direction1Y, "direction1_y", 0.0},
+        {Direction1Z, "direction1_z", 0.0},
+        {Spacing1, "spacing1", 10.0},
+        {Count1, "count1", 2.0},
+        {Direction2X, "direction2_x", 0.0},
+        {Direction2Y, "direction2_y", 1.0},
+        {Direction2Z, "direction2_z", 0.0},
+        {Spacing2, "spacing2", 10.0},
+        {Count2, "count2", 1.0},
+        {AxisOriginX, "axis_origin_x", 0.0},
+        {AxisOriginY, "axis_origin_y", 0.0},
+        {AxisOriginZ, "axis_origin_z", 0.0},
+        {AxisDirectionX, "axis_direction_x", 0.0},
+        {AxisDirectionY, "axis_direction_y", 0.0},
+        {AxisDirectionZ, "axis_direction_z", 1.0},
+        {CircularCount, "circular_count", 4.0},
+        {TotalAngle, "total_angle", 360.0}
+    });
+    return schema;
+}
+
+PatternFeature::PatternFeature()
+    : Feature(FeatureType::Pattern, "Pattern", Schema()), m_toolContentHash(0), m_targetContentHash(0) {
+}
+
+PatternFeature::PatternFeature(const std::string& name)
+    : Feature(FeatureType::Pattern, name, Schema()), m_toolContentHash(0), m_targetContentHash(0) {
+}
+
+void PatternFeature::SetTargetShape(const cad_core::ShapePtr& target) {
+    m_targetShape = target;
+    m_targetContentHash = ComputeContentHash(target);
+    MarkModified();
+}
+
+const cad_core::ShapePtr& PatternFeature::GetTargetShape() const {
+    return m_targetShape;
+}
+
+void PatternFeature::SetToolShape(const cad_core::ShapePtr& tool) {
+    m_toolShape = tool;
+    m_toolContentHash = ComputeContentHash(tool);
+    MarkModified();
+}
+
+const cad_core::ShapePtr& PatternFeature::GetToolShape() const {
+    return m_toolShape;
+}
+
+cad_core::ShapePtr PatternFeature::MakeHoleTool(const gp_Pnt& position, const gp_Dir& direction,
+                                                double diameter, double depth) {
+    if (diameter <= 0.0 || depth <= 0.0) {
+        return nullptr;
+    }
+    
+    try {
+        BRepPrimAPI_MakeCylinder cylinder(gp_Ax2(position, direction), diameter * 0.5, depth);
+        cylinder.Build();
+        if (cylinder.IsDone()) {
+            return std::make_shared<cad_core::Shape>(cylinder.Shape());
+        }
+    } catch (const Standard_Failure&) {
+        // 刀具创建失败
+    }
+    
+    return nullptr;
+}
+
+void PatternFeature::SetPatternType(PatternType type) {
+    SetParameter(Type, type == PatternType::Circular ? 1.0 : 0.0);
+}
+
+PatternType PatternFeature::GetPatternType() const {
+    return GetParameter(Type) != 0.0 ? PatternType::Circular : PatternType::Linear;
+}
+
+void PatternFeature::SetLinearDirection1(double x, double y, double z, double spacing, int count) {
+    SetParameter(Direction1X, x);
+    SetParameter(Direction1Y, y);
+    SetParameter(Direction1Z, z);
+    SetParameter(Spacing1, spacing);
+    SetParameter(Count1, static_cast<double>(count));
+}
+
+void PatternFeature::SetLinearDirection2(double x, double y, double z, double spacing, int count) {
+    SetParameter(Direction2X, x);
+    SetParameter(Direction2Y, y);
+    SetParameter(Direction2Z, z);
+    SetParameter(Spacing2, spacing);
+    SetParameter(Count2, static_cast<double>(count));
+}
+
+void PatternFeature::SetCircularAxis(double originX, double originY, double originZ,
+                                     double directionX, double directionY, double directionZ) {
+    SetParameter(AxisOriginX, originX);
+    SetParameter(AxisOriginY, originY);
+    SetParameter(AxisOriginZ, originZ);
+    SetParameter(AxisDirectionX, directionX);
+    SetParameter(AxisDirectionY, directionY);
+    SetParameter(AxisDirectionZ, directionZ);
+}
+
+void PatternFeature::SetCircularParameters(int count, double totalAngle) {
+    SetParameter(CircularCount, static_cast<double>(count));
+    SetParameter(TotalAngle, totalAngle);
+}
+
+int PatternFeature::GetInstanceCount() const {
+    if (GetPatternType() == PatternType::Circular) {
+        return static_cast<int>(GetParameter(CircularCount));
+    }
+    return static_cast<int>(GetParameter(Count1)) * static_cast<int>(GetParameter(Count2));
+}
+
+void PatternFeature::SetBooleanOptions(const cad_core::BooleanOptions& options) {
+    m_booleanOptions = options;
+    // 阵列切除的工具与目标真正相交，不能粘合
+    m_booleanOptions.glue = cad_core::BooleanOptions::GlueMode::Off;
+    MarkModified();
+}
+
+std::vector<gp_Trsf> PatternFeature::ComputeInstanceTransforms() const {
+    std::vector<gp_Trsf> transforms;
+    if (!ValidateParameters()) {
+        return transforms;
+    }
+    transforms.reserve(GetInstanceCount());
+    
+    if (GetPatternType() == PatternType::Linear) {
+        const gp_Dir direction1(GetParameter(Direction1X), GetParameter(Direction1Y), GetParameter(Direction1Z));
+        const gp_Dir direction2(GetParameter(Direction2X), GetParameter(Direction2Y), GetParameter(Direction2Z));
+        const gp_Vec step1 = gp_Vec(direction1) * GetParameter(Spacing1);
+        const gp_Vec step2 = gp_Vec(direction2) * GetParameter(Spacing2);
+        const int count1 = static_cast<int>(GetParameter(Count1));
+        const int count2 = static_cast<int>(GetParameter(Count2));
+        
+        for (int j = 0; j < count2; ++j) {
+            for (int i = 0; i < count1; ++i) {
+                gp_Trsf trsf;
+                trsf.SetTranslation(step1 * i + step2 * j);
+                transforms.push_back(trsf);
+            }
+        }
+    } else {
+        const gp_Ax1 axis(gp_Pnt(GetParameter(AxisOriginX), GetParameter(AxisOriginY), GetParameter(AxisOriginZ)),
+                          gp_Dir(GetParameter(AxisDirectionX), GetParameter(AxisDirectionY),
+                                 GetParameter(AxisDirectionZ)));
+        const int count = static_cast<int>(GetParameter(CircularCount));
+        const double totalAngle = GetParameter(TotalAngle);
+        
+        // 整圆时最后一个实例不能与第一个重合
+        const bool fullCircle = std::abs(std::abs(totalAngle) - 360.0) < 1.0e-9;
+        const int intervals = (fullCircle || count < 2) ? count : count - 1;
+        const double step = (totalAngle * M_PI / 180.0) / intervals;
+        
+        for (int i = 0; i < count; ++i) {
+            gp_Trsf trsf;
+            trsf.SetRotation(axis, step * i);
+            transforms.push_back(trsf);
+        }
+    }
+    
+    return transforms;
+}
+
+std::vector<cad_core::ShapePtr> PatternFeature::CreateInstances() const {
+    std::vector<cad_core::ShapePtr> instances;
+    if (!m_toolShape || m_toolShape->GetOCCTShape().IsNull()) {
+        return instances;
+    }
+    
+    // Moved 只改变位置，所有实例共享刀具的 TShape
+    const TopoDS_Shape& tool = m_toolShape->GetOCCTShape();
+    for (const auto& trsf : ComputeInstanceTransforms()) {
+        if (IsCancelled()) {
+            return {};
+        }
+        instances.push_back(std::make_shared<cad_core::Shape>(tool.Moved(TopLoc_Location(trsf))));
+    }
+    return instances;
+}
+
+cad_core::ShapePtr PatternFeature::CreateInstanceCompound() const {
+    std::vector<cad_core::ShapePtr> instances = CreateInstances();
+    if (instances.empty()) {
+        return nullptr;
+    }
+    
+    TopoDS_Compound compound;
+    BRep_Builder builder;
+    builder.MakeCompound(compound);
+    for (const auto& instance : instances) {
+        builder.Add(compound, instance->GetOCCTShape());
+    }
+    return std::make_shared<cad_core::Shape>(compound);
+}
+
+cad_core::ShapePtr PatternFeature::CreateShape() const {
+    if (!ValidateParameters()) {
+        return nullptr;
+    }
+    
+    // 没有目标时只生成实例本身
+    if (!m_targetShape || m_targetShape->GetOCCTShape().IsNull()) {
+        return CreateInstanceCompound();
+    }
+    
+    // 全部实例作为工具一次切除
+    std::vector<cad_core::ShapePtr> instances = CreateInstances();
+    if (instances.empty()) {
+        return nullptr;
+    }
+    
+    // 后台计算时把取消标志接到布尔运算的进度上，过期后中途退出
+    if (m_cancellationToken) {
+        Handle(cad_core::CancellationProgress) progress = new cad_core::CancellationProgress(m_cancellationToken);
+        return cad_core::BooleanOperations::Difference(m_targetShape, instances, m_booleanOptions,
+                                                       progress->Start());
+    }
+    return cad_core::BooleanOperations::Difference(m_targetShape, instances, m_booleanOptions);
+}
+
+cad_core::ShapePtr PatternFeature::CreatePreviewShape() const {
+    // 预览只显示实例位置，不做布尔运算
+    if (!ValidateParameters()) {
+        return nullptr;
+    }
+    return CreateInstanceCompound();
+}
+
+bool PatternFeature::ValidateParameters() const {
+    if (!m_toolShape || m_toolShape->GetOCCTShape().IsNull()) {
+        return false;
+    }
+    
+    if (GetPatternType() == PatternType::Linear) {
+        if (GetParameter(Count1) < 1.0 || GetParameter(Count2) < 1.0) {
+            return false;
+        }
+        // 多个实例时间距为0会全部重合
+        if ((GetParameter(Count1) > 1.0 && GetParameter(Spacing1) <= 0.0) ||
+            (GetParameter(Count2) > 1.0 && GetParameter(Spacing2) <= 0.0)) {
+            return false;
+        }
+        const double length1 = std::sqrt(GetParameter(Direction1X) * GetParameter(Direction1X) +
+                                         GetParameter(Direction1Y) * GetParameter(Direction1Y) +
+                                         GetParameter(Direction1Z) * GetParameter(Direction1Z));
+        const double length2 = std::sqrt(GetParameter(Direction2X) * GetParameter(Direction2X) +
+                                         GetParameter(Direction2Y) * GetParameter(Direction2Y) +
+                                         GetParameter(Direction2Z) * GetParameter(Direction2Z));
+        return length1 >= 1e-10 && length2 >= 1e-10;
+    }
+    
+    const double axisLength = std::sqrt(GetParameter(AxisDirectionX) * GetParameter(AxisDirectionX) +
+                                        GetParameter(AxisDirectionY) * GetParameter(AxisDirectionY) +
+                                        GetParameter(AxisDirectionZ) * GetParameter(AxisDirectionZ));
+    return axisLength >= 1e-10 && GetParameter(CircularCount) >= 1.0 && GetParameter(TotalAngle) != 0.0;
+}
+
+void PatternFeature::SetInputShapes(const std::vector<cad_core::ShapePtr>& shapes) {
+    if (!shapes.empty()) {
+        m_targetShape = shapes.front();
+        m_targetContentHash = 0;
+    }
+}
+
+void PatternFeature::DetachInputs() {
+    Feature::DetachInputs();
+    
+    auto copyShape = [](const cad_core::ShapePtr& shape) -> cad_core::ShapePtr {
+        if (!shape || shape->GetOCCTShape().IsNull()) {
+            return shape;
+        }
+        try {
+            BRepBuilderAPI_Copy copier(shape->GetOCCTShape(), Standard_False, Standard_False);
+            return std::make_shared<cad_core::Shape>(copier.Shape());
+        } catch (const Standard_Failure&) {
+            return nullptr;
+        }
+    };
+    // 内容不变，已算好的内容哈希仍然有效
+    m_targetShape = copyShape(m_targetShape);
+    m_toolShape = copyShape(m_toolShape);
+}
+
+std::size_t PatternFeature::ComputeContentHash(const cad_core::ShapePtr& shape) {
+    if (!shape || shape->GetOCCTShape().IsNull()) {
+        return 0;
+    }
+    
+    try {
+        // 不写三角化，否则显示时网格化过的形状会得到不同的哈希
+        std::ostringstream stream;
+        BinTools::Write(shape->GetOCCTShape(), stream, Standard_False, Standard_False,
+                        BinTools_FormatVersion_CURRENT);
+        return std::hash<std::string>()(stream.str());
+    } catch (const Standard_Failure&) {
+        // 无法序列化时退回到不可复用的键
+    }
+    return std::hash<TopoDS_Shape>()(shape->GetOCCTShape());
+}
+
+std::size_t PatternFeature::ComputeInputHash() const {
+    std::size_t seed = 0;
+    auto combine = [&seed](std::size_t value) {
+        seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    };
+    
+    combine(m_toolContentHash);
+    combine(m_targetContentHash);
+    // 并行、OBB 和历史只影响速度，不影响结果
+    combine(std::hash<double>()(m_booleanOptions.fuzzyValue));
+    combine(m_booleanOptions.simplify ? 1 : 0);
+    return seed;
+}
+
+std::shared_ptr<cad_core::ICommand> PatternFeature::CreateCommand() const {
+    // 没有目标时结果只是实例本身，没有可执行的切除
+    if (!ValidateParameters() || !m_targetShape || m_targetShape->GetOCCTShape().IsNull()) {
+        return nullptr;
+    }
+    std::vector<cad_core::ShapePtr> instances = CreateInstances();
+    if (instances.empty()) {
+        return nullptr;
+    }
+    return std::make_shared<cad_core::BooleanDifferenceCommand>(m_targetShape, instances, m_booleanOptions);
+}
+
+FeaturePtr PatternFeature::Clone() const {
+    return std::make_shared<PatternFeature>(*this);
+}
+
+} // namespace cad_feature
@@ -0,0 +1,130 @@
+﻿#include "cad_feature/ProfilerPanel.h"
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <cmath>
+
+namespace cad_feature {
+
+ProfilerPanel::ProfilerPanel(QWidget* parent) : QWidget(parent), m_profiler(nullptr) {
+    m_mainLayout = new QVBoxLayout(this);
+    
+    m_summaryLabel = new QLabel(this);
+    m_mainLayout->addWidget(m_summaryLabel);
+    
+    m_table = new QTableWidget(0, ColumnCount, this);
+    m_table->setHorizontalHeaderLabels({"特征", "类型", "总耗时(ms)", "构建(ms)", "检查(ms)",
+                                        "修复(ms)", "面数", "边数", "缓存"});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_table->setSortingEnabled(true);
+    m_table->sortByColumn(WallTimeColumn, Qt::DescendingOrder);
+    m_mainLayout->addWidget(m_table);
+    
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    m_refreshButton = new QPushButton("刷新", this);
+    m_exportButton = new QPushButton("导出JSON", this);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_refreshButton);
+    buttonLayout->addWidget(m_exportButton);
+    m_mainLayout->addLayout(buttonLayout);
+    
+    connect(m_refreshButton, &QPushButton::clicked, this, &ProfilerPanel::UpdateRecords);
+    connect(m_exportButton, &QPushButton::clicked, this, &ProfilerPanel::OnExportJson);
+    
+    setLayout(m_mainLayout);
+    UpdateRecords();
+}
+
+void ProfilerPanel::SetProfiler(const FeatureProfiler* profiler) {
+    m_profiler = profiler;
+    UpdateRecords();
+}
+
+const FeatureProfiler* ProfilerPanel::GetProfiler() const {
+    return m_profiler;
+}
+
+void ProfilerPanel::UpdateRecords() {
+    ClearRecords();
+    
+    if (!m_profiler) {
+        m_summaryLabel->setText("未启用重建分析");
+        m_exportButton->setEnabled(false);
+        return;
+    }
+    
+    std::vector<FeatureProfileRecord> records = m_profiler->GetLastRebuildRecords();
+    int computed = 0;
+    for (const auto& record : records) {
+        if (record.cacheResult == FeatureCacheResult::Computed) {
+            ++computed;
+        }
+    }
+    m_summaryLabel->setText(QString("第 %1 次重建：%2 ms，%3 个特征，重新计算 %4 个")
+                                .arg(m_profiler->GetRebuildCount())
+                                .arg(m_profiler->GetLastRebuildWallTime(), 0, 'f', 2)
+                                .arg(static_cast<int>(records.size()))
+                                .arg(computed));
+    m_exportButton->setEnabled(true);
+    
+    // 填表时关掉排序，否则每插一格行号都会变
+    m_table->setSortingEnabled(false);
+    m_table->setRowCount(static_cast<int>(records.size()));
+    for (int row = 0; row < static_cast<int>(records.size()); ++row) {
+        AddRow(row, records[row]);
+    }
+    m_table->setSortingEnabled(true);
+}
+
+void ProfilerPanel::ClearRecords() {
+    m_table->setRowCount(0);
+}
+
+void ProfilerPanel::OnExportJson() {
+    if (!m_profiler) {
+        return;
+    }
+    
+    QString path = QFileDialog::getSaveFileName(this, "导出重建分析", "rebuild_profile.json", "JSON (*.json)");
+    if (path.isEmpty()) {
+        return;
+    }
+    if (!m_profiler->ExportJson(path.toStdString())) {
+        QMessageBox::warning(this, "导出失败", "无法写入文件：" + path);
+    }
+}
+
+void ProfilerPanel::AddRow(int row, const FeatureProfileRecord& record) {
+    SetTextItem(row, NameColumn, QString::fromStdString(record.featureName));
+    SetTextItem(row, TypeColumn, FeatureProfiler::GetFeatureTypeName(record.featureType));
+    SetNumberItem(row, WallTimeColumn, record.wallTimeMs);
+    SetNumberItem(row, BuildTimeColumn, record.buildTimeMs);
+    SetNumberItem(row, ValidateTimeColumn, record.validateTimeMs);
+    SetNumberItem(row, HealTimeColumn, record.healTimeMs);
+    SetNumberItem(row, FaceColumn, record.faceCount);
+    SetNumberItem(row, EdgeColumn, record.edgeCount);
+    
+    QString cache = FeatureProfiler::GetCacheResultName(record.cacheResult);
+    if (!record.succeeded) {
+        cache += " (失败)";
+    }
+    SetTextItem(row, CacheColumn, cache);
+}
+
+void ProfilerPanel::SetTextItem(int row, int column, const QString& text) {
+    m_table->setItem(row, column, new QTableWidgetItem(text));
+}
+
+void ProfilerPanel::SetNumberItem(int row, int column, double value) {
+    QTableWidgetItem* item = new QTableWidgetItem();
+    item->setData(Qt::DisplayRole, std::round(value * 100.0) / 100.0);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    m_table->setItem(row, column, item);
+}
+
+} // namespace cad_feature
+
+#include "ProfilerPanel.moc"
@@ -1,80 +1,90 @@
 ﻿#include "cad_feature/RevolveFeature.h"
 #include "cad_core/CreateCylinderCommand.h"
 #include <BRepPrimAPI_MakeRevol.hxx>
+#include <Standard_Failure.hxx>
+#include <TopLoc_Location.hxx>
 #include <gp_Ax1.hxx>
 #include <gp_Dir.hxx>
+#include <gp_Trsf.hxx>
+#include <algorithm>
 #include <cmath>
 
 namespace cad_feature {
 
-RevolveFeature::RevolveFeature() : Feature(FeatureType::Revolve, "Revolve") {
-    SetParameter("angle", 2.0 * M_PI);
-    SetParameter("axis_x", 0.0);
-    SetParameter("axis_y", 0.0);
-    SetParameter("axis_z", 1.0);
-    SetParameter("axis_origin_x", 0.0);
-    SetParameter("axis_origin_y", 0.0);
-    SetParameter("axis_origin_z", 0.0);
-    SetParameter("midplane", 0.0);
+const ParameterSchema& RevolveFeature::Schema() {
+    static const ParameterSchema schema({
+        {Angle, "angle", 2.0 * M_PI},
+        {AxisX, "axis_x", 0.0},
+        {AxisY, "axis_y", 0.0},
+        {AxisZ, "axis_z", 1.0},
+        {AxisOriginX, "axis_origin_x", 0.0},
+        {AxisOriginY, "axis_origin_y", 0.0},
+        {AxisOriginZ, "axis_origin_z", 0.0},
+        {Midplane, "midplane", 0.0}
+    });
+    return schema;
 }
 
-RevolveFeature::RevolveFeature(const std::string& name) : Feature(FeatureType::Revolve, name) {
-    SetParameter("angle", 2.0 * M_PI);
-    SetParameter("axis_x", 0.0);
-    SetParameter("axis_y", 0.0);
-    SetParameter("axis_z", 1.0);
-    SetParameter("axis_origin_x", 0.0);
-    SetParameter("axis_origin_y", 0.0);
-    SetParameter("axis_origin_z", 0.0);
-    SetParameter("midplane", 0.0);
+RevolveFeature::RevolveFeature() : Feature(FeatureType::Revolve, "Revolve", Schema()) {
+}
+
+RevolveFeature::RevolveFeature(const std::string& name) : Feature(FeatureType::Revolve, name, Schema()) {
 }
 
 void RevolveFeature::SetSketch(const cad_sketch::SketchPtr& sketch) {
     m_sketch = sketch;
+    MarkModified();
 }
 
 const cad_sketch::SketchPtr& RevolveFeature::GetSketch() const {
     return m_sketch;
 }
 
+std::vector<cad_sketch::SketchPtr> RevolveFeature::GetInputSketches() const {
+    if (m_sketch) {
+        return {m_sketch};
+    }
+    return {};
+}
+
 void RevolveFeature::SetAngle(double angle) {
-    SetParameter("angle", angle);
+    SetParameter(Angle, angle);
 }
 
 double RevolveFeature::GetAngle() const {
-    return GetParameter("angle");
+    return GetParameter(Angle);
 }
 
 void RevolveFeature::SetAxis(double x, double y, double z) {
-    SetParameter("axis_x", x);
-    SetParameter("axis_y", y);
-    SetParameter("axis_z", z);
+    SetParameter(AxisX, x);
+    SetParameter(AxisY, y);
+    SetParameter(AxisZ, z);
 }
 
 void RevolveFeature::GetAxis(double& x, double& y, double& z) const {
-    x = GetParameter("axis_x");
-    y = GetParameter("axis_y");
-    z = GetParameter("axis_z");
+    x = GetParameter(AxisX);
+    y = GetParameter(AxisY);
+    z = GetParameter(AxisZ);
 }
 
 void RevolveFeature::SetAxisOrigin(double x, double y, double z) {
-    SetParameter("axis_origin_x", x);
-    SetParameter("axis_origin_y", y);
-    SetParameter("axis_origin_z", z);
+    SetParameter(AxisOriginX, x);
+    SetParameter(AxisOriginY, y);
+    SetParameter(AxisOriginZ, z);
 }
 
 void RevolveFeature::GetAxisOrigin(double& x, double& y, double& z) const {
-    x = GetParameter("axis_origin_x");
-    y = GetParameter("axis_origin_y");
-    z = GetParameter("axis_origin_z");
+    x = GetParameter(AxisOriginX);
+    y = GetParameter(AxisOriginY);
+    z = GetParameter(AxisOriginZ);
 }
 
 void RevolveFeature::SetMidplane(bool midplane) {
-    SetParameter("midplane", midplane ? 1.0 : 0.0);
+    SetParameter(Midplane, midplane ? 1.0 : 0.0);
 }
 
 bool RevolveFeature::GetMidplane() const {
-    return GetParameter("midplane") != 0.0;
+    return GetParameter(Midplane) != 0.0;
 }
 
 cad_core::ShapePtr RevolveFeature::CreateShape() const {
@@ -82,7 +92,15 @@ cad_core::ShapePtr RevolveFeature::CreateShape() const {
         return nullptr;
     }
     
-    return RevolveSketch();
+    return FinalizeShape(RevolveSketch());
+}
+
+cad_core::ShapePtr RevolveFeature::CreatePreviewShape() const {
+    if (!IsSketchValid() || GetAngle() == 0.0) {
+        return nullptr;
+    }
+    
+    return FinalizePreviewShape(RevolveSketch());
 }
 
 bool RevolveFeature::ValidateParameters() const {
@@ -110,8 +128,12 @@ std::shared_ptr<cad_core::ICommand> RevolveFeature::CreateCommand() const {
     return std::make_shared<cad_core::CreateCylinderCommand>(5.0, 10.0);
 }
 
+FeaturePtr RevolveFeature::Clone() const {
+    return std::make_shared<RevolveFeature>(*this);
+}
+
 bool RevolveFeature::IsSketchValid() const {
-    return m_sketch && !m_sketch->IsEmpty();
+    return HasSketchContent(m_sketch);
 }
 
 cad_core::ShapePtr RevolveFeature::RevolveSketch() const {
@@ -119,20 +141,39 @@ cad_core::ShapePtr RevolveFeature::RevolveSketch() const {
         return nullptr;
     }
     
+    cad_sketch::SketchProfilePtr profile = GetSketchProfile(m_sketch);
+    if (!profile || !profile->HasFaces()) {
+        return nullptr;
+    }
+    
+    double ax, ay, az, ox, oy, oz;
+    GetAxis(ax, ay, az);
+    GetAxisOrigin(ox, oy, oz);
+    if (std::sqrt(ax*ax + ay*ay + az*az) < 1e-10) {
+        return nullptr;
+    }
+    
+    // 预览跳过了参数验证，这里把角度限制在一整圈以内
+    double angle = std::max(-2.0 * M_PI, std::min(2.0 * M_PI, GetAngle()));
+    
     try {
-        // In a real implementation, this would:
-        // 1. Convert sketch elements to OCCT wire/face
-        // 2. Create revolution axis from origin and direction
-        // 3. Use BRepPrimAPI_MakeRevol to create the solid
-        
-        // For now, return a simple shape as placeholder
-        auto shape = std::make_shared<cad_core::Shape>();
+        gp_Ax1 axis(gp_Pnt(ox, oy, oz), gp_Dir(ax, ay, az));
         
-        // Placeholder: create a simple cylinder-like shape
-        // In real implementation, this would properly revolve the sketch
+        TopoDS_Shape base = profile->faceCompound;
+        if (GetMidplane()) {
+            gp_Trsf rotation;
+            rotation.SetRotation(axis, -0.5 * angle);
+            base = base.Moved(TopLoc_Location(rotation));
+        }
         
-        return shape;
-    } catch (...) {
+        // 轮廓被多个线程共享，让 MakeRevol 复制底面而不是直接引用
+        // 旋转是解析曲面，没有近似步骤，预览和正式构建走同一条路
+        BRepPrimAPI_MakeRevol revol(base, axis, angle, Standard_True);
+        if (!revol.IsDone()) {
+            return nullptr;
+        }
+        return std::make_shared<cad_core::Shape>(revol.Shape());
+    } catch (const Standard_Failure&) {
         return nullptr;
     }
 }
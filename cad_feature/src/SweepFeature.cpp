@@ -1,24 +1,39 @@
 ﻿#include "cad_feature/SweepFeature.h"
 #include "cad_core/CreateBoxCommand.h"
-#include <BRepOffsetAPI_MakePipe.hxx>
+#include <BRepAlgoAPI_Cut.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepOffsetAPI_MakePipeShell.hxx>
+#include <BRepTools.hxx>
+#include <BRep_Builder.hxx>
+#include <Law_Linear.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopoDS_Iterator.hxx>
+#include <gp_Ax2.hxx>
 #include <cmath>
 
 namespace cad_feature {
 
-SweepFeature::SweepFeature() : Feature(FeatureType::Sweep, "Sweep") {
-    SetParameter("twist_angle", 0.0);
-    SetParameter("scale_factor", 1.0);
-    SetParameter("keep_orientation", 1.0);
+const ParameterSchema& SweepFeature::Schema() {
+    static const ParameterSchema schema({
+        {TwistAngle, "twist_angle", 0.0},
+        {ScaleFactor, "scale_factor", 1.0},
+        {KeepOrientation, "keep_orientation", 1.0}
+    });
+    return schema;
 }
 
-SweepFeature::SweepFeature(const std::string& name) : Feature(FeatureType::Sweep, name) {
-    SetParameter("twist_angle", 0.0);
-    SetParameter("scale_factor", 1.0);
-    SetParameter("keep_orientation", 1.0);
+SweepFeature::SweepFeature() : Feature(FeatureType::Sweep, "Sweep", Schema()) {
+}
+
+SweepFeature::SweepFeature(const std::string& name) : Feature(FeatureType::Sweep, name, Schema()) {
 }
 
 void SweepFeature::SetProfile(const cad_sketch::SketchPtr& profile) {
     m_profile = profile;
+    MarkModified();
 }
 
 const cad_sketch::SketchPtr& SweepFeature::GetProfile() const {
@@ -27,34 +42,46 @@ const cad_sketch::SketchPtr& SweepFeature::GetProfile() const {
 
 void SweepFeature::SetPath(const cad_sketch::SketchPtr& path) {
     m_path = path;
+    MarkModified();
 }
 
 const cad_sketch::SketchPtr& SweepFeature::GetPath() const {
     return m_path;
 }
 
+std::vector<cad_sketch::SketchPtr> SweepFeature::GetInputSketches() const {
+    std::vector<cad_sketch::SketchPtr> sketches;
+    if (m_profile) {
+        sketches.push_back(m_profile);
+    }
+    if (m_path) {
+        sketches.push_back(m_path);
+    }
+    return sketches;
+}
+
 void SweepFeature::SetTwistAngle(double angle) {
-    SetParameter("twist_angle", angle);
+    SetParameter(TwistAngle, angle);
 }
 
 double SweepFeature::GetTwistAngle() const {
-    return GetParameter("twist_angle");
+    return GetParameter(TwistAngle);
 }
 
 void SweepFeature::SetScaleFactor(double factor) {
-    SetParameter("scale_factor", factor);
+    SetParameter(ScaleFactor, factor);
 }
 
 double SweepFeature::GetScaleFactor() const {
-    return GetParameter("scale_factor");
+    return GetParameter(ScaleFactor);
 }
 
 void SweepFeature::SetKeepOriginalOrientation(bool keep) {
-    SetParameter("keep_orientation", keep ? 1.0 : 0.0);
+    SetParameter(KeepOrientation, keep ? 1.0 : 0.0);
 }
 
 bool SweepFeature::GetKeepOriginalOrientation() const {
-    return GetParameter("keep_orientation") != 0.0;
+    return GetParameter(KeepOrientation) != 0.0;
 }
 
 cad_core::ShapePtr SweepFeature::CreateShape() const {
@@ -62,7 +89,15 @@ cad_core::ShapePtr SweepFeature::CreateShape() const {
         return nullptr;
     }
     
-    return SweepProfile();
+    return FinalizeShape(SweepProfile(false));
+}
+
+cad_core::ShapePtr SweepFeature::CreatePreviewShape() const {
+    if (!IsProfileValid() || !IsPathValid() || GetTwistAngle() != 0.0) {
+        return nullptr;
+    }
+    
+    return FinalizePreviewShape(SweepProfile(true));
 }
 
 bool SweepFeature::ValidateParameters() const {
@@ -75,6 +110,11 @@ bool SweepFeature::ValidateParameters() const {
         return false;
     }
     
+    // 扭转角还没有实现，不能悄悄忽略
+    if (GetTwistAngle() != 0.0) {
+        return false;
+    }
+    
     return true;
 }
 
@@ -83,34 +123,104 @@ std::shared_ptr<cad_core::ICommand> SweepFeature::CreateCommand() const {
     return std::make_shared<cad_core::CreateBoxCommand>(10.0, 10.0, 10.0);
 }
 
+FeaturePtr SweepFeature::Clone() const {
+    return std::make_shared<SweepFeature>(*this);
+}
+
 bool SweepFeature::IsProfileValid() const {
-    return m_profile && !m_profile->IsEmpty();
+    return HasSketchContent(m_profile);
 }
 
 bool SweepFeature::IsPathValid() const {
-    return m_path && !m_path->IsEmpty();
+    return HasSketchContent(m_path);
 }
 
-cad_core::ShapePtr SweepFeature::SweepProfile() const {
+cad_core::ShapePtr SweepFeature::SweepProfile(bool preview) const {
     if (!IsProfileValid() || !IsPathValid()) {
         return nullptr;
     }
     
+    cad_sketch::SketchProfilePtr profile = GetSketchProfile(m_profile);
+    cad_sketch::SketchProfilePtr path = GetSketchProfile(m_path);
+    if (!profile || !profile->HasFaces() || !path || !path->HasWires()) {
+        return nullptr;
+    }
+    
+    const PreviewOptions& options = GetPreviewOptions();
+    double scaleFactor = GetScaleFactor();
+    
     try {
-        // In a real implementation, this would:
-        // 1. Convert profile sketch to OCCT wire/face
-        // 2. Convert path sketch to OCCT wire
-        // 3. Use BRepOffsetAPI_MakePipe to create the swept solid
-        // 4. Apply twist and scaling if specified
+        // 路径优先用开放的链，没有的话用最大的闭合环
+        const TopoDS_Wire& pathWire = path->openWires.empty() ? path->closedWires.front() : path->openWires.front();
+        TopoDS_Wire spine = TopoDS::Wire(BRepBuilderAPI_Copy(pathWire).Shape());
         
-        // For now, return a simple shape as placeholder
-        auto shape = std::make_shared<cad_core::Shape>();
+        // 沿路径扫一个环并封成实体；轮廓贴到路径起点并转到法向
+        auto sweepWire = [&](const TopoDS_Wire& wire) -> TopoDS_Shape {
+            BRepOffsetAPI_MakePipeShell pipe(spine);
+            if (GetKeepOriginalOrientation()) {
+                pipe.SetMode(gp_Ax2(gp::Origin(), gp::DZ(), gp::DX()));
+            }
+            if (preview) {
+                pipe.SetTolerance(options.tolerance, options.tolerance);
+                pipe.SetMaxDegree(options.maxDegree);
+                pipe.SetMaxSegments(options.maxSegments);
+            }
+            
+            TopoDS_Wire section = TopoDS::Wire(BRepBuilderAPI_Copy(wire).Shape());
+            if (std::abs(scaleFactor - 1.0) > 1e-10) {
+                Handle(Law_Linear) law = new Law_Linear();
+                law->Set(0.0, 1.0, 1.0, scaleFactor);
+                pipe.SetLaw(section, law, Standard_True, Standard_True);
+            } else {
+                pipe.Add(section, Standard_True, Standard_True);
+            }
+            
+            pipe.Build();
+            if (!pipe.IsDone() || !pipe.MakeSolid()) {
+                return TopoDS_Shape();
+            }
+            return pipe.Shape();
+        };
         
-        // Placeholder: create a simple box-like shape
-        // In real implementation, this would properly sweep the profile along the path
+        // 每个面分别扫掠，结果放进一个复合体；任何一个面失败整个特征失败。
+        // 预览只扫外环，正式构建再把孔挖掉
+        TopoDS_Compound result;
+        BRep_Builder builder;
+        builder.MakeCompound(result);
+        for (const auto& face : profile->faces) {
+            TopoDS_Wire outerWire = BRepTools::OuterWire(face);
+            TopoDS_Shape body = sweepWire(outerWire);
+            if (body.IsNull()) {
+                return nullptr;
+            }
+            
+            if (!preview) {
+                for (TopExp_Explorer explorer(face, TopAbs_WIRE); explorer.More(); explorer.Next()) {
+                    const TopoDS_Wire& hole = TopoDS::Wire(explorer.Current());
+                    if (hole.IsSame(outerWire)) {
+                        continue;
+                    }
+                    TopoDS_Shape tool = sweepWire(hole);
+                    if (tool.IsNull()) {
+                        return nullptr;
+                    }
+                    BRepAlgoAPI_Cut cut(body, tool);
+                    if (!cut.IsDone()) {
+                        return nullptr;
+                    }
+                    body = cut.Shape();
+                }
+            }
+            builder.Add(result, body);
+        }
         
-        return shape;
-    } catch (...) {
+        // 只有一个面时直接返回实体
+        if (profile->faces.size() == 1) {
+            TopoDS_Iterator first(result);
+            return std::make_shared<cad_core::Shape>(first.Value());
+        }
+        return std::make_shared<cad_core::Shape>(result);
+    } catch (const Standard_Failure&) {
         return nullptr;
     }
 }
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "SketchElement.h"
+#include "cad_core/Point.h"
+#include <vector>
+
+namespace cad_sketch {
+
+// 环上的一段边，start -> end 的走向就是环的走向
+struct LoopEdge {
+    int elementId = -1;          // 来源草图元素
+    bool isArc = false;
+    cad_core::Point start;
+    cad_core::Point end;
+    cad_core::Point center;      // 以下仅圆弧有效
+    double radius = 0.0;
+    double startAngle = 0.0;     // start 处的极角
+    double sweep = 0.0;          // 带符号，正为逆时针
+};
+
+struct RegionLoop {
+    std::vector<LoopEdge> edges;
+    double area = 0.0;           // 带符号面积，外环逆时针为正，孔顺时针为负
+};
+
+// 平面划分中的一个有界面
+struct Region {
+    RegionLoop outer;
+    std::vector<RegionLoop> inners;
+    double area = 0.0;           // 外环面积减去孔的面积
+    int depth = 0;               // 外面套了几层区域，偶数层组成实体轮廓，奇数层是孔
+};
+
+struct RegionSet {
+    std::vector<Region> regions;           // 按外环面积从大到小
+    std::vector<LoopEdge> danglingEdges;   // 不围成任何区域的边，可用作扫掠路径
+};
+
+// 草图闭合区域查找
+// 端点用空间哈希合并，交点用扫描线求，再在平面图上沿半边走出每个面，
+// 整体接近 O(n log n)，几万条线段的导入草图也能用
+class RegionFinder {
+public:
+    explicit RegionFinder(double tolerance = 1.0e-6);
+    ~RegionFinder() = default;
+
+    void SetTolerance(double tolerance);
+    double GetTolerance() const;
+
+    RegionSet Find(const std::vector<SketchElementPtr>& elements) const;
+
+private:
+    double m_tolerance;
+};
+
+} // namespace cad_sketch
@@ -23,6 +23,8 @@
 #include "SketchArc.h"       // 弧元素 - 圆的一部分，但同样精彩
 #include "Constraint.h"      // 约束基类 - 几何关系的守护者
 #include "ConstraintSolver.h" // 约束求解器 - 让几何关系保持和谐的魔法师
+#include "SketchProfile.h"   // 轮廓构建 - 把线条变成能拉伸的面
+#include <mutex>             // 互斥锁 - 轮廓缓存可能被多个线程同时读取
 #include <vector>            // 动态数组 - 容器界的万金油
 #include <memory>            // 智能指针 - 内存管理的得力助手
 #include <string>            // 字符串 - 人机交流的桥梁
@@ -174,6 +176,46 @@ public:
      * @return 约束的总数
      */
     int GetConstraintCount() const;
+    
+    // ========== 版本跟踪 - 让特征知道草图"变过心" ==========
+    
+    /** 
+     * 获取版本号 - 增删元素/约束或求解后都会加一
+     * 依赖这个草图的特征靠它判断是否需要重建
+     * @return 当前版本号
+     */
+    unsigned long GetVersion() const;
+    
+    /** 
+     * 标记已修改 - 直接改动元素坐标时草图不知道，需要手动告诉它
+     */
+    void MarkModified();
+    
+    /** 
+     * 计算内容哈希 - 只看几何和约束，不看版本号
+     * 重新打开文档后版本号会变，但内容不变时哈希不变，可用于磁盘缓存
+     * @return 草图内容的哈希值
+     */
+    std::size_t ComputeContentHash() const;
+    
+    /** 
+     * 计算几何哈希 - 只看元素几何，不看约束
+     * 加减约束不改变形状，轮廓缓存用它判断是否真的需要重建
+     * @return 元素几何的哈希值
+     */
+    std::size_t ComputeGeometryHash() const;
+    
+    // ========== 轮廓 - 从"线稿"到"面片" ==========
+    
+    /** 
+     * 获取轮廓 - 线、弧、圆转成OCCT的边，串成线框，内环嵌套成孔
+     * 结果缓存在草图上，每次调用都核对几何哈希，只有元素几何变了才会重建
+     * （直接通过元素的 setter 修改也能发现），
+     * 同一个草图反复拉伸预览时直接复用，不用每次都重新拼拓扑
+     * 可以在工作线程上调用；返回的拓扑是共享的，修改前请先复制
+     * @return 轮廓，构建失败时返回nullptr
+     */
+    SketchProfilePtr GetProfile() const;
 
 private:
     /** 草图名称 - 这幅"作品"的标题 */
@@ -187,6 +229,15 @@ private:
     
     /** 约束求解器 - 负责调解元素关系的"和事佬" */
     ConstraintSolver m_solver;
+    
+    /** 版本号 - 草图内容的修改计数 */
+    unsigned long m_version;
+    
+    /** 轮廓缓存 - 连同构建时的几何哈希一起记下 */
+    mutable std::mutex m_profileMutex;
+    mutable SketchProfilePtr m_profile;
+    mutable std::size_t m_profileHash;
+    mutable bool m_profileValid;
 };
 
 /** 草图智能指针类型别名 - 让内存管理变得轻松愉快 */
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "SketchElement.h"
+#include <TopoDS_Compound.hxx>
+#include <TopoDS_Face.hxx>
+#include <TopoDS_Wire.hxx>
+#include <memory>
+#include <vector>
+
+namespace cad_sketch {
+
+// 草图转换出的OCCT拓扑，位于XY平面（z = 0）
+struct SketchProfile {
+    std::vector<TopoDS_Wire> closedWires;   // 所有区域的外环，按面积从大到小
+    std::vector<TopoDS_Wire> openWires;     // 不围成区域的边串成的链，可作为扫掠路径
+    std::vector<TopoDS_Face> faces;         // 偶数层区域：外环 + 嵌套在其中的孔
+    TopoDS_Compound faceCompound;           // faces 的复合体，方便直接拉伸/旋转
+
+    bool HasFaces() const { return !faces.empty(); }
+    bool HasWires() const { return !closedWires.empty() || !openWires.empty(); }
+};
+
+using SketchProfilePtr = std::shared_ptr<const SketchProfile>;
+
+// 草图元素 -> 闭合区域（RegionFinder）-> 线框 -> 带孔的面
+class ProfileBuilder {
+public:
+    // 端点距离小于 tolerance 视为相连
+    static constexpr double DefaultTolerance = 1.0e-6;
+
+    static SketchProfilePtr Build(const std::vector<SketchElementPtr>& elements,
+                                  double tolerance = DefaultTolerance);
+};
+
+} // namespace cad_sketch
@@ -0,0 +1,866 @@
+﻿#include "cad_sketch/RegionFinder.h"
+#include "cad_sketch/SketchLine.h"
+#include "cad_sketch/SketchCircle.h"
+#include "cad_sketch/SketchArc.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+
+namespace cad_sketch {
+
+namespace {
+
+const double TwoPi = 2.0 * M_PI;
+
+struct Vec2 {
+    double x = 0.0;
+    double y = 0.0;
+};
+
+Vec2 operator+(const Vec2& a, const Vec2& b) { return {a.x + b.x, a.y + b.y}; }
+Vec2 operator-(const Vec2& a, const Vec2& b) { return {a.x - b.x, a.y - b.y}; }
+Vec2 operator*(const Vec2& a, double s) { return {a.x * s, a.y * s}; }
+double Dot(const Vec2& a, const Vec2& b) { return a.x * b.x + a.y * b.y; }
+double Cross(const Vec2& a, const Vec2& b) { return a.x * b.y - a.y * b.x; }
+double Length(const Vec2& a) { return std::sqrt(Dot(a, a)); }
+
+double NormalizeAngle(double angle) {
+    angle = std::fmod(angle, TwoPi);
+    return angle < 0.0 ? angle + TwoPi : angle;
+}
+
+// 输入曲线：线段，或从 startAngle 逆时针扫过 sweep 的圆弧
+// 参数：线段为 [0, 1]，圆弧为相对起点的角度 [0, sweep]
+struct Curve {
+    int elementId = -1;
+    bool isArc = false;
+    Vec2 a, b;
+    Vec2 center;
+    double radius = 0.0;
+    double startAngle = 0.0;
+    double sweep = 0.0;
+    double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0;
+    std::vector<double> splits;
+
+    double EndParam() const { return isArc ? sweep : 1.0; }
+    double Scale() const { return isArc ? radius : Length(b - a); }
+
+    Vec2 PointAt(double param) const {
+        if (!isArc) {
+            return a + (b - a) * param;
+        }
+        double angle = startAngle + param;
+        return {center.x + radius * std::cos(angle), center.y + radius * std::sin(angle)};
+    }
+
+    // 点到参数的投影，调用方保证点在曲线所在的直线/圆上
+    double ParamOf(const Vec2& p, double tolerance) const {
+        if (!isArc) {
+            Vec2 d = b - a;
+            return Dot(p - a, d) / Dot(d, d);
+        }
+        double offset = NormalizeAngle(std::atan2(p.y - center.y, p.x - center.x) - startAngle);
+        if (offset > sweep && (TwoPi - offset) * radius <= tolerance) {
+            return 0.0;
+        }
+        return offset;
+    }
+
+    void ComputeBounds() {
+        if (!isArc) {
+            minX = std::min(a.x, b.x); maxX = std::max(a.x, b.x);
+            minY = std::min(a.y, b.y); maxY = std::max(a.y, b.y);
+            return;
+        }
+        Vec2 start = PointAt(0.0), end = PointAt(sweep);
+        minX = std::min(start.x, end.x); maxX = std::max(start.x, end.x);
+        minY = std::min(start.y, end.y); maxY = std::max(start.y, end.y);
+        // 扫过坐标轴方向时包围盒要扩到圆上的极值点
+        for (int quadrant = 0; quadrant < 4; ++quadrant) {
+            double angle = quadrant * 0.5 * M_PI;
+            if (NormalizeAngle(angle - startAngle) <= sweep) {
+                Vec2 p = PointAt(NormalizeAngle(angle - startAngle));
+                minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+                minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+            }
+        }
+    }
+};
+
+std::vector<Curve> CollectCurves(const std::vector<SketchElementPtr>& elements, double tolerance) {
+    std::vector<Curve> curves;
+    curves.reserve(elements.size());
+    
+    for (const auto& element : elements) {
+        Curve curve;
+        curve.elementId = element->GetId();
+        switch (element->GetType()) {
+            case SketchElementType::Line: {
+                auto line = std::static_pointer_cast<SketchLine>(element);
+                if (!line->GetStartPoint() || !line->GetEndPoint() || line->GetLength() <= tolerance) {
+                    continue;
+                }
+                curve.a = {line->GetStartPoint()->GetX(), line->GetStartPoint()->GetY()};
+                curve.b = {line->GetEndPoint()->GetX(), line->GetEndPoint()->GetY()};
+                break;
+            }
+            case SketchElementType::Circle: {
+                auto circle = std::static_pointer_cast<SketchCircle>(element);
+                if (!circle->GetCenter() || circle->GetRadius() <= tolerance) {
+                    continue;
+                }
+                curve.isArc = true;
+                curve.center = {circle->GetCenter()->GetX(), circle->GetCenter()->GetY()};
+                curve.radius = circle->GetRadius();
+                curve.sweep = TwoPi;
+                break;
+            }
+            case SketchElementType::Arc: {
+                auto arc = std::static_pointer_cast<SketchArc>(element);
+                if (!arc->GetCenter() || arc->GetRadius() <= tolerance || arc->GetLength() <= tolerance) {
+                    continue;
+                }
+                curve.isArc = true;
+                curve.center = {arc->GetCenter()->GetX(), arc->GetCenter()->GetY()};
+                curve.radius = arc->GetRadius();
+                curve.startAngle = NormalizeAngle(arc->GetStartAngle());
+                curve.sweep = arc->GetSweepAngle();
+                if ((TwoPi - curve.sweep) * curve.radius <= tolerance) {
+                    curve.sweep = TwoPi;
+                }
+                break;
+            }
+            case SketchElementType::Point:
+                continue;
+        }
+        curve.ComputeBounds();
+        curves.push_back(curve);
+    }
+    return curves;
+}
+
+// ========== 交点 ==========
+
+void AddSplit(Curve& curve, const Vec2& p, double tolerance) {
+    double param = curve.ParamOf(p, tolerance);
+    double slack = tolerance / curve.Scale();
+    if (param >= -slack && param <= curve.EndParam() + slack) {
+        curve.splits.push_back(std::max(0.0, std::min(curve.EndParam(), param)));
+    }
+}
+
+void IntersectLines(Curve& c1, Curve& c2, double tolerance) {
+    Vec2 d1 = c1.b - c1.a, d2 = c2.b - c2.a;
+    double denom = Cross(d1, d2);
+    if (std::abs(denom) <= 1e-12 * Length(d1) * Length(d2)) {
+        // 共线重叠：互相把端点加为分割点
+        if (std::abs(Cross(c2.a - c1.a, d1)) / Length(d1) <= tolerance) {
+            AddSplit(c1, c2.a, tolerance);
+            AddSplit(c1, c2.b, tolerance);
+            AddSplit(c2, c1.a, tolerance);
+            AddSplit(c2, c1.b, tolerance);
+        }
+        return;
+    }
+    double t = Cross(c2.a - c1.a, d2) / denom;
+    Vec2 p = c1.a + d1 * t;
+    std::size_t before1 = c1.splits.size(), before2 = c2.splits.size();
+    AddSplit(c1, p, tolerance);
+    AddSplit(c2, p, tolerance);
+    // 交点必须同时落在两条线段上
+    if (c1.splits.size() == before1 || c2.splits.size() == before2) {
+        c1.splits.resize(before1);
+        c2.splits.resize(before2);
+    }
+}
+
+void IntersectLineArc(Curve& line, Curve& arc, double tolerance) {
+    Vec2 d = line.b - line.a;
+    Vec2 f = line.a - arc.center;
+    double A = Dot(d, d);
+    double B = 2.0 * Dot(d, f);
+    double C = Dot(f, f) - arc.radius * arc.radius;
+    double disc = B * B - 4.0 * A * C;
+    
+    std::vector<double> roots;
+    if (disc < 0.0) {
+        // 容差内相切
+        double distance = std::abs(Cross(arc.center - line.a, d)) / std::sqrt(A);
+        if (distance - arc.radius <= tolerance) {
+            roots.push_back(-B / (2.0 * A));
+        }
+    } else {
+        double s = std::sqrt(disc);
+        roots.push_back((-B - s) / (2.0 * A));
+        roots.push_back((-B + s) / (2.0 * A));
+    }
+    
+    for (double t : roots) {
+        Vec2 p = line.a + d * t;
+        // 切点在圆外一点点，推回圆上再求角度
+        Vec2 radial = p - arc.center;
+        double length = Length(radial);
+        if (length > 0.0) {
+            p = arc.center + radial * (arc.radius / length);
+        }
+        double slack = tolerance / std::sqrt(A);
+        if (t < -slack || t > 1.0 + slack) {
+            continue;
+        }
+        std::size_t before = arc.splits.size();
+        AddSplit(arc, p, tolerance);
+        if (arc.splits.size() != before) {
+            line.splits.push_back(std::max(0.0, std::min(1.0, t)));
+        }
+    }
+}
+
+void IntersectArcs(Curve& c1, Curve& c2, double tolerance) {
+    Vec2 delta = c2.center - c1.center;
+    double d = Length(delta);
+    if (d <= tolerance) {
+        // 同一个圆上的两段弧：互相把端点加为分割点
+        if (std::abs(c1.radius - c2.radius) <= tolerance) {
+            AddSplit(c1, c2.PointAt(0.0), tolerance);
+            AddSplit(c1, c2.PointAt(c2.sweep), tolerance);
+            AddSplit(c2, c1.PointAt(0.0), tolerance);
+            AddSplit(c2, c1.PointAt(c1.sweep), tolerance);
+        }
+        return;
+    }
+    if (d > c1.radius + c2.radius + tolerance || d < std::abs(c1.radius - c2.radius) - tolerance) {
+        return;
+    }
+    
+    double a = (d * d + c1.radius * c1.radius - c2.radius * c2.radius) / (2.0 * d);
+    double h2 = c1.radius * c1.radius - a * a;
+    double h = h2 > 0.0 ? std::sqrt(h2) : 0.0;
+    Vec2 unit = delta * (1.0 / d);
+    Vec2 base = c1.center + unit * a;
+    Vec2 normal = {-unit.y, unit.x};
+    
+    std::vector<Vec2> points = {base + normal * h};
+    if (h > tolerance) {
+        points.push_back(base - normal * h);
+    }
+    for (const auto& p : points) {
+        std::size_t before1 = c1.splits.size(), before2 = c2.splits.size();
+        AddSplit(c1, p, tolerance);
+        AddSplit(c2, p, tolerance);
+        // 只落在其中一段弧上的交点不算
+        if (c1.splits.size() == before1 || c2.splits.size() == before2) {
+            c1.splits.resize(before1);
+            c2.splits.resize(before2);
+        }
+    }
+}
+
+void Intersect(Curve& c1, Curve& c2, double tolerance) {
+    if (!c1.isArc && !c2.isArc) {
+        IntersectLines(c1, c2, tolerance);
+    } else if (!c1.isArc) {
+        IntersectLineArc(c1, c2, tolerance);
+    } else if (!c2.isArc) {
+        IntersectLineArc(c2, c1, tolerance);
+    } else {
+        IntersectArcs(c1, c2, tolerance);
+    }
+}
+
+// 扫描线的活动集合按高度分级：同一级内曲线高度相差不到一倍，按 minY 排序。
+// 查询时每一级只向下扩本级的最大高度，一条很高的曲线只影响它所在的那一级，
+// 不会把所有查询的 y 窗口都撑大
+struct HeightBucket {
+    double maxHeight = 0.0;
+    std::set<std::pair<double, int>> byMinY;
+};
+
+int HeightClass(double height) {
+    return height > 0.0 ? std::ilogb(height) : std::numeric_limits<int>::min();
+}
+
+// 扫描线：按 minX 依次进入，活动集合按 maxX 排序以便及时移出；
+// 各高度级内只在 y 窗口内找候选，x、y 区间都重叠才做精确求交
+void ComputeIntersections(std::vector<Curve>& curves, double tolerance) {
+    std::vector<int> order(curves.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&curves](int a, int b) {
+        return curves[a].minX < curves[b].minX;
+    });
+    
+    std::set<std::pair<double, int>> byMaxX;
+    std::map<int, HeightBucket> buckets;
+    for (int index : order) {
+        Curve& curve = curves[index];
+        while (!byMaxX.empty() && byMaxX.begin()->first < curve.minX - tolerance) {
+            const Curve& expired = curves[byMaxX.begin()->second];
+            auto bucket = buckets.find(HeightClass(expired.maxY - expired.minY));
+            bucket->second.byMinY.erase({expired.minY, byMaxX.begin()->second});
+            if (bucket->second.byMinY.empty()) {
+                buckets.erase(bucket);
+            }
+            byMaxX.erase(byMaxX.begin());
+        }
+        
+        for (auto& entry : buckets) {
+            HeightBucket& bucket = entry.second;
+            auto it = bucket.byMinY.lower_bound({curve.minY - bucket.maxHeight - tolerance, -1});
+            for (; it != bucket.byMinY.end() && it->first <= curve.maxY + tolerance; ++it) {
+                Curve& other = curves[it->second];
+                if (other.maxY >= curve.minY - tolerance) {
+                    Intersect(curve, other, tolerance);
+                }
+            }
+        }
+        
+        const double height = curve.maxY - curve.minY;
+        HeightBucket& bucket = buckets[HeightClass(height)];
+        bucket.maxHeight = std::max(bucket.maxHeight, height);
+        bucket.byMinY.insert({curve.minY, index});
+        byMaxX.insert({curve.maxX, index});
+    }
+}
+
+// ========== 端点合并 ==========
+
+std::uint64_t CellKey(std::int64_t ix, std::int64_t iy) {
+    std::uint64_t seed = std::hash<std::int64_t>()(ix);
+    seed ^= std::hash<std::int64_t>()(iy) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+// 格子边长等于容差，查询时看周围3x3个格子即可
+class VertexIndex {
+public:
+    explicit VertexIndex(double tolerance) : m_tolerance(tolerance) {}
+
+    int Insert(const Vec2& p) {
+        std::int64_t ix = static_cast<std::int64_t>(std::floor(p.x / m_tolerance));
+        std::int64_t iy = static_cast<std::int64_t>(std::floor(p.y / m_tolerance));
+        for (std::int64_t dx = -1; dx <= 1; ++dx) {
+            for (std::int64_t dy = -1; dy <= 1; ++dy) {
+                auto it = m_cells.find(CellKey(ix + dx, iy + dy));
+                if (it == m_cells.end()) {
+                    continue;
+                }
+                for (int id : it->second) {
+                    if (Length(m_points[id] - p) <= m_tolerance) {
+                        return id;
+                    }
+                }
+            }
+        }
+        int id = static_cast<int>(m_points.size());
+        m_points.push_back(p);
+        m_cells[CellKey(ix, iy)].push_back(id);
+        return id;
+    }
+
+    const Vec2& GetPoint(int id) const { return m_points[id]; }
+    int GetCount() const { return static_cast<int>(m_points.size()); }
+
+private:
+    double m_tolerance;
+    std::vector<Vec2> m_points;
+    std::unordered_map<std::uint64_t, std::vector<int>> m_cells;
+};
+
+// ========== 平面图 ==========
+
+// 切分后的边，from 在 startAngle 处，圆弧总是逆时针
+struct GraphEdge {
+    int from = -1;
+    int to = -1;
+    int elementId = -1;
+    bool isArc = false;
+    Vec2 center;
+    double radius = 0.0;
+    double startAngle = 0.0;
+    double sweep = 0.0;
+    bool dangling = false;
+};
+
+std::vector<GraphEdge> SplitCurves(std::vector<Curve>& curves, VertexIndex& vertices, double tolerance) {
+    std::vector<GraphEdge> edges;
+    std::set<std::tuple<int, int, std::int64_t, std::int64_t>> seen;
+    double midCell = 10.0 * tolerance;
+    
+    for (auto& curve : curves) {
+        double slack = tolerance / curve.Scale();
+        auto& splits = curve.splits;
+        splits.push_back(0.0);
+        splits.push_back(curve.EndParam());
+        if (curve.isArc && curve.sweep >= TwoPi) {
+            // 整圆至少切成两半，图里不出现自环
+            splits.push_back(M_PI);
+        }
+        std::sort(splits.begin(), splits.end());
+        splits.erase(std::unique(splits.begin(), splits.end(), [slack](double a, double b) {
+            return b - a <= slack;
+        }), splits.end());
+        splits.back() = curve.EndParam();
+        
+        for (std::size_t i = 0; i + 1 < splits.size(); ++i) {
+            double p0 = splits[i], p1 = splits[i + 1];
+            GraphEdge edge;
+            edge.from = vertices.Insert(curve.PointAt(p0));
+            edge.to = vertices.Insert(curve.PointAt(p1));
+            if (edge.from == edge.to) {
+                continue;
+            }
+            
+            // 重叠的曲线切分后会出现重复边，按端点和中点去重
+            Vec2 mid = curve.PointAt(0.5 * (p0 + p1));
+            auto key = std::make_tuple(std::min(edge.from, edge.to), std::max(edge.from, edge.to),
+                                       static_cast<std::int64_t>(std::llround(mid.x / midCell)),
+                                       static_cast<std::int64_t>(std::llround(mid.y / midCell)));
+            if (!seen.insert(key).second) {
+                continue;
+            }
+            
+            edge.elementId = curve.elementId;
+            edge.isArc = curve.isArc;
+            edge.center = curve.center;
+            edge.radius = curve.radius;
+            edge.startAngle = curve.startAngle + p0;
+            edge.sweep = p1 - p0;
+            edges.push_back(edge);
+        }
+    }
+    return edges;
+}
+
+// 反复剥掉度为1的顶点上的边，剩下的边两端都至少还连着另一条边
+void PruneDanglingEdges(std::vector<GraphEdge>& edges, int vertexCount) {
+    std::vector<std::vector<int>> incident(vertexCount);
+    std::vector<int> degree(vertexCount, 0);
+    for (int i = 0; i < static_cast<int>(edges.size()); ++i) {
+        incident[edges[i].from].push_back(i);
+        incident[edges[i].to].push_back(i);
+        ++degree[edges[i].from];
+        ++degree[edges[i].to];
+    }
+    
+    std::vector<int> queue;
+    for (int v = 0; v < vertexCount; ++v) {
+        if (degree[v] == 1) {
+            queue.push_back(v);
+        }
+    }
+    while (!queue.empty()) {
+        int v = queue.back();
+        queue.pop_back();
+        for (int e : incident[v]) {
+            if (edges[e].dangling) {
+                continue;
+            }
+            edges[e].dangling = true;
+            for (int end : {edges[e].from, edges[e].to}) {
+                if (--degree[end] == 1) {
+                    queue.push_back(end);
+                }
+            }
+        }
+    }
+}
+
+// 剥完悬挂链后仍可能剩下连接两个环的桥边（如外轮廓连到内部圆的一条线），
+// 它不在任何环上，走面时会在同一个环里来回各走一次，也标成悬挂边。
+// 迭代的 DFS 求桥，按边号跳过来时的边，重边不会被误判
+void MarkBridges(std::vector<GraphEdge>& edges, int vertexCount) {
+    std::vector<std::vector<int>> incident(vertexCount);
+    for (int i = 0; i < static_cast<int>(edges.size()); ++i) {
+        if (!edges[i].dangling) {
+            incident[edges[i].from].push_back(i);
+            incident[edges[i].to].push_back(i);
+        }
+    }
+    
+    struct Frame {
+        int vertex;
+        int viaEdge;
+        std::size_t next;
+    };
+    std::vector<int> order(vertexCount, -1);
+    std::vector<int> low(vertexCount, 0);
+    std::vector<Frame> stack;
+    int counter = 0;
+    for (int root = 0; root < vertexCount; ++root) {
+        if (order[root] >= 0 || incident[root].empty()) {
+            continue;
+        }
+        order[root] = low[root] = counter++;
+        stack.push_back({root, -1, 0});
+        while (!stack.empty()) {
+            Frame& frame = stack.back();
+            if (frame.next < incident[frame.vertex].size()) {
+                int e = incident[frame.vertex][frame.next++];
+                if (e == frame.viaEdge) {
+                    continue;
+                }
+                int other = edges[e].from == frame.vertex ? edges[e].to : edges[e].from;
+                if (order[other] < 0) {
+                    order[other] = low[other] = counter++;
+                    stack.push_back({other, e, 0});
+                } else {
+                    low[frame.vertex] = std::min(low[frame.vertex], order[other]);
+                }
+                continue;
+            }
+            
+            const Frame done = frame;
+            stack.pop_back();
+            if (!stack.empty()) {
+                int up = stack.back().vertex;
+                low[up] = std::min(low[up], low[done.vertex]);
+                if (low[done.vertex] > order[up]) {
+                    edges[done.viaEdge].dangling = true;
+                }
+            }
+        }
+    }
+}
+
+// 半边 2e 与边同向，2e+1 反向
+struct HalfEdge {
+    int origin = -1;
+    double angle = 0.0;       // 出发处的切线方向
+    double curvature = 0.0;   // 切线相同时靠曲率区分先后，左转为正
+};
+
+HalfEdge MakeHalfEdge(const GraphEdge& edge, bool forward, const VertexIndex& vertices) {
+    HalfEdge half;
+    half.origin = forward ? edge.from : edge.to;
+    if (!edge.isArc) {
+        Vec2 d = vertices.GetPoint(forward ? edge.to : edge.from) - vertices.GetPoint(half.origin);
+        half.angle = NormalizeAngle(std::atan2(d.y, d.x));
+    } else if (forward) {
+        half.angle = NormalizeAngle(edge.startAngle + 0.5 * M_PI);
+        half.curvature = 1.0 / edge.radius;
+    } else {
+        half.angle = NormalizeAngle(edge.startAngle + edge.sweep - 0.5 * M_PI);
+        half.curvature = -1.0 / edge.radius;
+    }
+    return half;
+}
+
+LoopEdge MakeLoopEdge(const GraphEdge& edge, bool forward, const VertexIndex& vertices) {
+    const Vec2& start = vertices.GetPoint(forward ? edge.from : edge.to);
+    const Vec2& end = vertices.GetPoint(forward ? edge.to : edge.from);
+    
+    LoopEdge loopEdge;
+    loopEdge.elementId = edge.elementId;
+    loopEdge.isArc = edge.isArc;
+    loopEdge.start = cad_core::Point(start.x, start.y, 0.0);
+    loopEdge.end = cad_core::Point(end.x, end.y, 0.0);
+    if (edge.isArc) {
+        loopEdge.center = cad_core::Point(edge.center.x, edge.center.y, 0.0);
+        loopEdge.radius = edge.radius;
+        loopEdge.startAngle = forward ? edge.startAngle : edge.startAngle + edge.sweep;
+        loopEdge.sweep = forward ? edge.sweep : -edge.sweep;
+    }
+    return loopEdge;
+}
+
+// 弦的叉积项加上弓形面积
+double SignedArea(const std::vector<LoopEdge>& edges) {
+    double area = 0.0;
+    for (const auto& edge : edges) {
+        area += 0.5 * (edge.start.X() * edge.end.Y() - edge.end.X() * edge.start.Y());
+        if (edge.isArc) {
+            area += 0.5 * edge.radius * edge.radius * (edge.sweep - std::sin(edge.sweep));
+        }
+    }
+    return area;
+}
+
+// 环的点包含判断，按真实圆弧计算：
+// 顶点连成的弦多边形做奇偶判断，再对每段圆弧的弓形（弦与弧围成的区域）取异或
+struct LoopPolygon {
+    struct ArcSegment {
+        Vec2 center;
+        double radius = 0.0;
+        Vec2 chordStart, chordEnd;
+        Vec2 middle;             // 弧的中点，弓形在弦的这一侧
+        bool fullCircle = false;
+    };
+    
+    std::vector<Vec2> points;
+    std::vector<ArcSegment> arcs;
+    double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0;
+
+    explicit LoopPolygon(const RegionLoop& loop) {
+        for (const auto& edge : loop.edges) {
+            points.push_back({edge.start.X(), edge.start.Y()});
+        }
+        minX = maxX = points.front().x;
+        minY = maxY = points.front().y;
+        for (const auto& p : points) {
+            minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+        }
+        
+        for (const auto& edge : loop.edges) {
+            if (!edge.isArc) {
+                continue;
+            }
+            ArcSegment arc;
+            arc.center = {edge.center.X(), edge.center.Y()};
+            arc.radius = edge.radius;
+            arc.chordStart = {edge.start.X(), edge.start.Y()};
+            arc.chordEnd = {edge.end.X(), edge.end.Y()};
+            const double middleAngle = edge.startAngle + 0.5 * edge.sweep;
+            arc.middle = {arc.center.x + arc.radius * std::cos(middleAngle),
+                          arc.center.y + arc.radius * std::sin(middleAngle)};
+            arc.fullCircle = std::abs(edge.sweep) >= TwoPi - 1e-12;
+            arcs.push_back(arc);
+            
+            // 包围盒按整圆放宽，只用于快速排除
+            minX = std::min(minX, arc.center.x - arc.radius); maxX = std::max(maxX, arc.center.x + arc.radius);
+            minY = std::min(minY, arc.center.y - arc.radius); maxY = std::max(maxY, arc.center.y + arc.radius);
+        }
+    }
+
+    bool Contains(const Vec2& p) const {
+        if (p.x < minX || p.x > maxX || p.y < minY || p.y > maxY) {
+            return false;
+        }
+        bool inside = false;
+        for (std::size_t i = 0, j = points.size() - 1; i < points.size(); j = i++) {
+            const Vec2& a = points[i];
+            const Vec2& b = points[j];
+            if ((a.y > p.y) != (b.y > p.y) && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x) {
+                inside = !inside;
+            }
+        }
+        for (const auto& arc : arcs) {
+            const Vec2 offset = p - arc.center;
+            if (Dot(offset, offset) > arc.radius * arc.radius) {
+                continue;
+            }
+            // 圆内且与弧中点在弦的同一侧即在弓形内；整圆的弓形是整个圆盘
+            const Vec2 chord = arc.chordEnd - arc.chordStart;
+            if (arc.fullCircle ||
+                Cross(chord, p - arc.chordStart) * Cross(chord, arc.middle - arc.chordStart) > 0.0) {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+};
+
+// 有界面的包围盒网格，按典型区域大小分格；跨太多格的大区域单独放着，每次都查
+class PolygonIndex {
+public:
+    explicit PolygonIndex(const std::vector<LoopPolygon>& polygons) : m_polygons(polygons), m_cellSize(1.0) {
+        if (polygons.empty()) {
+            return;
+        }
+        std::vector<double> sizes;
+        sizes.reserve(polygons.size());
+        for (const auto& polygon : polygons) {
+            sizes.push_back(std::max(polygon.maxX - polygon.minX, polygon.maxY - polygon.minY));
+        }
+        std::nth_element(sizes.begin(), sizes.begin() + sizes.size() / 2, sizes.end());
+        m_cellSize = std::max(sizes[sizes.size() / 2], 1e-9);
+        
+        for (int i = 0; i < static_cast<int>(polygons.size()); ++i) {
+            const auto& polygon = polygons[i];
+            std::int64_t x0 = Cell(polygon.minX), x1 = Cell(polygon.maxX);
+            std::int64_t y0 = Cell(polygon.minY), y1 = Cell(polygon.maxY);
+            if ((x1 - x0 + 1) * (y1 - y0 + 1) > MaxCells) {
+                m_large.push_back(i);
+                continue;
+            }
+            for (std::int64_t ix = x0; ix <= x1; ++ix) {
+                for (std::int64_t iy = y0; iy <= y1; ++iy) {
+                    m_cells[CellKey(ix, iy)].push_back(i);
+                }
+            }
+        }
+    }
+
+    // 包含该点的编号最大（面积最小）的区域，不在 exclude 回调排除的范围内
+    template <typename Exclude>
+    int FindSmallestContaining(const Vec2& p, Exclude exclude) const {
+        int best = -1;
+        auto test = [&](int i) {
+            if (i > best && !exclude(i) && m_polygons[i].Contains(p)) {
+                best = i;
+            }
+        };
+        auto it = m_cells.find(CellKey(Cell(p.x), Cell(p.y)));
+        if (it != m_cells.end()) {
+            for (int i : it->second) {
+                test(i);
+            }
+        }
+        for (int i : m_large) {
+            test(i);
+        }
+        return best;
+    }
+
+private:
+    static constexpr std::int64_t MaxCells = 64;
+
+    std::int64_t Cell(double value) const {
+        return static_cast<std::int64_t>(std::floor(value / m_cellSize));
+    }
+
+    const std::vector<LoopPolygon>& m_polygons;
+    double m_cellSize;
+    std::unordered_map<std::uint64_t, std::vector<int>> m_cells;
+    std::vector<int> m_large;
+};
+
+int FindRoot(std::vector<int>& parent, int v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+} // namespace
+
+RegionFinder::RegionFinder(double tolerance) : m_tolerance(tolerance) {
+}
+
+void RegionFinder::SetTolerance(double tolerance) {
+    m_tolerance = tolerance;
+}
+
+double RegionFinder::GetTolerance() const {
+    return m_tolerance;
+}
+
+RegionSet RegionFinder::Find(const std::vector<SketchElementPtr>& elements) const {
+    RegionSet result;
+    
+    std::vector<Curve> curves = CollectCurves(elements, m_tolerance);
+    ComputeIntersections(curves, m_tolerance);
+    
+    VertexIndex vertices(m_tolerance);
+    std::vector<GraphEdge> edges = SplitCurves(curves, vertices, m_tolerance);
+    PruneDanglingEdges(edges, vertices.GetCount());
+    MarkBridges(edges, vertices.GetCount());
+    
+    // 每个顶点的出边按切线方向逆时针排序
+    std::vector<HalfEdge> halves(edges.size() * 2);
+    std::vector<std::vector<int>> outgoing(vertices.GetCount());
+    std::vector<int> parent(vertices.GetCount());
+    std::iota(parent.begin(), parent.end(), 0);
+    for (int e = 0; e < static_cast<int>(edges.size()); ++e) {
+        if (edges[e].dangling) {
+            result.danglingEdges.push_back(MakeLoopEdge(edges[e], true, vertices));
+            continue;
+        }
+        halves[2 * e] = MakeHalfEdge(edges[e], true, vertices);
+        halves[2 * e + 1] = MakeHalfEdge(edges[e], false, vertices);
+        outgoing[edges[e].from].push_back(2 * e);
+        outgoing[edges[e].to].push_back(2 * e + 1);
+        parent[FindRoot(parent, edges[e].from)] = FindRoot(parent, edges[e].to);
+    }
+    
+    std::vector<int> position(halves.size(), -1);
+    for (auto& list : outgoing) {
+        std::sort(list.begin(), list.end(), [&halves](int a, int b) {
+            auto ka = std::make_pair(std::llround(halves[a].angle * 1e9), halves[a].curvature);
+            auto kb = std::make_pair(std::llround(halves[b].angle * 1e9), halves[b].curvature);
+            return ka < kb;
+        });
+        for (int i = 0; i < static_cast<int>(list.size()); ++i) {
+            position[list[i]] = i;
+        }
+    }
+    
+    // 沿半边走出每个面：到达顶点后取反向半边顺时针方向的下一条，
+    // 面始终在左侧，有界面逆时针（面积为正），每个连通分量的外轮廓顺时针（面积为负）
+    std::vector<RegionLoop> bounded;
+    std::vector<RegionLoop> boundaries;
+    std::vector<int> boundedComponent, boundaryComponent;
+    std::vector<bool> visited(halves.size(), false);
+    for (int start = 0; start < static_cast<int>(halves.size()); ++start) {
+        if (visited[start] || position[start] < 0) {
+            continue;
+        }
+        
+        RegionLoop loop;
+        int half = start;
+        while (!visited[half]) {
+            visited[half] = true;
+            loop.edges.push_back(MakeLoopEdge(edges[half / 2], half % 2 == 0, vertices));
+            
+            int twin = half ^ 1;
+            const auto& list = outgoing[halves[twin].origin];
+            int count = static_cast<int>(list.size());
+            half = list[(position[twin] + count - 1) % count];
+        }
+        
+        loop.area = SignedArea(loop.edges);
+        int component = FindRoot(parent, halves[start].origin);
+        if (loop.area > m_tolerance * m_tolerance) {
+            bounded.push_back(std::move(loop));
+            boundedComponent.push_back(component);
+        } else if (loop.area < -m_tolerance * m_tolerance) {
+            boundaries.push_back(std::move(loop));
+            boundaryComponent.push_back(component);
+        }
+    }
+    
+    // 有界面从大到小，这样包含关系里的父区域总是先处理
+    std::vector<int> order(bounded.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&bounded](int a, int b) {
+        return bounded[a].area > bounded[b].area;
+    });
+    std::vector<LoopPolygon> polygons;
+    polygons.reserve(order.size());
+    for (int index : order) {
+        polygons.emplace_back(bounded[index]);
+    }
+    
+    // 每个连通分量的外轮廓挂到包含它的最小有界面上（不同分量之间互不相交）
+    PolygonIndex index(polygons);
+    std::vector<int> container(boundaries.size(), -1);
+    std::unordered_map<int, int> componentContainer;
+    for (int i = 0; i < static_cast<int>(boundaries.size()); ++i) {
+        const auto& first = boundaries[i].edges.front().start;
+        Vec2 sample = {first.X(), first.Y()};
+        container[i] = index.FindSmallestContaining(sample, [&](int k) {
+            return boundedComponent[order[k]] == boundaryComponent[i];
+        });
+        componentContainer[boundaryComponent[i]] = container[i];
+    }
+    
+    result.regions.resize(order.size());
+    for (int k = 0; k < static_cast<int>(order.size()); ++k) {
+        Region& region = result.regions[k];
+        region.outer = bounded[order[k]];
+        region.area = region.outer.area;
+        
+        auto it = componentContainer.find(boundedComponent[order[k]]);
+        if (it != componentContainer.end() && it->second >= 0) {
+            region.depth = result.regions[it->second].depth + 1;
+        }
+    }
+    for (int i = 0; i < static_cast<int>(boundaries.size()); ++i) {
+        if (container[i] >= 0) {
+            Region& region = result.regions[container[i]];
+            region.area += boundaries[i].area;
+            region.inners.push_back(std::move(boundaries[i]));
+        }
+    }
+    
+    return result;
+}
+
+} // namespace cad_sketch
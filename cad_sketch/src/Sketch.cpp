@@ -1,12 +1,34 @@
 ﻿#include "cad_sketch/Sketch.h"
 #include <algorithm>
+#include <functional>
 
 namespace cad_sketch {
 
-Sketch::Sketch() : m_name("Sketch") {
+namespace {
+
+void HashCombine(std::size_t& seed, std::size_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+void HashDouble(std::size_t& seed, double value) {
+    HashCombine(seed, std::hash<double>()(value));
 }
 
-Sketch::Sketch(const std::string& name) : m_name(name) {
+void HashPoint(std::size_t& seed, const SketchPointPtr& point) {
+    if (point) {
+        HashDouble(seed, point->GetX());
+        HashDouble(seed, point->GetY());
+    }
+}
+
+} // namespace
+
+Sketch::Sketch()
+    : m_name("Sketch"), m_version(0), m_profileHash(0), m_profileValid(false) {
+}
+
+Sketch::Sketch(const std::string& name)
+    : m_name(name), m_version(0), m_profileHash(0), m_profileValid(false) {
 }
 
 const std::string& Sketch::GetName() const {
@@ -19,17 +41,20 @@ void Sketch::SetName(const std::string& name) {
 
 void Sketch::AddElement(const SketchElementPtr& element) {
     m_elements.push_back(element);
+    MarkModified();
 }
 
 void Sketch::RemoveElement(const SketchElementPtr& element) {
     auto it = std::find(m_elements.begin(), m_elements.end(), element);
     if (it != m_elements.end()) {
         m_elements.erase(it);
+        MarkModified();
     }
 }
 
 void Sketch::ClearElements() {
     m_elements.clear();
+    MarkModified();
 }
 
 const std::vector<SketchElementPtr>& Sketch::GetElements() const {
@@ -48,6 +73,7 @@ SketchElementPtr Sketch::GetElementById(int id) const {
 void Sketch::AddConstraint(const ConstraintPtr& constraint) {
     m_constraints.push_back(constraint);
     m_solver.AddConstraint(constraint);
+    MarkModified();
 }
 
 void Sketch::RemoveConstraint(const ConstraintPtr& constraint) {
@@ -55,12 +81,14 @@ void Sketch::RemoveConstraint(const ConstraintPtr& constraint) {
     if (it != m_constraints.end()) {
         m_constraints.erase(it);
         m_solver.RemoveConstraint(constraint);
+        MarkModified();
     }
 }
 
 void Sketch::ClearConstraints() {
     m_constraints.clear();
     m_solver.ClearConstraints();
+    MarkModified();
 }
 
 const std::vector<ConstraintPtr>& Sketch::GetConstraints() const {
@@ -68,6 +96,8 @@ const std::vector<ConstraintPtr>& Sketch::GetConstraints() const {
 }
 
 bool Sketch::SolveConstraints() {
+    // 求解会移动元素
+    MarkModified();
     return m_solver.Solve();
 }
 
@@ -111,4 +141,64 @@ int Sketch::GetConstraintCount() const {
     return static_cast<int>(m_constraints.size());
 }
 
+unsigned long Sketch::GetVersion() const {
+    return m_version;
+}
+
+void Sketch::MarkModified() {
+    ++m_version;
+}
+
+std::size_t Sketch::ComputeContentHash() const {
+    std::size_t seed = ComputeGeometryHash();
+    HashCombine(seed, m_constraints.size());
+    return seed;
+}
+
+std::size_t Sketch::ComputeGeometryHash() const {
+    std::size_t seed = 0;
+    for (const auto& element : m_elements) {
+        HashCombine(seed, static_cast<std::size_t>(element->GetType()));
+        switch (element->GetType()) {
+            case SketchElementType::Point:
+                HashPoint(seed, std::static_pointer_cast<SketchPoint>(element));
+                break;
+            case SketchElementType::Line: {
+                auto line = std::static_pointer_cast<SketchLine>(element);
+                HashPoint(seed, line->GetStartPoint());
+                HashPoint(seed, line->GetEndPoint());
+                break;
+            }
+            case SketchElementType::Circle: {
+                auto circle = std::static_pointer_cast<SketchCircle>(element);
+                HashPoint(seed, circle->GetCenter());
+                HashDouble(seed, circle->GetRadius());
+                break;
+            }
+            case SketchElementType::Arc: {
+                auto arc = std::static_pointer_cast<SketchArc>(element);
+                HashPoint(seed, arc->GetCenter());
+                HashDouble(seed, arc->GetRadius());
+                HashDouble(seed, arc->GetStartAngle());
+                HashDouble(seed, arc->GetEndAngle());
+                break;
+            }
+        }
+    }
+    return seed;
+}
+
+SketchProfilePtr Sketch::GetProfile() const {
+    std::lock_guard<std::mutex> lock(m_profileMutex);
+    // 元素的 setter 不会改版本号，所以每次都按几何哈希判断；
+    // 哈希与特征缓存键用的是同一份几何，轮廓不会比缓存键旧
+    std::size_t hash = ComputeGeometryHash();
+    if (!m_profileValid || hash != m_profileHash) {
+        m_profile = ProfileBuilder::Build(m_elements);
+        m_profileHash = hash;
+        m_profileValid = true;
+    }
+    return m_profile;
+}
+
 } // namespace cad_sketch
\ No newline at end of file
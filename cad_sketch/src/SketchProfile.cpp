@@ -0,0 +1,140 @@
+﻿#include "cad_sketch/SketchProfile.h"
+#include "cad_sketch/RegionFinder.h"
+#include <BRepBuilderAPI_MakeEdge.hxx>
+#include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepBuilderAPI_MakeVertex.hxx>
+#include <BRep_Builder.hxx>
+#include <ShapeAnalysis_FreeBounds.hxx>
+#include <ShapeFix_Face.hxx>
+#include <Standard_Failure.hxx>
+#include <TopTools_HSequenceOfShape.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Vertex.hxx>
+#include <gp_Ax2.hxx>
+#include <gp_Circ.hxx>
+#include <gp_Pnt.hxx>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <utility>
+
+namespace cad_sketch {
+
+namespace {
+
+// 同一条图边只建一次拓扑边，相邻区域和孔共用，端点顶点也共用，
+// 这样拉伸后相邻实体共享侧面，不会出现重合的两份边
+class EdgeCache {
+public:
+    // 圆弧总是按逆时针建边，直线按端点坐标的字典序建边，反向走的边取 Reversed
+    TopoDS_Edge Get(const LoopEdge& edge) {
+        const bool reversed = edge.isArc ? edge.sweep < 0.0 : Key(edge.end) < Key(edge.start);
+        const cad_core::Point& first = reversed ? edge.end : edge.start;
+        const cad_core::Point& last = reversed ? edge.start : edge.end;
+        
+        const EdgeKey key{edge.elementId, edge.isArc, Key(first), Key(last)};
+        auto it = m_edges.find(key);
+        if (it == m_edges.end()) {
+            it = m_edges.emplace(key, Make(edge, GetVertex(first), GetVertex(last))).first;
+        }
+        return reversed ? TopoDS::Edge(it->second.Reversed()) : it->second;
+    }
+    
+private:
+    using PointKey = std::pair<double, double>;
+    using EdgeKey = std::tuple<int, bool, PointKey, PointKey>;
+    
+    // RegionFinder 已经把端点合并成同一个坐标，可以直接按坐标比较
+    static PointKey Key(const cad_core::Point& point) {
+        return {point.X(), point.Y()};
+    }
+    
+    TopoDS_Vertex GetVertex(const cad_core::Point& point) {
+        auto it = m_vertices.find(Key(point));
+        if (it == m_vertices.end()) {
+            it = m_vertices.emplace(Key(point), BRepBuilderAPI_MakeVertex(point.GetOCCTPoint()).Vertex()).first;
+        }
+        return it->second;
+    }
+    
+    static TopoDS_Edge Make(const LoopEdge& edge, const TopoDS_Vertex& first, const TopoDS_Vertex& last) {
+        if (!edge.isArc) {
+            return BRepBuilderAPI_MakeEdge(first, last).Edge();
+        }
+        gp_Circ circ(gp_Ax2(edge.center.GetOCCTPoint(), gp::DZ(), gp::DX()), edge.radius);
+        const double from = edge.sweep > 0.0 ? edge.startAngle : edge.startAngle + edge.sweep;
+        return BRepBuilderAPI_MakeEdge(circ, first, last, from, from + std::abs(edge.sweep)).Edge();
+    }
+    
+    std::map<PointKey, TopoDS_Vertex> m_vertices;
+    std::map<EdgeKey, TopoDS_Edge> m_edges;
+};
+
+TopoDS_Wire MakeWire(const RegionLoop& loop, EdgeCache& edges) {
+    BRep_Builder builder;
+    TopoDS_Wire wire;
+    builder.MakeWire(wire);
+    for (const auto& edge : loop.edges) {
+        builder.Add(wire, edges.Get(edge));
+    }
+    wire.Closed(Standard_True);
+    return wire;
+}
+
+} // namespace
+
+SketchProfilePtr ProfileBuilder::Build(const std::vector<SketchElementPtr>& elements, double tolerance) {
+    auto profile = std::make_shared<SketchProfile>();
+    
+    try {
+        RegionSet regions = RegionFinder(tolerance).Find(elements);
+        
+        BRep_Builder builder;
+        builder.MakeCompound(profile->faceCompound);
+        EdgeCache edges;
+        
+        for (const auto& region : regions.regions) {
+            TopoDS_Wire outer = MakeWire(region.outer, edges);
+            profile->closedWires.push_back(outer);
+            
+            // 奇数层的区域已经作为父区域的孔挖掉了
+            if (region.depth % 2 != 0) {
+                continue;
+            }
+            
+            BRepBuilderAPI_MakeFace face(outer, Standard_True);
+            for (const auto& inner : region.inners) {
+                face.Add(MakeWire(inner, edges));
+            }
+            if (!face.IsDone()) {
+                continue;
+            }
+            
+            // 孔的走向由 ShapeFix_Face 统一翻到与外环相反
+            ShapeFix_Face fixer(face.Face());
+            fixer.Perform();
+            profile->faces.push_back(fixer.Face());
+            builder.Add(profile->faceCompound, profile->faces.back());
+        }
+        
+        // 不围成区域的边按端点串成链
+        if (!regions.danglingEdges.empty()) {
+            Handle(TopTools_HSequenceOfShape) chain = new TopTools_HSequenceOfShape();
+            for (const auto& edge : regions.danglingEdges) {
+                chain->Append(edges.Get(edge));
+            }
+            Handle(TopTools_HSequenceOfShape) wires;
+            ShapeAnalysis_FreeBounds::ConnectEdgesToWires(chain, tolerance, Standard_False, wires);
+            for (int i = 1; i <= wires->Length(); ++i) {
+                profile->openWires.push_back(TopoDS::Wire(wires->Value(i)));
+            }
+        }
+    } catch (const Standard_Failure&) {
+        return nullptr;
+    }
+    
+    return profile;
+}
+
+} // namespace cad_sketch
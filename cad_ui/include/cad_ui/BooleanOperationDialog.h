@@ -9,8 +9,13 @@
 #include <QFrame>
 #include <QGroupBox>
 #include <QListWidget>
+#include <QThreadPool>
+#include <QTimer>
+#include <memory>
 #include <vector>
 #include "cad_core/Shape.h"
+#include "cad_core/CancellationToken.h"
+#include "cad_core/BooleanOperations.h"
 
 namespace cad_ui {
 
@@ -20,16 +25,22 @@ enum class BooleanOperationType {
     Difference
 };
 
+struct BooleanPreviewTask;
+
 class BooleanOperationDialog : public QDialog {
     Q_OBJECT
 
 public:
     explicit BooleanOperationDialog(BooleanOperationType operationType, QWidget* parent = nullptr);
-    ~BooleanOperationDialog() = default;
+    ~BooleanOperationDialog();
 
     // Get selected objects
     std::vector<cad_core::ShapePtr> getTargetObjects() const { return m_targetObjects; }
     std::vector<cad_core::ShapePtr> getToolObjects() const { return m_toolObjects; }
+    BooleanOperationType getOperationType() const { return m_operationType; }
+    
+    // 预览使用与确定时相同的内核选项
+    void setBooleanOptions(const cad_core::BooleanOptions& options);
 
 public slots:
     void onTargetSelectionClicked();
@@ -39,9 +50,23 @@ public slots:
 
 signals:
     void selectionModeChanged(bool enabled, const QString& prompt);
+    // precomputedResult 为当前选择下已算好的预览结果（没有时为空）
     void operationRequested(BooleanOperationType type, 
                           const std::vector<cad_core::ShapePtr>& targets,
-                          const std::vector<cad_core::ShapePtr>& tools);
+                          const std::vector<cad_core::ShapePtr>& tools,
+                          const cad_core::ShapePtr& precomputedResult);
+    
+    // 实时预览结果（半透明叠加显示）
+    void previewReady(const cad_core::ShapePtr& result);
+    void previewCleared();
+    
+    // 工作线程内部使用，排队到GUI线程
+    void previewFinished(quint64 generation);
+
+private slots:
+    void onPreviewToggled(bool enabled);
+    void startPreview();
+    void onPreviewFinished(quint64 generation);
 
 private:
     void setupUI();
@@ -49,6 +74,9 @@ private:
     QString getOperationTitle() const;
     QString getTargetLabel() const;
     QString getToolLabel() const;
+    bool canExecute() const;
+    void schedulePreview();
+    void cancelPreview();
 
     BooleanOperationType m_operationType;
     
@@ -78,12 +106,21 @@ private:
     QPushButton* m_okButton;
     QPushButton* m_cancelButton;
     QPushButton* m_previewButton;
+    QLabel* m_previewStatus;
     
     // Data
     std::vector<cad_core::ShapePtr> m_targetObjects;
     std::vector<cad_core::ShapePtr> m_toolObjects;
     bool m_selectingTargets;
     bool m_selectingTools;
+    
+    // 实时预览：选择变化时取消进行中的计算，只接受最新一代的结果
+    QThreadPool* m_previewPool;
+    QTimer* m_previewTimer;
+    quint64 m_previewGeneration;
+    std::shared_ptr<BooleanPreviewTask> m_previewTask;
+    cad_core::ShapePtr m_previewResult;
+    cad_core::BooleanOptions m_booleanOptions;
 };
 
 } // namespace cad_ui
\ No newline at end of file
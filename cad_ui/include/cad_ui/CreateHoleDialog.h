@@ -9,8 +9,10 @@
 #include <QFrame>
 #include <QGroupBox>
 #include <QDoubleSpinBox>
+#include <QSpinBox>
 #include "cad_core/Shape.h"
 #include <TopoDS_Face.hxx>
+#include <gp_Trsf.hxx>
 #include <QListWidget>
 
 // ǰ
@@ -37,8 +39,10 @@ signals:
     void operationRequested(const cad_core::ShapePtr& targetShape, const TopoDS_Face& selectedFace, 
                             double diameter, 
                             double depth, 
-                            double x, double y, double z);
+                            double x, double y, double z,
+                            int count, double spacing);   //  X ųһţcount һ
     void previewRequested(const cad_core::ShapePtr& holePreviewShape);
+    void previewMoved(const gp_Trsf& transformation);    // ֻƶԤؽԲ
     void resetPreviewRequested();
 
     void selectionModeChanged(bool enabled, const QString& prompt);
@@ -61,6 +65,11 @@ private:
     QtOccView* m_viewer; // ָ3Dͼ
 	bool m_previewActive;// ǷԤ
     cad_core::ShapePtr m_transparentShape; // ¼Ϊ͸ʵ
+    cad_core::ShapePtr m_previewShape;     // ԭ㴦Ԥףţߴб仯ʱؽ
+    double m_previewDiameter;
+    double m_previewDepth;
+    int m_previewCount;
+    double m_previewSpacing;
 
     // UI ؼ
     QGroupBox* m_selectionGroup;
@@ -73,11 +82,14 @@ private:
     QDoubleSpinBox* m_xCoordSpinBox; //   X 
     QDoubleSpinBox* m_yCoordSpinBox; //   Y 
     QDoubleSpinBox* m_zCoordSpinBox; //   Z 
+    QSpinBox* m_countSpinBox;
+    QDoubleSpinBox* m_spacingSpinBox;
 
     QPushButton* m_okButton;
     QPushButton* m_cancelButton;
 
     cad_core::ShapePtr createHolePreviewShape() const;
+    bool computeHolePreviewTransformation(gp_Trsf& transformation) const;
 };
 
 } // namespace cad_ui#pragma once
@@ -11,8 +11,14 @@
 #include <QListWidget>
 #include <QDoubleSpinBox>
 #include <QCheckBox>
+#include <QThreadPool>
+#include <QTimer>
+#include <memory>
 #include <vector>
+#include <TopoDS_Shape.hxx>
 #include "cad_core/Shape.h"
+#include "cad_core/CancellationToken.h"
+#include "cad_core/FilletChamferOperations.h"
 
 namespace cad_ui {
 
@@ -24,12 +30,14 @@ enum class FilletChamferType {
     Chamfer
 };
 
+struct FilletChamferPreviewTask;
+
 class FilletChamferDialog : public QDialog {
     Q_OBJECT
 
 public:
     explicit FilletChamferDialog(FilletChamferType operationType, QtOccView* viewer, QWidget* parent = nullptr);
-    ~FilletChamferDialog() = default;
+    ~FilletChamferDialog();
 
     // Get operation parameters
     std::vector<cad_core::ShapePtr> getSelectedEdges() const { return m_selectedEdges; }
@@ -50,6 +58,20 @@ signals:
     void operationRequested(FilletChamferType type, 
                           const std::vector<cad_core::ShapePtr>& edges,
                           double radius, double distance1, double distance2);
+    
+    // 实时预览结果（所有实体的结果组成的复合体）
+    void previewReady(const TopoDS_Shape& result);
+    // 导致失败的边（原形状上的边组成的复合体），随 previewCleared 一起撤掉
+    void faultyEdgesChanged(const TopoDS_Shape& edges);
+    void previewCleared();
+    
+    // 工作线程内部使用，排队到GUI线程
+    void previewFinished(quint64 generation);
+
+private slots:
+    void onPreviewToggled(bool enabled);
+    void startPreview();
+    void onPreviewFinished(quint64 generation);
 
 private:
     void setupUI();
@@ -57,6 +79,11 @@ private:
     void updateParameterVisibility();
     QString getOperationTitle() const;
     void syncWithViewerEdgeSelection();
+    bool hasValidParameters() const;
+    double getPreviewValue() const;
+    void schedulePreview();
+    void cancelPreview();
+    void updateRadiusRangeDisplay();
 
     FilletChamferType m_operationType;
     QtOccView* m_viewer;
@@ -81,6 +108,7 @@ private:
     // Fillet parameters
     QLabel* m_radiusLabel;
     QDoubleSpinBox* m_radiusSpinBox;
+    QLabel* m_radiusRangeLabel;
     
     // Chamfer parameters
     QLabel* m_chamferDistance1Label;
@@ -94,10 +122,23 @@ private:
     QPushButton* m_okButton;
     QPushButton* m_cancelButton;
     QPushButton* m_previewButton;
+    QLabel* m_previewStatus;
     
     // Data
     std::vector<cad_core::ShapePtr> m_selectedEdges;
     bool m_selectingEdges;
+    
+    // 实时预览：加边或改参数时取消进行中的计算，只接受最新一代的结果
+    QThreadPool* m_previewPool;
+    QTimer* m_previewTimer;
+    quint64 m_previewGeneration;
+    std::shared_ptr<FilletChamferPreviewTask> m_previewTask;
+    bool m_previewShown;
+    
+    // 当前边选择下的可行圆角半径
+    cad_core::FilletRadiusRange m_radiusRange;
+    bool m_radiusRangeDirty;
+    cad_core::FilletRadiusCache m_radiusCache;
 };
 
 } // namespace cad_ui
\ No newline at end of file
@@ -18,6 +18,9 @@
 #include <QComboBox>
 #include <QTextEdit>
 
+#include <TopoDS_Compound.hxx>
+#include <gp_Trsf.hxx>
+
 #include "QtOccView.h"
 #include "DocumentTree.h"
 #include "PropertyPanel.h"
@@ -33,6 +36,7 @@
 #include "cad_core/OCAFManager.h"
 #include "cad_core/TransformCommand.h"
 #include "cad_feature/FeatureManager.h"
+#include "cad_feature/ProfilerPanel.h"
 
 namespace cad_ui {
 
@@ -101,6 +105,7 @@ namespace cad_ui {
         void OnViewShaded();
         void OnViewOrthographic();
         void OnViewPerspective();
+        void OnToggleRenderStatistics(bool checked);
 
         void OnCreateBox();
         void OnCreateCylinder();
@@ -128,6 +133,8 @@ namespace cad_ui {
         void OnBooleanUnion();
         void OnBooleanIntersection();
         void OnBooleanDifference();
+        void OnToggleAutoSimplify(bool checked);
+        void OnSetBooleanFuzzyValue();
 
         // 修改操作
         void OnFillet();
@@ -147,7 +154,13 @@ namespace cad_ui {
         void OnObjectSelected(const cad_core::ShapePtr& shape);
         void OnBooleanOperationRequested(BooleanOperationType type,
             const std::vector<cad_core::ShapePtr>& targets,
-            const std::vector<cad_core::ShapePtr>& tools);
+            const std::vector<cad_core::ShapePtr>& tools,
+            const cad_core::ShapePtr& precomputedResult);
+        void OnBooleanPreviewReady(const cad_core::ShapePtr& result);
+        void OnBooleanPreviewCleared();
+        void OnFilletChamferPreviewReady(const TopoDS_Shape& result);
+        void OnFilletChamferFaultyEdges(const TopoDS_Shape& edges);
+        void OnFilletChamferPreviewCleared();
         void OnFilletChamferOperationRequested(FilletChamferType type,
             const std::vector<cad_core::ShapePtr>& edges,
             double radius, double distance1, double distance2);
@@ -155,13 +168,15 @@ namespace cad_ui {
             const TopoDS_Face& selectedFace, 
             double diameter, 
             double depth,
-            double x, double y, double z);
+            double x, double y, double z,
+            int count, double spacing);
         void OnTransformOperationRequested(std::shared_ptr<cad_core::TransformCommand> command);
         void OnTransformPreviewRequested(std::shared_ptr<cad_core::TransformCommand> command);
         void OnTransformResetRequested();
 
         void OnHolePreviewRequested(const cad_core::ShapePtr& holePreviewShape);
         void OnHoleResetPreviewRequested();
+        void OnHolePreviewMoved(const gp_Trsf& transformation);
 
         // 移动预览圆柱体
         // void OnHolePreviewMoved(double x, double y, double z);
@@ -182,6 +197,7 @@ namespace cad_ui {
         // 文档树选择处理器
         void OnDocumentTreeShapeSelected(const cad_core::ShapePtr& shape);
         void OnDocumentTreeFeatureSelected(const cad_feature::FeaturePtr& feature);
+        void OnDocumentTreeShapeVisibilityChanged(const cad_core::ShapePtr& shape, bool visible);
 
         // 标签页管理
         void CloseDocumentTab(int index);
@@ -203,6 +219,8 @@ namespace cad_ui {
         // Dock widgets
         QDockWidget* m_documentDock;
         QDockWidget* m_propertyDock;
+        QDockWidget* m_profilerDock;
+        cad_feature::ProfilerPanel* m_profilerPanel;
 
         // Managers
         std::unique_ptr<cad_core::CommandManager> m_commandManager;
@@ -214,6 +232,11 @@ namespace cad_ui {
         FilletChamferDialog* m_currentFilletChamferDialog;
         TransformOperationDialog* m_currentTransformDialog;
         CreateHoleDialog* m_currentHoleDialog;
+        
+        // 布尔运算内核选项，对话框预览和确定时共用；glue 始终为 Off，
+        // 粘合只在布尔对话框的并集中按 m_booleanUnionGlue 启用（见 GetBooleanOptions）
+        cad_core::BooleanOptions m_booleanOptions;
+        cad_core::BooleanOptions::GlueMode m_booleanUnionGlue;
 
         // Current document info
         QString m_currentFileName;
@@ -221,6 +244,7 @@ namespace cad_ui {
 
         // Transform preview support
         std::vector<cad_core::ShapePtr> m_previewShapes;
+        TopoDS_Compound m_transformPreviewSource;   // 预览用的原形状复合体，参数变化时只改变换
         bool m_previewActive;
 
         // Sketch mode support
@@ -238,6 +262,8 @@ namespace cad_ui {
 
         void UpdateWindowTitle();
         void UpdateActions();
+        void UpdateBooleanDialogOptions();
+        cad_core::BooleanOptions GetBooleanOptions(BooleanOperationType type) const;
         void RefreshUIFromOCAF();  // Refresh UI from OCAF document state
 
         bool SaveChanges();
@@ -265,6 +291,7 @@ namespace cad_ui {
         QAction* m_viewShadedAction;
         QAction* m_viewOrthographicAction;
         QAction* m_viewPerspectiveAction;
+        QAction* m_renderStatisticsAction;
 
         QAction* m_createBoxAction;
         QAction* m_createCylinderAction;
@@ -278,6 +305,11 @@ namespace cad_ui {
         QAction* m_booleanUnionAction;
         QAction* m_booleanIntersectionAction;
         QAction* m_booleanDifferenceAction;
+        QAction* m_autoSimplifyAction;
+        QAction* m_booleanParallelAction;
+        QAction* m_booleanOBBAction;
+        QAction* m_booleanGlueAction;
+        QAction* m_booleanFuzzyAction;
 
         // Fillet and chamfer
         QAction* m_filletAction;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "cad_core/Shape.h"
+
+namespace cad_ui {
+
+// 网格驻留管理器
+// 记录每个形状的三角化与显示缓冲区占用，在超出内存预算时按最近最少可见（LRU）
+// 顺序挑选隐藏或离屏的形状释放其显示表示；形状重新可见时再重建表示，缺网格时才网格化。
+class MeshResidencyManager {
+public:
+    MeshResidencyManager();
+
+    // 内存预算（字节）
+    void SetMemoryBudget(std::size_t bytes) { m_memoryBudget = bytes; }
+    std::size_t GetMemoryBudget() const { return m_memoryBudget; }
+
+    // 跟踪形状：记录网格字节数并标记为驻留
+    void Track(const cad_core::ShapePtr& shape, std::size_t bytes);
+    void Untrack(const cad_core::ShapePtr& shape);
+    void Clear();
+
+    // 每次可见性检查前推进一次逻辑时钟
+    void NextTick() { ++m_tick; }
+
+    // 可见性：隐藏或离屏的形状才允许被淘汰
+    void SetVisible(const cad_core::ShapePtr& shape, bool visible);
+    void SetHidden(const cad_core::ShapePtr& shape, bool hidden);
+    bool IsVisible(const cad_core::ShapePtr& shape) const;
+    bool IsHidden(const cad_core::ShapePtr& shape) const;
+
+    // 驻留状态
+    void SetEvicted(const cad_core::ShapePtr& shape);
+    bool IsResident(const cad_core::ShapePtr& shape) const;
+    std::size_t GetBytes(const cad_core::ShapePtr& shape) const;
+
+    // 表示池中已擦除但保留的表示占用的字节，同样计入预算
+    void SetPooledBytes(std::size_t bytes) { m_pooledBytes = bytes; }
+    std::size_t GetPooledBytes() const { return m_pooledBytes; }
+
+    // 统计（GetResidentBytes 包含表示池）
+    std::size_t GetResidentBytes() const;
+    std::size_t GetResidentCount() const;
+    std::size_t GetEvictedCount() const;
+
+    // 超出预算时需要释放的形状（按最后可见时间从旧到新）
+    std::vector<cad_core::ShapePtr> CollectEvictions() const;
+    // 已被释放但重新可见、需要重新网格化的形状
+    std::vector<cad_core::ShapePtr> CollectReloads() const;
+
+private:
+    struct Entry {
+        std::size_t bytes = 0;
+        bool onScreen = true;
+        bool hidden = false;
+        bool resident = true;
+        std::uint64_t lastSeen = 0;
+    };
+
+    std::map<cad_core::ShapePtr, Entry> m_entries;
+    std::size_t m_memoryBudget;
+    std::size_t m_pooledBytes;
+    std::uint64_t m_tick;
+};
+
+} // namespace cad_ui
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QObject>
+#include <QThreadPool>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <TopoDS_Shape.hxx>
+
+namespace cad_ui {
+
+struct MeshJob;
+
+// 形状当前网格的统计信息
+struct MeshStatistics {
+    std::size_t faces = 0;
+    std::size_t meshedFaces = 0;
+    std::size_t triangles = 0;
+    std::size_t nodes = 0;
+    double deflection = 0.0;    // 各面三角化弦高的最大值
+    std::size_t bytes = 0;      // 三角化与着色显示缓冲区的估计内存
+};
+
+// 后台网格化服务
+// 提交任务时在GUI线程上复制形状的拓扑，工作线程对副本运行 BRepMesh_IncrementalMesh，
+// 结果回到GUI线程后再写回原始形状的面上。三角化存储在 TShape 中，
+// 因此撤销/重做后重新显示同一形状时不需要再次网格化。
+class MeshingService : public QObject {
+    Q_OBJECT
+
+public:
+    explicit MeshingService(QObject* parent = nullptr);
+    ~MeshingService();
+
+    // 网格精度（相对于包围盒对角线）
+    void SetCoarseRelativeDeflection(double deflection) { m_coarseRelativeDeflection = deflection; }
+    void SetFineRelativeDeflection(double deflection) { m_fineRelativeDeflection = deflection; }
+    void SetAngularDeflection(double angle) { m_angularDeflection = angle; }
+    double GetCoarseRelativeDeflection() const { return m_coarseRelativeDeflection; }
+    double GetFineRelativeDeflection() const { return m_fineRelativeDeflection; }
+
+    // 视图相关的自适应精度
+    void SetPixelTolerance(double pixels) { m_pixelTolerance = pixels; }
+    void SetRelativeDeflectionRange(double minRelative, double maxRelative);
+    void SetRemeshThreshold(double ratio) { m_remeshThreshold = ratio; }
+    void SetTriangleBudget(std::size_t triangles) { m_triangleBudget = triangles; }
+    double GetPixelTolerance() const { return m_pixelTolerance; }
+    double GetRemeshThreshold() const { return m_remeshThreshold; }
+    std::size_t GetTriangleBudget() const { return m_triangleBudget; }
+
+    // 按屏幕上每像素对应的世界尺寸计算弦高，并限制在包围盒相对范围内
+    double ComputeViewDeflection(double diagonal, double worldSizePerPixel) const;
+    double ClampDeflection(double diagonal, double deflection) const;
+
+    // 根据包围盒计算绝对弦高
+    static double ComputeDeflection(const TopoDS_Shape& shape, double relativeDeflection);
+    double ComputeFineDeflection(const TopoDS_Shape& shape) const;
+
+    // 形状的所有面是否已有不粗于给定弦高的三角化
+    static bool HasTriangulation(const TopoDS_Shape& shape, double deflection);
+    static MeshStatistics ComputeMeshStatistics(const TopoDS_Shape& shape);
+
+    // 提交网格化任务：先粗网格，再细网格。返回任务编号（0表示无需网格化）
+    // coarseDeflection 为0时跳过粗网格阶段；force 为 true 时即使已有更细的网格也重新网格化
+    quint64 RequestMesh(const TopoDS_Shape& shape);
+    quint64 RequestMesh(const TopoDS_Shape& shape, double coarseDeflection, double fineDeflection,
+                        bool force = false);
+
+    // 取消任务（已在运行的阶段结束后丢弃结果）
+    void Cancel(quint64 jobId);
+    void CancelAll();
+    bool IsPending(quint64 jobId) const { return m_jobs.find(jobId) != m_jobs.end(); }
+
+    // 等待所有工作线程结束
+    void WaitForDone();
+
+signals:
+    // 网格已写回形状（GUI线程），isFinal 为 true 表示细网格
+    void meshReady(quint64 jobId, bool isFinal);
+
+    // 网格化失败，任务结束（GUI线程）。已写回的粗网格保留
+    void meshFailed(quint64 jobId);
+
+    // 工作线程内部使用，排队到GUI线程
+    void stageFinished(quint64 jobId, int stage);
+
+private slots:
+    void onStageFinished(quint64 jobId, int stage);
+
+private:
+    QThreadPool* m_threadPool;
+    std::map<quint64, std::shared_ptr<MeshJob>> m_jobs;
+    quint64 m_nextJobId;
+
+    double m_coarseRelativeDeflection;
+    double m_fineRelativeDeflection;
+    double m_angularDeflection;
+
+    double m_pixelTolerance;
+    double m_minRelativeDeflection;
+    double m_maxRelativeDeflection;
+    double m_remeshThreshold;
+    std::size_t m_triangleBudget;
+
+    static void RunJob(MeshingService* service, const std::shared_ptr<MeshJob>& job);
+};
+
+} // namespace cad_ui
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <V3d_View.hxx>
+#include <V3d_Viewer.hxx>
+#include <AIS_InteractiveContext.hxx>
+#include <Graphic3d_GraphicDriver.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Dir.hxx>
+
+#include "cad_core/Shape.h"
+
+namespace cad_ui {
+
+// 离屏视图选项
+struct OffscreenViewOptions {
+    int width = 1280;
+    int height = 720;
+    bool softwareOpenGL = true;     // 使用软件OpenGL（Mesa llvmpipe / Windows GDI Generic），结果与显卡无关
+    bool vsync = false;
+    double relativeDeflection = 0.001;  // 未网格化的形状显示时使用的相对弦高
+};
+
+// 无界面的离屏视图
+// 使用不映射到屏幕的虚拟窗口创建 V3d_View，不依赖 QWidget，
+// 用于性能基准测试和截图回归对比。截图通过 FBO 渲染后读回。
+// 注意：Linux 上虚拟窗口仍是 Xw_Window，需要可连接的 X 服务器（DISPLAY），
+// 没有显示器的机器上用 Xvfb 提供，例如 xvfb-run。
+class OffscreenView {
+public:
+    OffscreenView();
+    ~OffscreenView();
+
+    bool Initialize(const OffscreenViewOptions& options = OffscreenViewOptions());
+    bool IsInitialized() const { return m_isInitialized; }
+    int GetWidth() const { return m_options.width; }
+    int GetHeight() const { return m_options.height; }
+
+    // 形状显示（关闭自动三角化，没有网格的形状在显示前同步网格化）
+    void DisplayShape(const cad_core::ShapePtr& shape);
+    void DisplayShape(const TopoDS_Shape& shape);
+    void ClearShapes();
+
+    // 相机
+    void SetCamera(const gp_Pnt& eye, const gp_Pnt& center, const gp_Dir& up);
+    void FitAll();
+
+    // 绘制一帧并等待GPU完成，返回耗时（毫秒）
+    double RenderFrame();
+
+    // 保存当前视图图像（按扩展名选择格式，如 .png/.ppm/.bmp）
+    bool DumpImage(const std::string& filePath);
+
+    Handle(V3d_View) GetView() const { return m_view; }
+    Handle(AIS_InteractiveContext) GetContext() const { return m_context; }
+
+private:
+    Handle(Graphic3d_GraphicDriver) m_driver;
+    Handle(V3d_Viewer) m_viewer;
+    Handle(V3d_View) m_view;
+    Handle(AIS_InteractiveContext) m_context;
+    OffscreenViewOptions m_options;
+    bool m_isInitialized;
+
+    void FinishFrame();
+};
+
+} // namespace cad_ui
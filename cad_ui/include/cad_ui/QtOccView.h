@@ -6,21 +6,63 @@
 #include <QKeyEvent>
 #include <QResizeEvent>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <cstddef>
+#include <deque>
 #include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 #include <gp_Pln.hxx>
+#include <gp_Trsf.hxx>
+#include <Bnd_Box.hxx>
 #include <V3d_View.hxx>
 #include <V3d_Viewer.hxx>
 #include <AIS_InteractiveContext.hxx>
 #include <AIS_Shape.hxx>
+#include <AIS_ConnectedInteractive.hxx>
+#include <AIS_TextLabel.hxx>
 #include <AIS_ViewController.hxx>
 #include <Graphic3d_GraphicDriver.hxx>
+#include <NCollection_DataMap.hxx>
+#include <TopTools_ShapeMapHasher.hxx>
 
 #include "cad_core/Shape.h"
 #include "cad_core/SelectionManager.h"
+#include "cad_ui/MeshResidencyManager.h"
 
 namespace cad_ui {
 
+class MeshingService;
+
+// 渲染统计（叠加层显示，也供自动化性能测试读取）
+struct RenderStatistics {
+    double frameTimeMs = 0.0;           // 最近一帧重绘耗时
+    double averageFrameTimeMs = 0.0;    // 滑动平均
+    double fps = 0.0;
+    double pickTimeMs = 0.0;            // 最近一次拾取耗时
+    std::size_t triangles = 0;          // 显示形状的三角形数（自有计数，含实例）
+    std::size_t renderedTriangles = 0;  // OCCT统计的实际绘制三角形数
+    std::size_t drawCalls = 0;          // OCCT统计的图元数组数
+    std::size_t presentations = 0;      // 显示的交互对象数
+    std::size_t structures = 0;         // OCCT统计的结构数
+    std::size_t gpuMemoryBytes = 0;     // 网格与显示缓冲区估算
+    std::size_t pendingMeshJobs = 0;
+    std::map<std::string, std::string> occtCounters;    // OCCT原始统计项
+};
+
+// 预览槽位：每个槽位保留一个持久的预览表示
+enum class PreviewSlot {
+    Generic,
+    Hole,
+    Transform,
+    Feature,
+    Boolean,
+    FaultyEdges     // 导致运算失败的边
+};
+
 class QtOccView : public QWidget,protected AIS_ViewController {
     Q_OBJECT
 
@@ -46,15 +88,42 @@ public:
     void DisplayShape(const cad_core::ShapePtr& shape);
     void RemoveShape(const cad_core::ShapePtr& shape);
     void ClearShapes();
+    
+    // 显示/隐藏：保留表示和选择结构，只从视图中擦除
+    void SetShapeVisible(const cad_core::ShapePtr& shape, bool visible);
+    bool IsShapeVisible(const cad_core::ShapePtr& shape) const;
+    
+    // 表示池：移除的形状保留表示，相同几何再次显示（撤销/重做）时直接复用
+    void SetPresentationPoolLimit(std::size_t count);
+    void ClearPresentationPool();
 
 	// 预览形状显示
     void DisplayPreviewShape(const cad_core::ShapePtr& shape);
     void ClearPreviewShapes();
+    
+    // 预览通道：形状变化时 SetShape 后增量重算，移动时只更新局部变换
+    void ShowPreview(PreviewSlot slot, const TopoDS_Shape& shape);
+    void MovePreview(PreviewSlot slot, const gp_Trsf& transformation);
+    void HidePreview(PreviewSlot slot);
+    bool IsPreviewVisible(PreviewSlot slot) const;
     void EnablePreviewDragging(const gp_Pln& plane);// 预览拖拽
     void DisablePreviewDragging();
 
     void RedrawAll();
     virtual QPaintEngine* paintEngine() const;
+
+    // 后台网格化服务
+    MeshingService* GetMeshingService() const { return m_meshingService; }
+    
+    // 网格驻留管理（内存预算）
+    MeshResidencyManager* GetMeshResidencyManager() const { return m_meshResidency.get(); }
+    
+    // 渲染统计
+    void SetStatisticsOverlayVisible(bool visible);
+    bool IsStatisticsOverlayVisible() const { return m_statsOverlayVisible; }
+    void SetStatisticsCollectionEnabled(bool enabled);
+    RenderStatistics GetRenderStatistics() const;
+    RenderStatistics MeasureRedraw(int frames);
     
     // 背景和外观
     void SetBackgroundColor(const QColor& color);
@@ -69,7 +138,8 @@ public:
     // 用于操作的边和面选择
     void ClearEdgeSelection();
     std::vector<TopoDS_Edge> GetSelectedTopoEdges() const { return m_selectedEdges; }
-    std::map<cad_core::ShapePtr, std::vector<TopoDS_Edge>> GetSelectedEdgesByShape() const;
+    // 按实体分组，实体顺序为其第一条边被选中的顺序
+    std::vector<std::pair<cad_core::ShapePtr, std::vector<TopoDS_Edge>>> GetSelectedEdgesByShape() const;
     void HighlightEdge(const TopoDS_Edge& edge);
     void HighlightVertex(const TopoDS_Vertex& vertex);
     void HighlightFace(const TopoDS_Face& face);
@@ -147,12 +217,59 @@ private:
     // 选择管理器
     std::unique_ptr<cad_core::SelectionManager> m_selectionManager;
     
-    // 用于选择同步的形状映射
-    std::map<cad_core::ShapePtr, Handle(AIS_Shape)> m_shapeToAIS;
+    // 用于选择同步的形状映射（AIS_Shape 或共享几何的 AIS_ConnectedInteractive 实例）
+    std::map<cad_core::ShapePtr, Handle(AIS_InteractiveObject)> m_shapeToAIS;
+    
+    // 实例化：共享同一 TShape（仅位置不同）的形状共用一个母版表示
+    using InstanceKey = std::pair<const TopoDS_TShape*, int>;
+    struct InstanceGroup {
+        Handle(AIS_Shape) master;                   // 单位位置的母版，不直接显示
+        std::vector<cad_core::ShapePtr> members;    // 第一个成员拥有网格状态和网格任务，原形状移除后由下一个成员接管
+    };
+    std::map<InstanceKey, InstanceGroup> m_instanceGroups;
+
+    // 后台网格化：任务编号 -> 等待网格的形状
+    MeshingService* m_meshingService;
+    std::map<quint64, cad_core::ShapePtr> m_pendingMeshes;
+    
+    // 每个显示形状的网格状态，用于视图相关的自适应精度
+    struct ShapeMeshState {
+        Bnd_Box box;
+        double diagonal = 0.0;          // 包围盒对角线
+        gp_Pnt center;                  // 包围盒中心
+        double deflection = 0.0;        // 当前网格弦高
+        double targetDeflection = 0.0;  // 正在生成的网格弦高
+        std::size_t triangles = 0;
+        quint64 pendingJob = 0;
+        bool meshFailed = false;        // 网格化失败，保持包围盒显示，不再自动重试
+        bool isInstance = false;        // 实例：网格由组内第一个成员管理，只参与可见性和驻留统计
+    };
+    std::map<cad_core::ShapePtr, ShapeMeshState> m_meshStates;
+    QTimer* m_tessellationTimer;
+    std::unique_ptr<MeshResidencyManager> m_meshResidency;
+    
+    // 表示池：按 TopoDS_Shape（TShape+位置）索引已擦除但保留的表示
+    struct PooledPresentation {
+        Handle(AIS_Shape) object;
+        ShapeMeshState meshState;
+        std::size_t bytes = 0;
+        bool hidden = false;    // 入池时被用户隐藏，复用时保持隐藏
+    };
+    NCollection_DataMap<TopoDS_Shape, PooledPresentation, TopTools_ShapeMapHasher> m_presentationPool;
+    std::deque<TopoDS_Shape> m_poolOrder;   // 入池顺序，超出上限时先释放最早的
+    std::size_t m_presentationPoolLimit;
+    std::set<cad_core::ShapePtr> m_hiddenShapes;
+    
+    // 渲染统计
+    RenderStatistics m_renderStats;
+    bool m_statsOverlayVisible;
+    bool m_statsCollectionEnabled;
+    Handle(AIS_TextLabel) m_statsLabel;
+    QElapsedTimer m_statsClock;     // 叠加层文字上次更新的时间，只在实际重绘前按间隔更新
     
     // 当前选择状态（单选模式）
     cad_core::ShapePtr m_currentSelectedShape;
-    Handle(AIS_Shape) m_currentSelectedAIS;
+    Handle(AIS_InteractiveObject) m_currentSelectedAIS;
     
     // 用于倒角/倒圆等操作的边选择状态
     std::vector<TopoDS_Edge> m_selectedEdges;
@@ -167,8 +284,8 @@ private:
     std::vector<TopoDS_Face> m_selectedFaces;
     std::vector<Handle(AIS_InteractiveObject)> m_highlightedFaces;
 
-	// 用于预览形状的显示
-    std::vector<Handle(AIS_InteractiveObject)> m_previewAISShapes;
+	// 预览槽位（隐藏时只擦除，表示保留复用）
+    std::map<PreviewSlot, Handle(AIS_Shape)> m_previewSlots;
 
 	// 拖拽预览相关
     bool m_isDraggingPreview;
@@ -182,10 +299,39 @@ private:
     
     void InitializeOCC();
     void RedrawView();
+    void RenderFrame();
+    void RecordFrameTime(double milliseconds);
+    void ApplyStatisticsParams();
+    void UpdateStatisticsOverlay();
     void HandleSelection(const QPoint& point);
+    void HandleSelectionImpl(const QPoint& point);
+    void CancelPendingMesh(const cad_core::ShapePtr& shape);
+    void RequestShapeMesh(const cad_core::ShapePtr& shape, double coarseDeflection,
+                          double deflection, bool force);
+    double WorldSizePerPixel(const gp_Pnt& point) const;
+    void ScheduleTessellationUpdate();
+    void ActivateShapeSelectionModes(const Handle(AIS_InteractiveObject)& object);
+    bool IsBoxOnScreen(const Bnd_Box& box) const;
+    void UpdateMeshResidency();
+    void EvictShapeMesh(const cad_core::ShapePtr& shape);
+    void RestoreShapeMesh(const cad_core::ShapePtr& shape);
+    bool ParkPresentation(const cad_core::ShapePtr& shape, const Handle(AIS_InteractiveObject)& object);
+    bool ReusePresentation(const cad_core::ShapePtr& shape);
+    void DropPooledPresentation(const TopoDS_Shape& shape);
+    void UpdatePooledBytes();
+    void ReleaseSelection(const Handle(AIS_InteractiveObject)& object);
+    static InstanceKey MakeInstanceKey(const TopoDS_Shape& shape);
+    bool DisplayAsInstance(const cad_core::ShapePtr& shape);
+    void ReleaseInstance(const cad_core::ShapePtr& shape);
+    void RefreshInstances(const cad_core::ShapePtr& shape);
+    cad_core::ShapePtr FindShapeForObject(const Handle(AIS_InteractiveObject)& object) const;
+    TopoDS_Shape ResolveSubShape(const cad_core::ShapePtr& parent, const TopoDS_Shape& subShape) const;
     
 private slots:
     void OnRedrawTimer();
+    void OnMeshReady(quint64 jobId, bool isFinal);
+    void OnMeshFailed(quint64 jobId);
+    void UpdateViewDependentTessellation();
 };
 
 } // namespace cad_ui
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <gp_Pnt.hxx>
+
+#include "cad_core/Shape.h"
+
+namespace cad_ui {
+
+class OffscreenView;
+
+// 基准测试场景
+struct BenchmarkScene {
+    std::string name;
+    std::vector<cad_core::ShapePtr> shapes;
+};
+
+// 单个场景的测试结果
+struct BenchmarkResult {
+    std::string scene;
+    int shapes = 0;
+    int frames = 0;
+    double meshTimeMs = 0.0;    // 预先网格化耗时（不计入帧时间）
+    double firstFrameMs = 0.0;  // 首帧（含显示缓冲上传）
+    double minFrameMs = 0.0;
+    double meanFrameMs = 0.0;
+    double p95FrameMs = 0.0;
+    double maxFrameMs = 0.0;
+    double fps = 0.0;
+    std::size_t triangles = 0;
+    std::vector<std::string> images;    // 导出的截图路径
+};
+
+// 视图性能基准
+// 在离屏视图中加载标准场景，沿脚本化的相机路径（环绕+推拉）逐帧计时，
+// 并可按间隔导出截图用于视觉回归对比。相机路径只与帧序号有关，每次运行完全一致。
+class ViewBenchmark {
+public:
+    explicit ViewBenchmark(OffscreenView& view);
+
+    void SetFrameCount(int frames) { m_frameCount = frames; }
+    void SetWarmupFrames(int frames) { m_warmupFrames = frames; }
+    void SetRelativeDeflection(double deflection) { m_relativeDeflection = deflection; }
+    // 每隔 interval 帧导出一张截图，0 表示不导出
+    void SetImageOutput(const std::string& directory, int interval, const std::string& extension = "png");
+
+    // 标准场景："boxes" "spheres" "instanced" "mixed"
+    static std::vector<std::string> GetStandardSceneNames();
+    static BenchmarkScene CreateStandardScene(const std::string& name, int count);
+
+    BenchmarkResult Run(const BenchmarkScene& scene);
+
+    // 输出结果报告（JSON）
+    static std::string ToJson(const std::vector<BenchmarkResult>& results);
+
+private:
+    OffscreenView& m_view;
+    int m_frameCount;
+    int m_warmupFrames;
+    double m_relativeDeflection;
+    std::string m_imageDirectory;
+    int m_imageInterval;
+    std::string m_imageExtension;
+
+    void ApplyCameraPath(int frame, const gp_Pnt& center, double radius);
+};
+
+} // namespace cad_ui
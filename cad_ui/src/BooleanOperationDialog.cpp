@@ -1,17 +1,89 @@
 ﻿#include "cad_ui/BooleanOperationDialog.h"
+#include "cad_ui/MeshingService.h"
+#include "cad_core/BooleanOperations.h"
 #include <QApplication>
 #include <QMessageBox>
 #include <QSplitter>
+#include <QRunnable>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <Standard_Failure.hxx>
 #pragma execution_character_set("utf-8")
 
 namespace cad_ui {
 
+// 一次预览计算：工作线程只写 result，完成后通过排队信号交给GUI线程
+struct BooleanPreviewTask {
+    quint64 generation = 0;
+    cad_core::BooleanOperations::BooleanType type = cad_core::BooleanOperations::BooleanType::Union;
+    std::vector<cad_core::ShapePtr> targets;
+    std::vector<cad_core::ShapePtr> tools;
+    cad_core::BooleanOptions options;
+    cad_core::CancellationTokenPtr token;
+    cad_core::ShapePtr result;
+};
+
+namespace {
+
+// 预览结果的相对弦高，与视图默认的自动三角化精度相当，显示时不必再次网格化
+const double kPreviewRelativeDeflection = 0.002;
+
+// 拓扑副本：工作线程不读原形状，避免与GUI线程写回网格冲突
+std::vector<cad_core::ShapePtr> CopyShapes(const std::vector<cad_core::ShapePtr>& shapes) {
+    std::vector<cad_core::ShapePtr> copies;
+    copies.reserve(shapes.size());
+    for (const auto& shape : shapes) {
+        if (!shape || shape->GetOCCTShape().IsNull()) {
+            continue;
+        }
+        BRepBuilderAPI_Copy copier(shape->GetOCCTShape(), Standard_False, Standard_False);
+        copies.push_back(std::make_shared<cad_core::Shape>(copier.Shape()));
+    }
+    return copies;
+}
+
+cad_core::BooleanOperations::BooleanType ToCoreType(BooleanOperationType type) {
+    switch (type) {
+        case BooleanOperationType::Intersection:
+            return cad_core::BooleanOperations::BooleanType::Intersection;
+        case BooleanOperationType::Difference:
+            return cad_core::BooleanOperations::BooleanType::Difference;
+        default:
+            return cad_core::BooleanOperations::BooleanType::Union;
+    }
+}
+
+} // anonymous namespace
+
 BooleanOperationDialog::BooleanOperationDialog(BooleanOperationType operationType, QWidget* parent)
-    : QDialog(parent), m_operationType(operationType), m_selectingTargets(false), m_selectingTools(false) {
+    : QDialog(parent), m_operationType(operationType), m_selectingTargets(false), m_selectingTools(false),
+      m_previewGeneration(0), m_booleanOptions(cad_core::BooleanOperations::DefaultOptions()) {
     setupUI();
     setModal(false); // Allow interaction with main window for selection
     setWindowFlags(Qt::Dialog | Qt::WindowStaysOnTopHint);
     resize(400, 500);
+    
+    m_previewPool = new QThreadPool(this);
+    m_previewPool->setMaxThreadCount(2);
+    
+    // 连续选择时合并为一次计算
+    m_previewTimer = new QTimer(this);
+    m_previewTimer->setSingleShot(true);
+    m_previewTimer->setInterval(150);
+    connect(m_previewTimer, &QTimer::timeout, this, &BooleanOperationDialog::startPreview);
+    connect(this, &BooleanOperationDialog::previewFinished, this, &BooleanOperationDialog::onPreviewFinished,
+            Qt::QueuedConnection);
+    
+    // 对话框关闭（确定或取消）时撤掉预览
+    connect(this, &QDialog::finished, this, [this]() { cancelPreview(); });
+}
+
+BooleanOperationDialog::~BooleanOperationDialog() {
+    // 工作线程持有本对话框的信号，销毁前取消并等待其结束
+    if (m_previewTask && m_previewTask->token) {
+        m_previewTask->token->Cancel();
+    }
+    m_previewPool->waitForDone();
 }
 
 void BooleanOperationDialog::setupUI() {
@@ -135,8 +207,16 @@ void BooleanOperationDialog::setupUI() {
     m_buttonLayout = new QHBoxLayout();
     m_buttonLayout->setSpacing(8);
     
+    // 预览状态
+    m_previewStatus = new QLabel(this);
+    m_previewStatus->setStyleSheet("color: #666666; font-style: italic;");
+    m_mainLayout->addWidget(m_previewStatus);
+    
+    // 预览按钮作为开关，默认开启：选择变化时自动在后台计算
     m_previewButton = new QPushButton("预览", this);
     m_previewButton->setMinimumSize(80, 32);
+    m_previewButton->setCheckable(true);
+    m_previewButton->setChecked(true);
     m_previewButton->setEnabled(false);
     
     m_buttonLayout->addWidget(m_previewButton);
@@ -161,8 +241,11 @@ void BooleanOperationDialog::setupUI() {
         connect(m_toolSelectButton, &QPushButton::clicked, this, &BooleanOperationDialog::onToolSelectionClicked);
     }
     
+    connect(m_previewButton, &QPushButton::toggled, this, &BooleanOperationDialog::onPreviewToggled);
+    
     connect(m_okButton, &QPushButton::clicked, [this]() {
-        emit operationRequested(m_operationType, m_targetObjects, m_toolObjects);
+        // 预览已算完时直接使用其结果，避免重复运算
+        emit operationRequested(m_operationType, m_targetObjects, m_toolObjects, m_previewResult);
         accept();
     });
     
@@ -309,17 +392,112 @@ void BooleanOperationDialog::updateSelectionDisplay() {
     }
     
     // Update button states
-    bool canExecute = false;
+    const bool executable = canExecute();
+    m_okButton->setEnabled(executable);
+    m_previewButton->setEnabled(executable);
+    
+    schedulePreview();
+}
+
+void BooleanOperationDialog::setBooleanOptions(const cad_core::BooleanOptions& options) {
+    m_booleanOptions = options;
+    schedulePreview();
+}
+
+bool BooleanOperationDialog::canExecute() const {
     if (m_operationType == BooleanOperationType::Union) {
         // Union: need at least 2 objects total (targets + tools)
-        canExecute = (m_targetObjects.size() + m_toolObjects.size()) >= 2;
+        return (m_targetObjects.size() + m_toolObjects.size()) >= 2;
+    }
+    // Intersection/Difference: need both targets and tools
+    return !m_targetObjects.empty() && !m_toolObjects.empty();
+}
+
+void BooleanOperationDialog::onPreviewToggled(bool enabled) {
+    if (enabled) {
+        schedulePreview();
     } else {
-        // Intersection/Difference: need both targets and tools
-        canExecute = !m_targetObjects.empty() && !m_toolObjects.empty();
+        cancelPreview();
+    }
+}
+
+void BooleanOperationDialog::schedulePreview() {
+    // 选择已变化，之前的结果和进行中的计算都作废
+    cancelPreview();
+    if (m_previewButton->isChecked() && canExecute()) {
+        m_previewStatus->setText("正在计算预览...");
+        m_previewTimer->start();
+    }
+}
+
+void BooleanOperationDialog::cancelPreview() {
+    m_previewTimer->stop();
+    ++m_previewGeneration;
+    if (m_previewTask && m_previewTask->token) {
+        m_previewTask->token->Cancel();
+    }
+    m_previewTask.reset();
+    
+    if (m_previewResult) {
+        m_previewResult.reset();
+        emit previewCleared();
+    }
+    m_previewStatus->clear();
+}
+
+void BooleanOperationDialog::startPreview() {
+    if (!m_previewButton->isChecked() || !canExecute()) {
+        return;
+    }
+    
+    auto task = std::make_shared<BooleanPreviewTask>();
+    task->generation = m_previewGeneration;
+    task->type = ToCoreType(m_operationType);
+    task->targets = CopyShapes(m_targetObjects);
+    task->tools = CopyShapes(m_toolObjects);
+    task->options = m_booleanOptions;
+    task->token = std::make_shared<cad_core::CancellationToken>();
+    m_previewTask = task;
+    
+    auto* runnable = QRunnable::create([this, task]() {
+        if (!task->token->IsCancelled()) {
+            try {
+                cad_core::ShapePtr result = cad_core::BooleanOperations::Perform(
+                    task->type, task->targets, task->tools, task->options, task->token);
+                
+                // 结果是新形状，可在工作线程上直接网格化
+                if (result && !task->token->IsCancelled()) {
+                    const TopoDS_Shape& shape = result->GetOCCTShape();
+                    BRepMesh_IncrementalMesh mesher(
+                        shape, MeshingService::ComputeDeflection(shape, kPreviewRelativeDeflection),
+                        Standard_False, 0.5, Standard_False);
+                }
+                task->result = result;
+            } catch (const Standard_Failure&) {
+                task->result.reset();
+            }
+        }
+        emit previewFinished(task->generation);
+    });
+    m_previewPool->start(runnable);
+}
+
+void BooleanOperationDialog::onPreviewFinished(quint64 generation) {
+    // 选择已变化或预览已关闭：丢弃过期结果
+    if (!m_previewTask || m_previewTask->generation != generation || generation != m_previewGeneration) {
+        return;
+    }
+    
+    cad_core::ShapePtr result = m_previewTask->result;
+    m_previewTask.reset();
+    if (!result) {
+        m_previewStatus->setText("预览失败：布尔运算没有结果");
+        return;
     }
     
-    m_okButton->setEnabled(canExecute);
-    m_previewButton->setEnabled(canExecute);
+    m_previewResult = result;
+    m_previewStatus->setText("预览已更新");
+    emit previewReady(result);
 }
 
 QString BooleanOperationDialog::getOperationTitle() const {
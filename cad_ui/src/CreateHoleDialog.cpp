@@ -1,6 +1,7 @@
 ﻿#include "cad_ui/CreateHoleDialog.h"
 #include "cad_ui/QtOccView.h"
 #include "cad_core/ShapeFactory.h"
+#include "cad_feature/PatternFeature.h"
 #include <BRep_Tool.hxx>
 #include <Geom_Surface.hxx>
 #include <Geom_Plane.hxx>
@@ -8,15 +9,16 @@
 #include <gp_Ax3.hxx>
 #include <gp_Pnt.hxx>
 #include <gp_Trsf.hxx>
-#include <BRepBuilderAPI_Transform.hxx>
 #include <QMessageBox>
 #include <QFormLayout>
+#include <QSignalBlocker>
 #pragma execution_character_set("utf-8")
 
 namespace cad_ui {
 
 CreateHoleDialog::CreateHoleDialog(QtOccView* viewer, QWidget* parent)
-    : QDialog(parent), m_isSelectingFace(false), m_viewer(viewer), m_previewActive(false) {
+    : QDialog(parent), m_isSelectingFace(false), m_viewer(viewer), m_previewActive(false),
+      m_previewDiameter(0.0), m_previewDepth(0.0), m_previewCount(0), m_previewSpacing(0.0) {
     setupUI();
     setModal(false);
     setWindowFlags(Qt::Dialog | Qt::WindowStaysOnTopHint);
@@ -76,6 +78,18 @@ void CreateHoleDialog::setupUI() {
     m_zCoordSpinBox->setValue(0.0);
     parametersLayout->addRow("坐标 Z:", m_zCoordSpinBox);
 
+    parametersLayout->addRow(new QLabel("--- 阵列（沿面的 X 方向） ---"));
+    m_countSpinBox = new QSpinBox(this);
+    m_countSpinBox->setRange(1, 100);
+    m_countSpinBox->setValue(1);
+    parametersLayout->addRow("数量:", m_countSpinBox);
+
+    m_spacingSpinBox = new QDoubleSpinBox(this);
+    m_spacingSpinBox->setRange(0.1, 1000.0);
+    m_spacingSpinBox->setValue(10.0);
+    m_spacingSpinBox->setSuffix(" mm");
+    parametersLayout->addRow("间距:", m_spacingSpinBox);
+
     // --- 按钮组 ---
     QHBoxLayout* buttonLayout = new QHBoxLayout();
     m_okButton = new QPushButton("确定", this);
@@ -102,6 +116,8 @@ void CreateHoleDialog::setupUI() {
     connect(m_xCoordSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &CreateHoleDialog::onParametersChanged);
     connect(m_yCoordSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &CreateHoleDialog::onParametersChanged);
     connect(m_zCoordSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &CreateHoleDialog::onParametersChanged);
+    connect(m_countSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &CreateHoleDialog::onParametersChanged);
+    connect(m_spacingSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &CreateHoleDialog::onParametersChanged);
 }
 
 void CreateHoleDialog::onSelectFaceClicked() {
@@ -179,8 +195,9 @@ void CreateHoleDialog::onSelectionFinished() {
             m_viewer->EnablePreviewDragging(plane->Pln());
         }
 
-        // 激活并显示
+        // 激活并显示（预览可能已被隐藏，重新发送圆柱）
         m_previewActive = true;
+        m_previewShape.reset();
         onParametersChanged();
        
     }
@@ -220,19 +237,41 @@ void CreateHoleDialog::onAccept() {
     double x = m_xCoordSpinBox->value();
     double y = m_yCoordSpinBox->value();
     double z = m_zCoordSpinBox->value();
+    int count = m_countSpinBox->value();
+    double spacing = m_spacingSpinBox->value();
 
-    emit operationRequested(m_targetShape, m_selectedFace, diameter, depth, x, y, z);
+    emit operationRequested(m_targetShape, m_selectedFace, diameter, depth, x, y, z, count, spacing);
     accept();
 }
 
 void CreateHoleDialog::onParametersChanged()
 {
     // 只有在预览激活时才更新
-    if (m_previewActive) {
-        cad_core::ShapePtr previewShape = createHolePreviewShape();
-        if (previewShape) {
-            emit previewRequested(previewShape);
+    if (!m_previewActive) {
+        return;
+    }
+    
+    // 预览只在尺寸或阵列变化时重建，拖动位置只发送新的变换
+    const double diameter = m_diameterSpinBox->value();
+    const double depth = m_depthSpinBox->value();
+    const int count = m_countSpinBox->value();
+    const double spacing = m_spacingSpinBox->value();
+    if (!m_previewShape || diameter != m_previewDiameter || depth != m_previewDepth ||
+        count != m_previewCount || spacing != m_previewSpacing) {
+        m_previewShape = createHolePreviewShape();
+        if (!m_previewShape) {
+            return;
         }
+        m_previewDiameter = diameter;
+        m_previewDepth = depth;
+        m_previewCount = count;
+        m_previewSpacing = spacing;
+        emit previewRequested(m_previewShape);
+    }
+    
+    gp_Trsf transformation;
+    if (computeHolePreviewTransformation(transformation)) {
+        emit previewMoved(transformation);
     }
 }
 
@@ -242,10 +281,32 @@ cad_core::ShapePtr CreateHoleDialog::createHolePreviewShape() const
         return nullptr;
     }
 
+    // 在原点创建圆柱体，再按与挖孔相同的阵列排成一排（局部 X 方向即面的 X 方向），
+    // 位置和方向由 computeHolePreviewTransformation 给出
+    cad_core::ShapePtr cylinder = cad_core::ShapeFactory::CreateCylinder(m_diameterSpinBox->value() / 2.0,
+                                                                         m_depthSpinBox->value());
+    if (!cylinder || m_countSpinBox->value() <= 1) {
+        return cylinder;
+    }
+
+    cad_feature::PatternFeature pattern("Hole Pattern Preview");
+    pattern.SetToolShape(cylinder);
+    pattern.SetPatternType(cad_feature::PatternType::Linear);
+    pattern.SetLinearDirection1(1.0, 0.0, 0.0, m_spacingSpinBox->value(), m_countSpinBox->value());
+    pattern.SetLinearDirection2(0.0, 1.0, 0.0, m_spacingSpinBox->value(), 1);
+    return pattern.CreatePreviewShape();
+}
+
+bool CreateHoleDialog::computeHolePreviewTransformation(gp_Trsf& transformation) const
+{
+    if (m_selectedFace.IsNull()) {
+        return false;
+    }
+
     Handle(Geom_Surface) surface = BRep_Tool::Surface(m_selectedFace);
     Handle(Geom_Plane) plane = Handle(Geom_Plane)::DownCast(surface);
     if (plane.IsNull()) {
-        return nullptr; // 预览只支持平面
+        return false; // 预览只支持平面
     }
 
     gp_Dir faceNormal = plane->Axis().Direction();
@@ -253,14 +314,10 @@ cad_core::ShapePtr CreateHoleDialog::createHolePreviewShape() const
         faceNormal.Reverse();
     }
 
-    // 创建圆柱体作为预览
-    auto cylinder = cad_core::ShapeFactory::CreateCylinder(m_diameterSpinBox->value() / 2.0, m_depthSpinBox->value());
-    if (!cylinder) {
-        return nullptr;
-    }
-
     gp_Trsf mainTransformation;
-    gp_Ax3 targetCoordinateSystem(gp_Pnt(m_xCoordSpinBox->value(), m_yCoordSpinBox->value(), m_zCoordSpinBox->value()), faceNormal.Reversed());
+    // 局部 X 对齐面的 X 方向，阵列预览与 MainWindow 挖孔时的排布方向一致
+    gp_Ax3 targetCoordinateSystem(gp_Pnt(m_xCoordSpinBox->value(), m_yCoordSpinBox->value(), m_zCoordSpinBox->value()),
+                                  faceNormal.Reversed(), plane->Position().XDirection());
     mainTransformation.SetTransformation(targetCoordinateSystem, gp::XOY());
 
     const double Z_FIGHTING_OFFSET = 1e-4; 
@@ -269,21 +326,20 @@ cad_core::ShapePtr CreateHoleDialog::createHolePreviewShape() const
     gp_Trsf offsetTransformation;
     offsetTransformation.SetTranslation(offsetVector);
     // 将偏移变换应用到主变换之前
-    gp_Trsf finalTransformation = offsetTransformation * mainTransformation;
-
-    // 应用最终的变换 
-    BRepBuilderAPI_Transform transformer(cylinder->GetOCCTShape(), finalTransformation, Standard_True);
-    if (transformer.IsDone()) {
-        return std::make_shared<cad_core::Shape>(transformer.Shape());
-    }
-
-    return nullptr;
+    transformation = offsetTransformation * mainTransformation;
+    return true;
 }
 
 void CreateHoleDialog::updateCenterCoords(double x, double y, double z) {
-    m_xCoordSpinBox->setValue(x);
-    m_yCoordSpinBox->setValue(y);
-    m_zCoordSpinBox->setValue(z);
+    // 三个坐标一起更新后只刷新一次预览
+    {
+        const QSignalBlocker blockX(m_xCoordSpinBox);
+        const QSignalBlocker blockY(m_yCoordSpinBox);
+        const QSignalBlocker blockZ(m_zCoordSpinBox);
+        m_xCoordSpinBox->setValue(x);
+        m_yCoordSpinBox->setValue(y);
+        m_zCoordSpinBox->setValue(z);
+    }
     onParametersChanged();
 }
 
@@ -172,10 +172,15 @@ void DocumentTree::OnToggleVisibility() {
         return;
     }
     
-    // Toggle visibility (placeholder - would need to be implemented with actual visibility logic)
+    // 删除线表示隐藏
     QFont font = item->font(0);
     font.setStrikeOut(!font.strikeOut());
     item->setFont(0, font);
+    
+    auto shape = item->data(0, Qt::UserRole).value<cad_core::ShapePtr>();
+    if (shape) {
+        emit ShapeVisibilityChanged(shape, !font.strikeOut());
+    }
 }
 
 } // namespace cad_ui
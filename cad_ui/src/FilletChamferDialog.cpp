@@ -1,23 +1,182 @@
 ﻿#include "cad_ui/FilletChamferDialog.h"
 #include "cad_ui/QtOccView.h"
+#include "cad_ui/MeshingService.h"
+#include "cad_core/FilletChamferOperations.h"
 #include <QApplication>
 #include <QMessageBox>
+#include <QRunnable>
+#include <limits>
+#include <BRep_Builder.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <Message_ProgressScope.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
 #pragma execution_character_set("utf-8")
 
 namespace cad_ui {
 
+// 一次预览计算：输入在GUI线程准备好，工作线程只写结果字段
+struct FilletChamferPreviewTask {
+    // 一个实体及其上选中的边
+    struct Body {
+        cad_core::ShapePtr copy;                 // 拓扑副本，工作线程只访问副本
+        std::vector<TopoDS_Edge> edges;          // 副本上对应的边
+        TopTools_IndexedMapOfShape copyEdges;    // 副本与原形状的边按相同序号对应
+        TopTools_IndexedMapOfShape sourceEdges;
+        cad_core::ShapePtr source;               // 原形状和选中的边，只用作半径缓存的键
+        std::vector<TopoDS_Edge> selectedEdges;
+    };
+    
+    quint64 generation = 0;
+    FilletChamferType type = FilletChamferType::Fillet;
+    double value = 0.0;
+    std::vector<Body> bodies;
+    cad_core::CancellationTokenPtr token;
+    
+    TopoDS_Compound result;
+    bool estimateRadiusRange = false;            // 边选择变化后先估计可行半径
+    cad_core::FilletRadiusCache* radiusCache = nullptr;   // 对话框所有，析构前等待任务结束
+    
+    int succeededBodies = 0;
+    std::vector<TopoDS_Edge> faultyEdges;        // 原形状上的边
+    cad_core::FilletRadiusRange radiusRange;
+    bool radiusRangeDone = false;
+};
+
+namespace {
+
+// 预览结果的相对弦高，与视图默认的自动三角化精度相当
+const double kPreviewRelativeDeflection = 0.002;
+
+// 调整参数时的合并间隔，微调框连续变化时只计算最后一次
+const int kPreviewDebounceMs = 200;
+
+// 可行半径二分细化的次数
+const int kRadiusRefineIterations = 6;
+
+// 各实体共用一个半径，可行范围取交集
+void EstimateRadiusRange(FilletChamferPreviewTask& task, Message_ProgressScope& scope) {
+    cad_core::FilletRadiusRange combined;
+    combined.valid = true;
+    combined.refined = true;
+    combined.maxRadius = std::numeric_limits<double>::max();
+    for (auto& body : task.bodies) {
+        if (scope.UserBreak()) {
+            return;
+        }
+        // 同一边集合的估计结果和二分进度跨预览保留，取消后重启的预览从中断处继续
+        cad_core::FilletRadiusRange progress;
+        task.radiusCache->Find(body.source, body.selectedEdges, progress);
+        cad_core::FilletRadiusRange range = cad_core::FilletChamferOperations::EstimateFilletRadiusRange(
+            body.copy, body.edges, true, kRadiusRefineIterations, scope.Next(), &progress);
+        task.radiusCache->Store(body.source, body.selectedEdges, progress);
+        combined.valid = combined.valid && range.valid;
+        combined.refined = combined.refined && range.refined;
+        combined.minRadius = std::max(combined.minRadius, range.minRadius);
+        combined.maxRadius = std::min(combined.maxRadius, range.maxRadius);
+    }
+    if (task.token->IsCancelled()) {
+        return;
+    }
+    combined.valid = combined.valid && combined.maxRadius > combined.minRadius;
+    task.radiusRange = combined;
+    task.radiusRangeDone = true;
+}
+
+void RunPreviewTask(FilletChamferPreviewTask& task) {
+    Handle(Message_ProgressIndicator) progress = new cad_core::CancellationProgress(task.token);
+    const size_t steps = task.bodies.size() * (task.estimateRadiusRange ? 2 : 1);
+    Message_ProgressScope scope(progress->Start(), "Fillet/Chamfer preview", static_cast<Standard_Real>(steps));
+    
+    if (task.estimateRadiusRange) {
+        EstimateRadiusRange(task, scope);
+    }
+    
+    BRep_Builder builder;
+    builder.MakeCompound(task.result);
+    for (auto& body : task.bodies) {
+        if (scope.UserBreak()) {
+            return;
+        }
+        
+        cad_core::ShapePtr result;
+        if (task.type == FilletChamferType::Fillet) {
+            result = cad_core::FilletChamferOperations::CreateFillet(body.copy, body.edges, task.value, scope.Next());
+        } else {
+            result = cad_core::FilletChamferOperations::CreateChamfer(body.copy, body.edges, task.value, scope.Next());
+        }
+        if (task.token->IsCancelled()) {
+            return;
+        }
+        
+        if (result) {
+            builder.Add(task.result, result->GetOCCTShape());
+            ++task.succeededBodies;
+            continue;
+        }
+        
+        // 失败时找出导致失败的边，换算回原形状上的边
+        cad_core::FilletFailureReport report = (task.type == FilletChamferType::Fillet)
+            ? cad_core::FilletChamferOperations::AnalyzeFilletFailure(body.copy, body.edges, task.value)
+            : cad_core::FilletChamferOperations::AnalyzeChamferFailure(body.copy, body.edges, task.value);
+        for (const auto& edge : report.faultyEdges) {
+            const Standard_Integer index = body.copyEdges.FindIndex(edge);
+            if (index > 0 && index <= body.sourceEdges.Extent()) {
+                task.faultyEdges.push_back(TopoDS::Edge(body.sourceEdges(index)));
+            }
+        }
+    }
+    
+    // 结果是新形状，可在工作线程上直接网格化
+    if (task.succeededBodies > 0 && !task.token->IsCancelled()) {
+        BRepMesh_IncrementalMesh mesher(
+            task.result, MeshingService::ComputeDeflection(task.result, kPreviewRelativeDeflection),
+            Standard_False, 0.5, Standard_False);
+    }
+}
+
+} // anonymous namespace
+
 FilletChamferDialog::FilletChamferDialog(FilletChamferType operationType, QtOccView* viewer, QWidget* parent)
-    : QDialog(parent), m_operationType(operationType), m_viewer(viewer), m_selectingEdges(false) {
+    : QDialog(parent), m_operationType(operationType), m_viewer(viewer), m_selectingEdges(false),
+      m_previewPool(nullptr), m_previewTimer(nullptr), m_previewGeneration(0), m_previewShown(false),
+      m_radiusRangeDirty(true) {
     setupUI();
     setModal(false); // Allow interaction with main window for selection
     setWindowFlags(Qt::Dialog | Qt::WindowStaysOnTopHint);
     resize(380, 450);
     
+    m_previewPool = new QThreadPool(this);
+    m_previewPool->setMaxThreadCount(2);
+    
+    // 连续加边或调整参数时合并为一次计算
+    m_previewTimer = new QTimer(this);
+    m_previewTimer->setSingleShot(true);
+    m_previewTimer->setInterval(kPreviewDebounceMs);
+    connect(m_previewTimer, &QTimer::timeout, this, &FilletChamferDialog::startPreview);
+    connect(this, &FilletChamferDialog::previewFinished, this, &FilletChamferDialog::onPreviewFinished,
+            Qt::QueuedConnection);
+    
+    // 对话框关闭（确定或取消）时撤掉预览
+    connect(this, &QDialog::finished, this, [this]() { cancelPreview(); });
+    
     // Initial sync with viewer edge selection
     syncWithViewerEdgeSelection();
     updateSelectionDisplay();
 }
 
+FilletChamferDialog::~FilletChamferDialog() {
+    // 工作线程持有本对话框的信号，销毁前取消并等待其结束
+    if (m_previewTask && m_previewTask->token) {
+        m_previewTask->token->Cancel();
+    }
+    m_previewPool->waitForDone();
+}
+
 void FilletChamferDialog::setupUI() {
     setWindowTitle(getOperationTitle());
     
@@ -97,7 +256,12 @@ void FilletChamferDialog::setupUI() {
             "QDoubleSpinBox { border: 2px solid #E0E0E0; border-radius: 4px; padding: 4px; }"
             "QDoubleSpinBox:focus { border-color: #009999; }"
         );
-        m_parametersLayout->addWidget(m_radiusSpinBox, row, 1);
+        m_parametersLayout->addWidget(m_radiusSpinBox, row++, 1);
+        
+        // 可行半径范围，选边后在后台估计
+        m_radiusRangeLabel = new QLabel(this);
+        m_radiusRangeLabel->setStyleSheet("color: #666666;");
+        m_parametersLayout->addWidget(m_radiusRangeLabel, row, 0, 1, 2);
         
         // Hide chamfer controls
         m_chamferDistance1Label = nullptr;
@@ -148,6 +312,7 @@ void FilletChamferDialog::setupUI() {
         // Hide radius control
         m_radiusLabel = nullptr;
         m_radiusSpinBox = nullptr;
+        m_radiusRangeLabel = nullptr;
         
         // Connect symmetric checkbox
         connect(m_symmetricCheckBox, &QCheckBox::toggled, this, &FilletChamferDialog::onSymmetricChanged);
@@ -161,8 +326,17 @@ void FilletChamferDialog::setupUI() {
     m_buttonLayout = new QHBoxLayout();
     m_buttonLayout->setSpacing(8);
     
+    // 预览状态
+    m_previewStatus = new QLabel(this);
+    m_previewStatus->setWordWrap(true);
+    m_previewStatus->setStyleSheet("color: #666666; font-style: italic;");
+    m_mainLayout->addWidget(m_previewStatus);
+    
+    // 预览按钮作为开关，默认开启：加边或改参数时自动在后台计算
     m_previewButton = new QPushButton("预览", this);
     m_previewButton->setMinimumSize(80, 32);
+    m_previewButton->setCheckable(true);
+    m_previewButton->setChecked(true);
     m_previewButton->setEnabled(false);
     
     m_buttonLayout->addWidget(m_previewButton);
@@ -183,6 +357,7 @@ void FilletChamferDialog::setupUI() {
     
     // Connect signals
     connect(m_edgeSelectButton, &QPushButton::clicked, this, &FilletChamferDialog::onEdgeSelectionClicked);
+    connect(m_previewButton, &QPushButton::toggled, this, &FilletChamferDialog::onPreviewToggled);
     
     connect(m_okButton, &QPushButton::clicked, [this]() {
         double radius = m_radiusSpinBox ? m_radiusSpinBox->value() : 0.0;
@@ -287,19 +462,176 @@ void FilletChamferDialog::onSymmetricChanged(bool symmetric) {
 void FilletChamferDialog::onParameterChanged() {
     // Enable preview when we have edges and valid parameters
     bool hasEdges = !m_selectedEdges.empty();
-    bool hasValidParams = true;
+    bool hasValidParams = hasValidParameters();
+    
+    m_previewButton->setEnabled(hasEdges && hasValidParams);
+    m_okButton->setEnabled(hasEdges && hasValidParams);
     
+    updateRadiusRangeDisplay();
+    schedulePreview();
+}
+
+bool FilletChamferDialog::hasValidParameters() const {
     if (m_radiusSpinBox) {
-        hasValidParams = m_radiusSpinBox->value() > 0;
-    } else if (m_chamferDistance1SpinBox) {
-        hasValidParams = m_chamferDistance1SpinBox->value() > 0;
+        return m_radiusSpinBox->value() > 0;
+    }
+    if (m_chamferDistance1SpinBox) {
+        bool valid = m_chamferDistance1SpinBox->value() > 0;
         if (!m_symmetricCheckBox->isChecked() && m_chamferDistance2SpinBox) {
-            hasValidParams = hasValidParams && m_chamferDistance2SpinBox->value() > 0;
+            valid = valid && m_chamferDistance2SpinBox->value() > 0;
         }
+        return valid;
     }
+    return true;
+}
+
+double FilletChamferDialog::getPreviewValue() const {
+    // 与确定时的运算一致：圆角用半径，倒角用距离1
+    if (m_radiusSpinBox) {
+        return m_radiusSpinBox->value();
+    }
+    return m_chamferDistance1SpinBox ? m_chamferDistance1SpinBox->value() : 0.0;
+}
+
+void FilletChamferDialog::onPreviewToggled(bool enabled) {
+    if (enabled) {
+        schedulePreview();
+    } else {
+        cancelPreview();
+    }
+}
+
+void FilletChamferDialog::schedulePreview() {
+    // 边或参数已变化，之前的结果和进行中的计算都作废
+    // 视图中的边选择在合并间隔结束时读取，此时已包含刚加入的边
+    if (!m_previewTimer) {
+        return;
+    }
+    cancelPreview();
+    if (m_previewButton->isChecked() && hasValidParameters()) {
+        m_previewTimer->start();
+    }
+}
+
+void FilletChamferDialog::cancelPreview() {
+    m_previewTimer->stop();
+    ++m_previewGeneration;
+    if (m_previewTask && m_previewTask->token) {
+        m_previewTask->token->Cancel();
+    }
+    m_previewTask.reset();
     
-    m_previewButton->setEnabled(hasEdges && hasValidParams);
-    m_okButton->setEnabled(hasEdges && hasValidParams);
+    if (m_previewShown) {
+        m_previewShown = false;
+        emit previewCleared();
+    }
+    m_previewStatus->clear();
+}
+
+void FilletChamferDialog::startPreview() {
+    if (!m_viewer || !m_previewButton->isChecked() || !hasValidParameters()) {
+        return;
+    }
+    
+    auto edgesByShape = m_viewer->GetSelectedEdgesByShape();
+    if (edgesByShape.empty()) {
+        return;
+    }
+    
+    auto task = std::make_shared<FilletChamferPreviewTask>();
+    task->generation = m_previewGeneration;
+    task->type = m_operationType;
+    task->value = getPreviewValue();
+    task->token = std::make_shared<cad_core::CancellationToken>();
+    
+    // 拓扑副本在GUI线程创建：工作线程不读原形状，避免与网格写回冲突
+    for (const auto& shapeEdgePair : edgesByShape) {
+        const cad_core::ShapePtr& source = shapeEdgePair.first;
+        if (!source || source->GetOCCTShape().IsNull() || shapeEdgePair.second.empty()) {
+            continue;
+        }
+        
+        FilletChamferPreviewTask::Body body;
+        body.source = source;
+        body.selectedEdges = shapeEdgePair.second;
+        BRepBuilderAPI_Copy copier(source->GetOCCTShape(), Standard_False, Standard_False);
+        body.copy = std::make_shared<cad_core::Shape>(copier.Shape());
+        TopExp::MapShapes(source->GetOCCTShape(), TopAbs_EDGE, body.sourceEdges);
+        TopExp::MapShapes(body.copy->GetOCCTShape(), TopAbs_EDGE, body.copyEdges);
+        for (const auto& edge : shapeEdgePair.second) {
+            const Standard_Integer index = body.sourceEdges.FindIndex(edge);
+            if (index > 0 && index <= body.copyEdges.Extent()) {
+                body.edges.push_back(TopoDS::Edge(body.copyEdges(index)));
+            }
+        }
+        if (!body.edges.empty()) {
+            task->bodies.push_back(std::move(body));
+        }
+    }
+    if (task->bodies.empty()) {
+        return;
+    }
+    
+    task->estimateRadiusRange = (m_operationType == FilletChamferType::Fillet) && m_radiusRangeDirty;
+    task->radiusCache = &m_radiusCache;
+    if (task->estimateRadiusRange && m_radiusRangeLabel) {
+        m_radiusRangeLabel->setText("正在估计可行半径...");
+    }
+    
+    m_previewTask = task;
+    m_previewStatus->setText("正在计算预览...");
+    
+    auto* runnable = QRunnable::create([this, task]() {
+        if (!task->token->IsCancelled()) {
+            try {
+                RunPreviewTask(*task);
+            } catch (const Standard_Failure&) {
+                task->succeededBodies = 0;
+            }
+        }
+        emit previewFinished(task->generation);
+    });
+    m_previewPool->start(runnable);
+}
+
+void FilletChamferDialog::onPreviewFinished(quint64 generation) {
+    // 边或参数已变化，或预览已关闭：丢弃过期结果
+    if (!m_previewTask || m_previewTask->generation != generation || generation != m_previewGeneration) {
+        return;
+    }
+    
+    std::shared_ptr<FilletChamferPreviewTask> task = m_previewTask;
+    m_previewTask.reset();
+    const QString operation = (m_operationType == FilletChamferType::Fillet) ? "圆角" : "倒角";
+    
+    if (task->radiusRangeDone) {
+        m_radiusRange = task->radiusRange;
+        m_radiusRangeDirty = false;
+        updateRadiusRangeDisplay();
+    }
+    
+    if (task->succeededBodies > 0) {
+        emit previewReady(task->result);
+        m_previewShown = true;
+    }
+    
+    // 失败的边在视图中单独标出
+    if (!task->faultyEdges.empty()) {
+        TopoDS_Compound faulty;
+        BRep_Builder builder;
+        builder.MakeCompound(faulty);
+        for (const auto& edge : task->faultyEdges) {
+            builder.Add(faulty, edge);
+        }
+        emit faultyEdgesChanged(faulty);
+        m_previewShown = true;
+        m_previewStatus->setText(QString("%1 条边无法%2，已在视图中标出，请减小尺寸或调整选择")
+                                 .arg(task->faultyEdges.size()).arg(operation));
+    } else if (task->succeededBodies < static_cast<int>(task->bodies.size())) {
+        m_previewStatus->setText(QString("预览失败：%1结果无效").arg(operation));
+    } else {
+        m_previewStatus->setText("预览已更新");
+    }
 }
 
 void FilletChamferDialog::updateSelectionDisplay() {
@@ -318,9 +650,44 @@ void FilletChamferDialog::updateSelectionDisplay() {
         m_edgeList->setVisible(false);
     }
     
+    // 边选择变化后可行半径需要重新估计
+    m_radiusRangeDirty = true;
+    if (m_radiusRangeLabel) {
+        m_radiusRangeLabel->clear();
+    }
+    
     onParameterChanged(); // Update button states
 }
 
+void FilletChamferDialog::updateRadiusRangeDisplay() {
+    if (!m_radiusRangeLabel) {
+        return;
+    }
+    if (m_radiusRangeDirty) {
+        return;
+    }
+    
+    if (!m_radiusRange.valid) {
+        m_radiusRangeLabel->setText("所选边无法圆角");
+        m_radiusRangeLabel->setStyleSheet("color: #CC3300; font-weight: bold;");
+        return;
+    }
+    
+    QString text = QString("可行半径: %1 ~ %2 mm")
+                   .arg(m_radiusRange.minRadius, 0, 'f', 2)
+                   .arg(m_radiusRange.maxRadius, 0, 'f', 2);
+    if (!m_radiusRange.refined) {
+        text += "（估计上界）";
+    }
+    if (m_radiusSpinBox->value() > m_radiusRange.maxRadius) {
+        text += "，当前半径超出范围";
+        m_radiusRangeLabel->setStyleSheet("color: #CC3300; font-weight: bold;");
+    } else {
+        m_radiusRangeLabel->setStyleSheet("color: #009999;");
+    }
+    m_radiusRangeLabel->setText(text);
+}
+
 QString FilletChamferDialog::getOperationTitle() const {
     return m_operationType == FilletChamferType::Fillet ? "圆角操作" : "倒角操作";
 }
@@ -11,6 +11,7 @@
 #include "cad_core/FilletChamferOperations.h"
 #include "cad_ui/CreateHoleDialog.h" 
 #include "cad_core/SelectionManager.h"
+#include "cad_feature/PatternFeature.h"
 #include <TopoDS.hxx>
 #include <BRep_Tool.hxx>
 #include <GProp_GProps.hxx>
@@ -20,6 +21,8 @@
 #include <Geom_Plane.hxx>
 #include <gp_Ax2.hxx>
 #include <BRepBuilderAPI_Transform.hxx>
+#include <BRep_Builder.hxx>
+#include <Standard_Failure.hxx>
 
 #include <iostream>
 #include <QApplication>
@@ -33,6 +36,7 @@
 #include <QFile>
 #include <QTextStream>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QToolButton>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
@@ -233,6 +237,12 @@ void MainWindow::CreateActions() {
     m_projectionModeGroup->addAction(m_viewOrthographicAction);
     m_projectionModeGroup->addAction(m_viewPerspectiveAction);
     
+    // 渲染统计叠加层
+    m_renderStatisticsAction = new QAction("Render &Statistics", this);
+    m_renderStatisticsAction->setShortcut(QKeySequence("F12"));
+    m_renderStatisticsAction->setCheckable(true);
+    m_renderStatisticsAction->setStatusTip("Show frame time, triangle and presentation statistics");
+    
     // Create actions with 30x30 icons (icon-only display)
     m_createBoxAction = new QAction("", this);
     QIcon boxIcon(":/icons/icons/Prim-Box.svg");
@@ -277,6 +287,33 @@ void MainWindow::CreateActions() {
     m_booleanDifferenceAction->setIcon(cutIcon);
     m_booleanDifferenceAction->setStatusTip("从一个形状中减去另一个形状");
     
+    // 布尔运算内核选项
+    m_booleanOptions = cad_core::BooleanOperations::DefaultOptions();
+    m_booleanUnionGlue = cad_core::BooleanOptions::GlueMode::Off;
+    
+    m_autoSimplifyAction = new QAction("Simplify &Results", this);
+    m_autoSimplifyAction->setCheckable(true);
+    m_autoSimplifyAction->setChecked(m_booleanOptions.simplify);
+    m_autoSimplifyAction->setStatusTip("Merge coplanar and co-cylindrical faces left by boolean operations");
+    
+    m_booleanParallelAction = new QAction("&Parallel Kernel", this);
+    m_booleanParallelAction->setCheckable(true);
+    m_booleanParallelAction->setChecked(m_booleanOptions.parallel);
+    m_booleanParallelAction->setStatusTip("Run boolean intersection steps on multiple threads");
+    
+    m_booleanOBBAction = new QAction("&Oriented Bounding Boxes", this);
+    m_booleanOBBAction->setCheckable(true);
+    m_booleanOBBAction->setChecked(m_booleanOptions.useOBB);
+    m_booleanOBBAction->setStatusTip("Skip sub-shape pairs whose oriented bounding boxes do not overlap");
+    
+    m_booleanGlueAction = new QAction("&Glue Touching Faces", this);
+    m_booleanGlueAction->setCheckable(true);
+    m_booleanGlueAction->setChecked(m_booleanUnionGlue != cad_core::BooleanOptions::GlueMode::Off);
+    m_booleanGlueAction->setStatusTip("Faster unions for inputs that only touch, such as imported assemblies");
+    
+    m_booleanFuzzyAction = new QAction("&Fuzzy Tolerance...", this);
+    m_booleanFuzzyAction->setStatusTip("Set an extra tolerance for nearly coincident geometry");
+    
 
     // Fillet and chamfer operations with 30x30 icons (icon-only display)
     m_filletAction = new QAction("", this);
@@ -372,6 +409,8 @@ void MainWindow::CreateMenus() {
     viewMenu->addSeparator();
     viewMenu->addAction(m_viewOrthographicAction);
     viewMenu->addAction(m_viewPerspectiveAction);
+    viewMenu->addSeparator();
+    viewMenu->addAction(m_renderStatisticsAction);
     
     // Create menu
     QMenu* createMenu = menuBar()->addMenu("&Create");
@@ -386,6 +425,14 @@ void MainWindow::CreateMenus() {
     booleanMenu->addAction(m_booleanUnionAction);
     booleanMenu->addAction(m_booleanIntersectionAction);
     booleanMenu->addAction(m_booleanDifferenceAction);
+    booleanMenu->addSeparator();
+    QMenu* booleanOptionsMenu = booleanMenu->addMenu("&Options");
+    booleanOptionsMenu->addAction(m_booleanParallelAction);
+    booleanOptionsMenu->addAction(m_booleanOBBAction);
+    booleanOptionsMenu->addAction(m_booleanGlueAction);
+    booleanOptionsMenu->addAction(m_booleanFuzzyAction);
+    booleanOptionsMenu->addSeparator();
+    booleanOptionsMenu->addAction(m_autoSimplifyAction);
     
     // Modify menu
     QMenu* modifyMenu = menuBar()->addMenu("&Modify");
@@ -925,6 +972,30 @@ void MainWindow::CreateDockWidgets() {
     m_propertyPanel = new PropertyPanel(this);
     m_propertyDock->setWidget(m_propertyPanel);
     addDockWidget(Qt::RightDockWidgetArea, m_propertyDock);
+    
+    // 重建分析面板，与属性面板叠放；只在面板打开时记录，关掉后不产生开销
+    m_profilerDock = new QDockWidget("Rebuild Profiler", this);
+    m_profilerPanel = new cad_feature::ProfilerPanel(this);
+    m_profilerPanel->SetProfiler(&m_featureManager->GetProfiler());
+    m_profilerDock->setWidget(m_profilerPanel);
+    addDockWidget(Qt::RightDockWidgetArea, m_profilerDock);
+    tabifyDockWidget(m_propertyDock, m_profilerDock);
+    m_propertyDock->raise();
+    m_profilerDock->hide();
+    
+    connect(m_profilerDock, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        m_featureManager->SetProfilingEnabled(visible);
+        if (visible) {
+            m_profilerPanel->UpdateRecords();
+        }
+    });
+    
+    // 面板打开时每次重建完自动刷新
+    m_featureManager->SetRebuildFinishedCallback([this]() {
+        if (m_featureManager->IsProfilingEnabled()) {
+            m_profilerPanel->UpdateRecords();
+        }
+    });
 }
 
 void MainWindow::ConnectSignals() {
@@ -947,6 +1018,7 @@ void MainWindow::ConnectSignals() {
     connect(m_viewShadedAction, &QAction::triggered, this, &MainWindow::OnViewShaded);
     connect(m_viewOrthographicAction, &QAction::triggered, this, &MainWindow::OnViewOrthographic);
     connect(m_viewPerspectiveAction, &QAction::triggered, this, &MainWindow::OnViewPerspective);
+    connect(m_renderStatisticsAction, &QAction::toggled, this, &MainWindow::OnToggleRenderStatistics);
     
     // Create actions
     connect(m_createBoxAction, &QAction::triggered, this, &MainWindow::OnCreateBox);
@@ -958,6 +1030,21 @@ void MainWindow::ConnectSignals() {
     connect(m_booleanUnionAction, &QAction::triggered, this, &MainWindow::OnBooleanUnion);
     connect(m_booleanIntersectionAction, &QAction::triggered, this, &MainWindow::OnBooleanIntersection);
     connect(m_booleanDifferenceAction, &QAction::triggered, this, &MainWindow::OnBooleanDifference);
+    connect(m_autoSimplifyAction, &QAction::toggled, this, &MainWindow::OnToggleAutoSimplify);
+    connect(m_booleanParallelAction, &QAction::toggled, this, [this](bool checked) {
+        m_booleanOptions.parallel = checked;
+        UpdateBooleanDialogOptions();
+    });
+    connect(m_booleanOBBAction, &QAction::toggled, this, [this](bool checked) {
+        m_booleanOptions.useOBB = checked;
+        UpdateBooleanDialogOptions();
+    });
+    connect(m_booleanGlueAction, &QAction::toggled, this, [this](bool checked) {
+        m_booleanUnionGlue = checked ? cad_core::BooleanOptions::GlueMode::Shift
+                                     : cad_core::BooleanOptions::GlueMode::Off;
+        UpdateBooleanDialogOptions();
+    });
+    connect(m_booleanFuzzyAction, &QAction::triggered, this, &MainWindow::OnSetBooleanFuzzyValue);
     
     // Modify actions
     connect(m_filletAction, &QAction::triggered, this, &MainWindow::OnFillet);
@@ -996,6 +1083,7 @@ void MainWindow::ConnectSignals() {
     // Document tree signals for selection synchronization
     connect(m_documentTree, &DocumentTree::ShapeSelected, this, &MainWindow::OnDocumentTreeShapeSelected);
     connect(m_documentTree, &DocumentTree::FeatureSelected, this, &MainWindow::OnDocumentTreeFeatureSelected);
+    connect(m_documentTree, &DocumentTree::ShapeVisibilityChanged, this, &MainWindow::OnDocumentTreeShapeVisibilityChanged);
 }
 
 void MainWindow::UpdateActions() {
@@ -1198,6 +1286,44 @@ void MainWindow::OnViewPerspective() {
     m_viewer->SetProjectionMode(false);
 }
 
+void MainWindow::OnToggleRenderStatistics(bool checked) {
+    m_viewer->SetStatisticsOverlayVisible(checked);
+}
+
+void MainWindow::OnToggleAutoSimplify(bool checked) {
+    // 同时作为未传选项的调用方的默认值
+    cad_core::BooleanOperations::SetAutoSimplify(checked);
+    m_booleanOptions.simplify = checked;
+    UpdateBooleanDialogOptions();
+}
+
+void MainWindow::OnSetBooleanFuzzyValue() {
+    bool ok = false;
+    double value = QInputDialog::getDouble(this, "Fuzzy Tolerance",
+                                           "Extra tolerance for nearly coincident geometry (0 = off):",
+                                           m_booleanOptions.fuzzyValue, 0.0, 1.0, 6, &ok);
+    if (ok) {
+        m_booleanOptions.fuzzyValue = value;
+        UpdateBooleanDialogOptions();
+    }
+}
+
+void MainWindow::UpdateBooleanDialogOptions() {
+    // 打开中的布尔对话框按新选项重新预览
+    if (m_currentBooleanDialog) {
+        m_currentBooleanDialog->setBooleanOptions(GetBooleanOptions(m_currentBooleanDialog->getOperationType()));
+    }
+}
+
+cad_core::BooleanOptions MainWindow::GetBooleanOptions(BooleanOperationType type) const {
+    // 粘合要求输入之间没有真正的相交，只用于贴合零件（如导入装配体）的并集；
+    // 差集、交集以及孔、阵列等特征切除都按一般情况求交
+    cad_core::BooleanOptions options = m_booleanOptions;
+    options.glue = (type == BooleanOperationType::Union) ? m_booleanUnionGlue
+                                                         : cad_core::BooleanOptions::GlueMode::Off;
+    return options;
+}
+
 void MainWindow::OnCreateBox() {
     CreateBoxDialog dialog(this);
     if (dialog.exec() == QDialog::Accepted) {
@@ -1339,6 +1465,13 @@ void MainWindow::OnDocumentTreeShapeSelected(const cad_core::ShapePtr& shape) {
     }
 }
 
+void MainWindow::OnDocumentTreeShapeVisibilityChanged(const cad_core::ShapePtr& shape, bool visible) {
+    // 隐藏只擦除表示，不修改文档
+    if (m_viewer && shape) {
+        m_viewer->SetShapeVisible(shape, visible);
+    }
+}
+
 void MainWindow::OnDocumentTreeFeatureSelected(const cad_feature::FeaturePtr& feature) {
     // Handle feature selection from document tree
     if (feature) {
@@ -1425,6 +1558,7 @@ void MainWindow::OnBooleanUnion() {
     if (m_currentBooleanDialog) {
         m_currentBooleanDialog->deleteLater();
         m_currentBooleanDialog = nullptr;
+        OnBooleanPreviewCleared();
     }
     
     // Create and show dialog
@@ -1435,6 +1569,11 @@ void MainWindow::OnBooleanUnion() {
             this, &MainWindow::OnSelectionModeChanged);
     connect(m_currentBooleanDialog, &BooleanOperationDialog::operationRequested,
             this, &MainWindow::OnBooleanOperationRequested);
+    connect(m_currentBooleanDialog, &BooleanOperationDialog::previewReady,
+            this, &MainWindow::OnBooleanPreviewReady);
+    connect(m_currentBooleanDialog, &BooleanOperationDialog::previewCleared,
+            this, &MainWindow::OnBooleanPreviewCleared);
+    m_currentBooleanDialog->setBooleanOptions(GetBooleanOptions(m_currentBooleanDialog->getOperationType()));
     
     m_currentBooleanDialog->show();
     m_currentBooleanDialog->raise();
@@ -1446,6 +1585,7 @@ void MainWindow::OnBooleanIntersection() {
     if (m_currentBooleanDialog) {
         m_currentBooleanDialog->deleteLater();
         m_currentBooleanDialog = nullptr;
+        OnBooleanPreviewCleared();
     }
     
     // Create and show dialog
@@ -1456,6 +1596,11 @@ void MainWindow::OnBooleanIntersection() {
             this, &MainWindow::OnSelectionModeChanged);
     connect(m_currentBooleanDialog, &BooleanOperationDialog::operationRequested,
             this, &MainWindow::OnBooleanOperationRequested);
+    connect(m_currentBooleanDialog, &BooleanOperationDialog::previewReady,
+            this, &MainWindow::OnBooleanPreviewReady);
+    connect(m_currentBooleanDialog, &BooleanOperationDialog::previewCleared,
+            this, &MainWindow::OnBooleanPreviewCleared);
+    m_currentBooleanDialog->setBooleanOptions(GetBooleanOptions(m_currentBooleanDialog->getOperationType()));
     
     m_currentBooleanDialog->show();
     m_currentBooleanDialog->raise();
@@ -1467,6 +1612,7 @@ void MainWindow::OnBooleanDifference() {
     if (m_currentBooleanDialog) {
         m_currentBooleanDialog->deleteLater();
         m_currentBooleanDialog = nullptr;
+        OnBooleanPreviewCleared();
     }
     
     // Create and show dialog
@@ -1477,6 +1623,11 @@ void MainWindow::OnBooleanDifference() {
             this, &MainWindow::OnSelectionModeChanged);
     connect(m_currentBooleanDialog, &BooleanOperationDialog::operationRequested,
             this, &MainWindow::OnBooleanOperationRequested);
+    connect(m_currentBooleanDialog, &BooleanOperationDialog::previewReady,
+            this, &MainWindow::OnBooleanPreviewReady);
+    connect(m_currentBooleanDialog, &BooleanOperationDialog::previewCleared,
+            this, &MainWindow::OnBooleanPreviewCleared);
+    m_currentBooleanDialog->setBooleanOptions(GetBooleanOptions(m_currentBooleanDialog->getOperationType()));
     
     m_currentBooleanDialog->show();
     m_currentBooleanDialog->raise();
@@ -1489,6 +1640,7 @@ void MainWindow::OnFillet() {
     if (m_currentFilletChamferDialog) {
         m_currentFilletChamferDialog->deleteLater();
         m_currentFilletChamferDialog = nullptr;
+        OnFilletChamferPreviewCleared();
     }
     
     // Create and show dialog
@@ -1499,6 +1651,12 @@ void MainWindow::OnFillet() {
             this, &MainWindow::OnSelectionModeChanged);
     connect(m_currentFilletChamferDialog, &FilletChamferDialog::operationRequested,
             this, &MainWindow::OnFilletChamferOperationRequested);
+    connect(m_currentFilletChamferDialog, &FilletChamferDialog::previewReady,
+            this, &MainWindow::OnFilletChamferPreviewReady);
+    connect(m_currentFilletChamferDialog, &FilletChamferDialog::faultyEdgesChanged,
+            this, &MainWindow::OnFilletChamferFaultyEdges);
+    connect(m_currentFilletChamferDialog, &FilletChamferDialog::previewCleared,
+            this, &MainWindow::OnFilletChamferPreviewCleared);
     
     m_currentFilletChamferDialog->show();
     m_currentFilletChamferDialog->raise();
@@ -1510,6 +1668,7 @@ void MainWindow::OnChamfer() {
     if (m_currentFilletChamferDialog) {
         m_currentFilletChamferDialog->deleteLater();
         m_currentFilletChamferDialog = nullptr;
+        OnFilletChamferPreviewCleared();
     }
     
     // Create and show dialog
@@ -1520,6 +1679,12 @@ void MainWindow::OnChamfer() {
             this, &MainWindow::OnSelectionModeChanged);
     connect(m_currentFilletChamferDialog, &FilletChamferDialog::operationRequested,
             this, &MainWindow::OnFilletChamferOperationRequested);
+    connect(m_currentFilletChamferDialog, &FilletChamferDialog::previewReady,
+            this, &MainWindow::OnFilletChamferPreviewReady);
+    connect(m_currentFilletChamferDialog, &FilletChamferDialog::faultyEdgesChanged,
+            this, &MainWindow::OnFilletChamferFaultyEdges);
+    connect(m_currentFilletChamferDialog, &FilletChamferDialog::previewCleared,
+            this, &MainWindow::OnFilletChamferPreviewCleared);
     
     m_currentFilletChamferDialog->show();
     m_currentFilletChamferDialog->raise();
@@ -1539,6 +1704,7 @@ void MainWindow::OnCreateHole() {
     connect(m_currentHoleDialog, &CreateHoleDialog::operationRequested, this, &MainWindow::OnHoleOperationRequested);
     connect(m_currentHoleDialog, &CreateHoleDialog::previewRequested, this, &MainWindow::OnHolePreviewRequested);
     connect(m_currentHoleDialog, &CreateHoleDialog::resetPreviewRequested, this, &MainWindow::OnHoleResetPreviewRequested);
+    connect(m_currentHoleDialog, &CreateHoleDialog::previewMoved, this, &MainWindow::OnHolePreviewMoved);
     connect(this, &MainWindow::faceSelectionInfo, m_currentHoleDialog, &CreateHoleDialog::updateCenterCoords);
     connect(m_viewer, &QtOccView::previewObjectMoved, m_currentHoleDialog, &CreateHoleDialog::updateCenterCoords);
     connect(m_currentHoleDialog, &QDialog::finished, this, [this](int result) {
@@ -1871,7 +2037,8 @@ void MainWindow::OnObjectSelected(const cad_core::ShapePtr& shape) {
 
 void MainWindow::OnBooleanOperationRequested(BooleanOperationType type, 
                                            const std::vector<cad_core::ShapePtr>& targets,
-                                           const std::vector<cad_core::ShapePtr>& tools) {
+                                           const std::vector<cad_core::ShapePtr>& tools,
+                                           const cad_core::ShapePtr& precomputedResult) {
     // Validate selection based on operation type
     if (type == BooleanOperationType::Union) {
         if (targets.empty()) {
@@ -1905,34 +2072,17 @@ void MainWindow::OnBooleanOperationRequested(BooleanOperationType type,
     
     m_ocafManager->StartTransaction(operationName.toStdString());
     
-    cad_core::ShapePtr result;
+    cad_core::ShapePtr result = precomputedResult;
     try {
-        if (type == BooleanOperationType::Union) {
-            // Combine all targets and tools for union
-            std::vector<cad_core::ShapePtr> allShapes = targets;
-            allShapes.insert(allShapes.end(), tools.begin(), tools.end());
-            result = cad_core::BooleanOperations::Union(allShapes);
-        } else if (type == BooleanOperationType::Intersection) {
-            // Use first target as base, intersect with all others
-            result = targets[0];
-            for (size_t i = 1; i < targets.size(); ++i) {
-                if (result) {
-                    result = cad_core::BooleanOperations::Intersection({result, targets[i]});
-                }
-            }
-            for (const auto& tool : tools) {
-                if (result) {
-                    result = cad_core::BooleanOperations::Intersection({result, tool});
-                }
-            }
-        } else if (type == BooleanOperationType::Difference) {
-            // Use first target as base, subtract all tools
-            result = targets[0];
-            for (const auto& tool : tools) {
-                if (result) {
-                    result = cad_core::BooleanOperations::Difference(result, tool);
-                }
+        // 对话框的实时预览已经算出结果时直接使用
+        if (!result) {
+            cad_core::BooleanOperations::BooleanType coreType = cad_core::BooleanOperations::BooleanType::Union;
+            if (type == BooleanOperationType::Intersection) {
+                coreType = cad_core::BooleanOperations::BooleanType::Intersection;
+            } else if (type == BooleanOperationType::Difference) {
+                coreType = cad_core::BooleanOperations::BooleanType::Difference;
             }
+            result = cad_core::BooleanOperations::Perform(coreType, targets, tools, GetBooleanOptions(type));
         }
         
         if (result) {
@@ -1994,6 +2144,37 @@ void MainWindow::OnBooleanOperationRequested(BooleanOperationType type,
     }
 }
 
+void MainWindow::OnBooleanPreviewReady(const cad_core::ShapePtr& result) {
+    if (m_viewer && result) {
+        m_viewer->ShowPreview(PreviewSlot::Boolean, result->GetOCCTShape());
+    }
+}
+
+void MainWindow::OnBooleanPreviewCleared() {
+    if (m_viewer) {
+        m_viewer->HidePreview(PreviewSlot::Boolean);
+    }
+}
+
+void MainWindow::OnFilletChamferPreviewReady(const TopoDS_Shape& result) {
+    if (m_viewer) {
+        m_viewer->ShowPreview(PreviewSlot::Feature, result);
+    }
+}
+
+void MainWindow::OnFilletChamferFaultyEdges(const TopoDS_Shape& edges) {
+    if (m_viewer) {
+        m_viewer->ShowPreview(PreviewSlot::FaultyEdges, edges);
+    }
+}
+
+void MainWindow::OnFilletChamferPreviewCleared() {
+    if (m_viewer) {
+        m_viewer->HidePreview(PreviewSlot::Feature);
+        m_viewer->HidePreview(PreviewSlot::FaultyEdges);
+    }
+}
+
 void MainWindow::OnFilletChamferOperationRequested(FilletChamferType type, 
                                                  const std::vector<cad_core::ShapePtr>& edges,
                                                  double radius, double distance1, double distance2) {
@@ -2018,24 +2199,26 @@ void MainWindow::OnFilletChamferOperationRequested(FilletChamferType type,
     try {
         bool anySuccess = false;
         
-        // Process each shape that has selected edges
+        // 各实体互不相关，并行计算；结果按选择顺序在同一事务中提交
+        std::vector<cad_core::EdgeBlendJob> jobs;
         for (const auto& shapeEdgePair : edgesByShape) {
-            cad_core::ShapePtr baseShape = shapeEdgePair.first;
-            const std::vector<TopoDS_Edge>& edges = shapeEdgePair.second;
-            
-            if (!baseShape || edges.empty()) {
-                continue;
-            }
-            
-            qDebug() << "Processing" << edges.size() << "edges on shape";
-            
-            // Perform the operation on this shape with its edges
-            cad_core::ShapePtr result;
-            if (type == FilletChamferType::Fillet) {
-                result = cad_core::FilletChamferOperations::CreateFillet(baseShape, edges, radius);
-            } else {
-                result = cad_core::FilletChamferOperations::CreateChamfer(baseShape, edges, distance1);
+            if (shapeEdgePair.first && !shapeEdgePair.second.empty()) {
+                jobs.push_back({shapeEdgePair.first, shapeEdgePair.second});
             }
+        }
+        
+        QElapsedTimer timer;
+        timer.start();
+        std::vector<cad_core::ShapePtr> results = (type == FilletChamferType::Fillet)
+            ? cad_core::FilletChamferOperations::CreateFillets(jobs, radius)
+            : cad_core::FilletChamferOperations::CreateChamfers(jobs, distance1);
+        const qint64 elapsedMs = timer.elapsed();
+        
+        // Process each shape that has selected edges
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            cad_core::ShapePtr baseShape = jobs[i].shape;
+            const std::vector<TopoDS_Edge>& edges = jobs[i].edges;
+            cad_core::ShapePtr result = results[i];
             
             if (result) {
                 QString shapeName = QString("%1 Result on Shape").arg(operationName);
@@ -2063,7 +2246,8 @@ void MainWindow::OnFilletChamferOperationRequested(FilletChamferType type,
             m_ocafManager->CommitTransaction();
             SetDocumentModified(true);
             UpdateActions();
-            statusBar()->showMessage(operationName + " completed successfully");
+            statusBar()->showMessage(QString("%1 completed successfully (%2 shape(s), %3 ms)")
+                                         .arg(operationName).arg(jobs.size()).arg(elapsedMs));
         } else {
             m_ocafManager->AbortTransaction();
             QMessageBox::warning(this, "Error", operationName + " operation failed.");
@@ -2177,30 +2361,32 @@ void MainWindow::OnTransformPreviewRequested(std::shared_ptr<cad_core::Transform
     }
     
     try {
-        // Clear any existing preview
-        if (m_previewActive) {
-            OnTransformResetRequested();
-        }
-        
-        // Get preview shapes from command
-        auto previewShapes = command->GetTransformedShapes();
-        
-        if (!previewShapes.empty()) {
-            // Store preview shapes
-            m_previewShapes = previewShapes;
-            m_previewActive = true;
-            
-            // Display preview shapes with a different color/style
-            for (const auto& shape : m_previewShapes) {
+        // 预览显示原形状的复合体，只在选择变化时重建；参数变化只更新预览的变换
+        auto sourceShapes = m_currentTransformDialog ? m_currentTransformDialog->getSelectedObjects()
+                                                     : std::vector<cad_core::ShapePtr>();
+        if (sourceShapes != m_previewShapes || m_transformPreviewSource.IsNull()) {
+            BRep_Builder builder;
+            TopoDS_Compound compound;
+            builder.MakeCompound(compound);
+            for (const auto& shape : sourceShapes) {
                 if (shape && shape->IsValid()) {
-                    // TODO: Set preview material/color (semi-transparent or different color)
-                    m_viewer->DisplayShape(shape);
+                    builder.Add(compound, shape->GetOCCTShape());
                 }
             }
+            m_previewShapes = sourceShapes;
+            m_transformPreviewSource = compound;
+        }
+        
+        if (!m_previewShapes.empty()) {
+            m_viewer->ShowPreview(PreviewSlot::Transform, m_transformPreviewSource);
+            m_viewer->MovePreview(PreviewSlot::Transform, command->GetTransformation());
+            m_previewActive = true;
             
             // Update display
             m_viewer->update();
         }
+    } catch (const Standard_Failure& e) {
+        QMessageBox::warning(this, "错误", QString("预览生成失败: %1").arg(e.GetMessageString()));
     } catch (const std::exception& e) {
         QMessageBox::warning(this, "错误", QString("预览生成失败: %1").arg(e.what()));
     }
@@ -2211,15 +2397,12 @@ void MainWindow::OnTransformResetRequested() {
         return;
     }
     
-    // Remove preview shapes from display
-    for (const auto& shape : m_previewShapes) {
-        if (shape) {
-            m_viewer->RemoveShape(shape);
-        }
-    }
+    // 只擦除预览，表示保留给下次预览复用
+    m_viewer->HidePreview(PreviewSlot::Transform);
     
     // Clear preview data
     m_previewShapes.clear();
+    m_transformPreviewSource.Nullify();
     m_previewActive = false;
     
     // Update display
@@ -2413,7 +2596,8 @@ void MainWindow::OnSketchModeExited() {
 
 void MainWindow::OnHoleOperationRequested(const cad_core::ShapePtr& targetShape, const TopoDS_Face& selectedFace,
     double diameter, double depth,
-    double x, double y, double z) {
+    double x, double y, double z,
+    int count, double spacing) {
 
     // 获取孔的方向 
     Handle(Geom_Surface) surface = BRep_Tool::Surface(selectedFace);
@@ -2427,26 +2611,32 @@ void MainWindow::OnHoleOperationRequested(const cad_core::ShapePtr& targetShape,
         holeDirection.Reverse();
     }
 
-    // 在原点创建圆柱体，然后移动它
-    // 在(0,0,0)创建一个朝向Z轴的圆柱体
-    auto cylinderTool = cad_core::ShapeFactory::CreateCylinder(diameter / 2.0, depth);
-    if (!cylinderTool) {
-        QMessageBox::warning(this, "错误", "在原点创建圆柱工具失败。");
+    // 从孔中心沿面的内侧钻入的圆柱
+    auto holeTool = cad_feature::PatternFeature::MakeHoleTool(gp_Pnt(x, y, z), holeDirection.Reversed(),
+                                                              diameter, depth);
+    if (!holeTool) {
+        QMessageBox::warning(this, "错误", "创建孔的圆柱工具失败。");
         return;
     }
 
-    gp_Trsf transformation;
-    gp_Ax3 targetCoordinateSystem(gp_Pnt(x, y, z), holeDirection.Reversed());
-    // 移动到目标坐标系
-    transformation.SetTransformation(targetCoordinateSystem, gp::XOY());
-
-    // 应用变换
-    BRepBuilderAPI_Transform transformer(cylinderTool->GetOCCTShape(), transformation, Standard_True);
-    auto transformedCylinder = std::make_shared<cad_core::Shape>(transformer.Shape());
+    // 单孔和多孔都走阵列：所有孔共享一个圆柱，一次布尔差集切除
+    cad_feature::PatternFeature pattern("Hole Pattern");
+    pattern.SetTargetShape(targetShape);
+    pattern.SetToolShape(holeTool);
+    pattern.SetPatternType(cad_feature::PatternType::Linear);
+    const gp_Dir& rowDirection = plane->Position().XDirection();
+    const gp_Dir& columnDirection = plane->Position().YDirection();
+    pattern.SetLinearDirection1(rowDirection.X(), rowDirection.Y(), rowDirection.Z(), spacing, count);
+    pattern.SetLinearDirection2(columnDirection.X(), columnDirection.Y(), columnDirection.Z(), spacing, 1);
+    pattern.SetBooleanOptions(GetBooleanOptions(BooleanOperationType::Difference));
+    if (!pattern.ValidateParameters()) {
+        QMessageBox::warning(this, "挖孔失败", "孔的阵列参数无效。");
+        return;
+    }
 
     // 执行布尔差集
-    m_ocafManager->StartTransaction("Create Hole");
-    auto resultShape = cad_core::BooleanOperations::Difference(targetShape, transformedCylinder);
+    m_ocafManager->StartTransaction(count > 1 ? "Create Hole Pattern" : "Create Hole");
+    auto resultShape = pattern.CreateShape();
 
 
     if (resultShape && resultShape->IsValid()) {
@@ -2483,7 +2673,16 @@ void MainWindow::OnHolePreviewRequested(const cad_core::ShapePtr & holePreviewSh
     if (!m_viewer || !holePreviewShape) {
         return;
     }
-    m_viewer->DisplayPreviewShape(holePreviewShape);
+    // 圆柱只在直径或深度变化时重建，位置由 OnHolePreviewMoved 更新
+    m_viewer->ShowPreview(PreviewSlot::Hole, holePreviewShape->GetOCCTShape());
+}
+
+void MainWindow::OnHolePreviewMoved(const gp_Trsf& transformation)
+{
+    if (!m_viewer) {
+        return;
+    }
+    m_viewer->MovePreview(PreviewSlot::Hole, transformation);
 }
 
 void MainWindow::OnHoleResetPreviewRequested()
@@ -2492,7 +2691,7 @@ void MainWindow::OnHoleResetPreviewRequested()
         return;
     }
 
-    m_viewer->ClearPreviewShapes();
+    m_viewer->HidePreview(PreviewSlot::Hole);
 }
 
 } // namespace cad_ui
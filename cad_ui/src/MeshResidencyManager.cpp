@@ -0,0 +1,139 @@
+﻿#include "cad_ui/MeshResidencyManager.h"
+
+#include <algorithm>
+
+namespace cad_ui {
+
+MeshResidencyManager::MeshResidencyManager()
+    : m_memoryBudget(512u * 1024u * 1024u), m_pooledBytes(0), m_tick(0) {
+}
+
+void MeshResidencyManager::Track(const cad_core::ShapePtr& shape, std::size_t bytes) {
+    if (!shape) {
+        return;
+    }
+
+    Entry& entry = m_entries[shape];
+    entry.bytes = bytes;
+    entry.resident = true;
+    entry.lastSeen = m_tick;
+}
+
+void MeshResidencyManager::Untrack(const cad_core::ShapePtr& shape) {
+    m_entries.erase(shape);
+}
+
+void MeshResidencyManager::Clear() {
+    m_entries.clear();
+}
+
+void MeshResidencyManager::SetVisible(const cad_core::ShapePtr& shape, bool visible) {
+    auto it = m_entries.find(shape);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    it->second.onScreen = visible;
+    if (visible && !it->second.hidden) {
+        it->second.lastSeen = m_tick;
+    }
+}
+
+void MeshResidencyManager::SetHidden(const cad_core::ShapePtr& shape, bool hidden) {
+    auto it = m_entries.find(shape);
+    if (it != m_entries.end()) {
+        it->second.hidden = hidden;
+    }
+}
+
+bool MeshResidencyManager::IsVisible(const cad_core::ShapePtr& shape) const {
+    auto it = m_entries.find(shape);
+    return it == m_entries.end() || (it->second.onScreen && !it->second.hidden);
+}
+
+bool MeshResidencyManager::IsHidden(const cad_core::ShapePtr& shape) const {
+    auto it = m_entries.find(shape);
+    return it != m_entries.end() && it->second.hidden;
+}
+
+void MeshResidencyManager::SetEvicted(const cad_core::ShapePtr& shape) {
+    auto it = m_entries.find(shape);
+    if (it != m_entries.end()) {
+        it->second.resident = false;
+        it->second.bytes = 0;
+    }
+}
+
+bool MeshResidencyManager::IsResident(const cad_core::ShapePtr& shape) const {
+    auto it = m_entries.find(shape);
+    return it == m_entries.end() || it->second.resident;
+}
+
+std::size_t MeshResidencyManager::GetBytes(const cad_core::ShapePtr& shape) const {
+    auto it = m_entries.find(shape);
+    return it != m_entries.end() ? it->second.bytes : 0;
+}
+
+std::size_t MeshResidencyManager::GetResidentBytes() const {
+    std::size_t total = m_pooledBytes;
+    for (const auto& pair : m_entries) {
+        if (pair.second.resident) {
+            total += pair.second.bytes;
+        }
+    }
+    return total;
+}
+
+std::size_t MeshResidencyManager::GetResidentCount() const {
+    return static_cast<std::size_t>(std::count_if(m_entries.begin(), m_entries.end(),
+        [](const std::pair<const cad_core::ShapePtr, Entry>& pair) { return pair.second.resident; }));
+}
+
+std::size_t MeshResidencyManager::GetEvictedCount() const {
+    return m_entries.size() - GetResidentCount();
+}
+
+std::vector<cad_core::ShapePtr> MeshResidencyManager::CollectEvictions() const {
+    std::vector<cad_core::ShapePtr> evictions;
+
+    std::size_t residentBytes = GetResidentBytes();
+    if (residentBytes <= m_memoryBudget) {
+        return evictions;
+    }
+
+    // 候选：驻留且当前不可见（隐藏或离屏）
+    std::vector<std::pair<std::uint64_t, cad_core::ShapePtr>> candidates;
+    for (const auto& pair : m_entries) {
+        const Entry& entry = pair.second;
+        if (entry.resident && entry.bytes > 0 && (entry.hidden || !entry.onScreen)) {
+            candidates.emplace_back(entry.lastSeen, pair.first);
+        }
+    }
+
+    // 最久未见的先释放，直到回到预算以内
+    std::stable_sort(candidates.begin(), candidates.end(),
+        [](const std::pair<std::uint64_t, cad_core::ShapePtr>& a,
+           const std::pair<std::uint64_t, cad_core::ShapePtr>& b) { return a.first < b.first; });
+
+    for (const auto& candidate : candidates) {
+        if (residentBytes <= m_memoryBudget) {
+            break;
+        }
+        residentBytes -= m_entries.at(candidate.second).bytes;
+        evictions.push_back(candidate.second);
+    }
+    return evictions;
+}
+
+std::vector<cad_core::ShapePtr> MeshResidencyManager::CollectReloads() const {
+    std::vector<cad_core::ShapePtr> reloads;
+    for (const auto& pair : m_entries) {
+        const Entry& entry = pair.second;
+        if (!entry.resident && entry.onScreen && !entry.hidden) {
+            reloads.push_back(pair.first);
+        }
+    }
+    return reloads;
+}
+
+} // namespace cad_ui
@@ -0,0 +1,327 @@
+﻿#include "cad_ui/MeshingService.h"
+
+#include <QRunnable>
+#include <QThread>
+#include <QDebug>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <IMeshTools_Parameters.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepTools.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <Bnd_Box.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Precision.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp.hxx>
+#include <TopoDS.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+
+namespace cad_ui {
+
+// 单个网格化任务的共享状态
+// shape 只在GUI线程上访问（写回三角化），copy 是提交任务时在GUI线程上复制的拓扑，
+// 之后只归工作线程所有
+struct MeshJob {
+    quint64 id = 0;
+    TopoDS_Shape shape;
+    TopoDS_Shape copy;
+    double coarseDeflection = 0.0;
+    double fineDeflection = 0.0;
+    double angularDeflection = 0.5;
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> failed{false};
+
+    std::mutex mutex;
+    std::vector<Handle(Poly_Triangulation)> coarseTriangulations;
+    std::vector<Handle(Poly_Triangulation)> fineTriangulations;
+};
+
+namespace {
+
+// 对形状的拓扑副本网格化，按 TopExp::MapShapes 的面顺序返回三角化
+// 粗、细两个阶段在同一副本上依次运行，细网格会替换副本上的粗网格
+std::vector<Handle(Poly_Triangulation)> MeshCopy(const TopoDS_Shape& copy,
+                                                 double deflection,
+                                                 double angularDeflection) {
+    std::vector<Handle(Poly_Triangulation)> result;
+
+    IMeshTools_Parameters params;
+    params.Deflection = deflection;
+    params.Angle = angularDeflection;
+    params.Relative = Standard_False;
+    params.InParallel = Standard_True;
+    BRepMesh_IncrementalMesh mesher(copy, params);
+
+    TopTools_IndexedMapOfShape faces;
+    TopExp::MapShapes(copy, TopAbs_FACE, faces);
+    result.reserve(faces.Extent());
+    for (int i = 1; i <= faces.Extent(); ++i) {
+        TopLoc_Location location;
+        result.push_back(BRep_Tool::Triangulation(TopoDS::Face(faces(i)), location));
+    }
+    return result;
+}
+
+// 把副本的三角化写回原始形状的面（GUI线程）
+bool ApplyTriangulations(const TopoDS_Shape& shape,
+                         const std::vector<Handle(Poly_Triangulation)>& triangulations) {
+    TopTools_IndexedMapOfShape faces;
+    TopExp::MapShapes(shape, TopAbs_FACE, faces);
+    if (faces.Extent() != static_cast<int>(triangulations.size())) {
+        return false;
+    }
+
+    BRep_Builder builder;
+    for (int i = 1; i <= faces.Extent(); ++i) {
+        const Handle(Poly_Triangulation)& triangulation = triangulations[i - 1];
+        if (!triangulation.IsNull()) {
+            builder.UpdateFace(TopoDS::Face(faces(i)), triangulation);
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+MeshingService::MeshingService(QObject* parent)
+    : QObject(parent), m_nextJobId(1),
+      m_coarseRelativeDeflection(0.02), m_fineRelativeDeflection(0.001),
+      m_angularDeflection(0.5),
+      m_pixelTolerance(0.5), m_minRelativeDeflection(1.0e-4), m_maxRelativeDeflection(0.05),
+      m_remeshThreshold(2.0), m_triangleBudget(5000000) {
+    m_threadPool = new QThreadPool(this);
+    m_threadPool->setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+
+    // 工作线程发出的信号排队到GUI线程处理
+    connect(this, &MeshingService::stageFinished,
+            this, &MeshingService::onStageFinished, Qt::QueuedConnection);
+}
+
+MeshingService::~MeshingService() {
+    CancelAll();
+    WaitForDone();
+}
+
+double MeshingService::ComputeDeflection(const TopoDS_Shape& shape, double relativeDeflection) {
+    if (shape.IsNull()) {
+        return relativeDeflection;
+    }
+
+    Bnd_Box box;
+    BRepBndLib::Add(shape, box, Standard_False);
+    if (box.IsVoid()) {
+        return relativeDeflection;
+    }
+
+    const double diagonal = std::sqrt(box.SquareExtent());
+    return std::max(diagonal * relativeDeflection, Precision::Confusion());
+}
+
+double MeshingService::ComputeFineDeflection(const TopoDS_Shape& shape) const {
+    return ComputeDeflection(shape, m_fineRelativeDeflection);
+}
+
+void MeshingService::SetRelativeDeflectionRange(double minRelative, double maxRelative) {
+    m_minRelativeDeflection = std::min(minRelative, maxRelative);
+    m_maxRelativeDeflection = std::max(minRelative, maxRelative);
+}
+
+double MeshingService::ComputeViewDeflection(double diagonal, double worldSizePerPixel) const {
+    return ClampDeflection(diagonal, worldSizePerPixel * m_pixelTolerance);
+}
+
+double MeshingService::ClampDeflection(double diagonal, double deflection) const {
+    const double minDeflection = std::max(diagonal * m_minRelativeDeflection, Precision::Confusion());
+    const double maxDeflection = std::max(diagonal * m_maxRelativeDeflection, minDeflection);
+    return std::min(std::max(deflection, minDeflection), maxDeflection);
+}
+
+bool MeshingService::HasTriangulation(const TopoDS_Shape& shape, double deflection) {
+    if (shape.IsNull()) {
+        return true;
+    }
+    return BRepTools::Triangulation(shape, deflection) == Standard_True;
+}
+
+MeshStatistics MeshingService::ComputeMeshStatistics(const TopoDS_Shape& shape) {
+    MeshStatistics statistics;
+    if (shape.IsNull()) {
+        return statistics;
+    }
+
+    TopTools_IndexedMapOfShape faces;
+    TopExp::MapShapes(shape, TopAbs_FACE, faces);
+    statistics.faces = static_cast<std::size_t>(faces.Extent());
+    for (int i = 1; i <= faces.Extent(); ++i) {
+        TopLoc_Location location;
+        Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(TopoDS::Face(faces(i)), location);
+        if (triangulation.IsNull()) {
+            continue;
+        }
+        ++statistics.meshedFaces;
+        statistics.triangles += static_cast<std::size_t>(triangulation->NbTriangles());
+        statistics.nodes += static_cast<std::size_t>(triangulation->NbNodes());
+        statistics.deflection = std::max(statistics.deflection, triangulation->Deflection());
+
+        // 三角化本身：节点、三角形索引以及可选的UV和法向
+        const std::size_t nbNodes = static_cast<std::size_t>(triangulation->NbNodes());
+        const std::size_t nbTriangles = static_cast<std::size_t>(triangulation->NbTriangles());
+        statistics.bytes += nbNodes * 3 * sizeof(double) + nbTriangles * 3 * sizeof(int);
+        if (triangulation->HasUVNodes()) {
+            statistics.bytes += nbNodes * 2 * sizeof(double);
+        }
+        if (triangulation->HasNormals()) {
+            statistics.bytes += nbNodes * 3 * sizeof(float);
+        }
+        // 着色表示的顶点缓冲区：位置和法向（float）加索引
+        statistics.bytes += nbNodes * 6 * sizeof(float) + nbTriangles * 3 * sizeof(int);
+    }
+    return statistics;
+}
+
+quint64 MeshingService::RequestMesh(const TopoDS_Shape& shape) {
+    if (shape.IsNull()) {
+        return 0;
+    }
+
+    Bnd_Box box;
+    BRepBndLib::Add(shape, box, Standard_False);
+    if (box.IsVoid()) {
+        return 0;
+    }
+    const double diagonal = std::sqrt(box.SquareExtent());
+    return RequestMesh(shape,
+                       std::max(diagonal * m_coarseRelativeDeflection, Precision::Confusion()),
+                       std::max(diagonal * m_fineRelativeDeflection, Precision::Confusion()));
+}
+
+quint64 MeshingService::RequestMesh(const TopoDS_Shape& shape, double coarseDeflection, double fineDeflection,
+                                    bool force) {
+    if (shape.IsNull() || (!force && HasTriangulation(shape, fineDeflection))) {
+        // 已有足够精细的网格（例如撤销后重新显示），无需再次网格化
+        return 0;
+    }
+
+    auto job = std::make_shared<MeshJob>();
+    job->id = m_nextJobId++;
+    job->shape = shape;
+    try {
+        // 在GUI线程上复制拓扑（几何共享、只读，不复制已有网格），
+        // 工作线程不再读取GUI线程拥有的形状
+        BRepBuilderAPI_Copy copier(shape, Standard_False, Standard_False);
+        job->copy = copier.Shape();
+    } catch (const Standard_Failure&) {
+        return 0;
+    }
+    job->fineDeflection = fineDeflection;
+    job->angularDeflection = m_angularDeflection;
+    // 已有粗网格时跳过粗网格阶段
+    const bool needCoarse = coarseDeflection > 0.0 && !HasTriangulation(shape, coarseDeflection);
+    job->coarseDeflection = needCoarse ? coarseDeflection : 0.0;
+
+    m_jobs[job->id] = job;
+
+    MeshingService* service = this;
+    auto* runnable = QRunnable::create([service, job]() { RunJob(service, job); });
+    m_threadPool->start(runnable);
+
+    return job->id;
+}
+
+void MeshingService::Cancel(quint64 jobId) {
+    auto it = m_jobs.find(jobId);
+    if (it != m_jobs.end()) {
+        it->second->cancelled = true;
+        m_jobs.erase(it);
+    }
+}
+
+void MeshingService::CancelAll() {
+    for (auto& pair : m_jobs) {
+        pair.second->cancelled = true;
+    }
+    m_jobs.clear();
+}
+
+void MeshingService::WaitForDone() {
+    m_threadPool->waitForDone();
+}
+
+void MeshingService::RunJob(MeshingService* service, const std::shared_ptr<MeshJob>& job) {
+    try {
+        // 粗网格阶段：尽快给出可着色的网格
+        if (job->coarseDeflection > 0.0 && !job->cancelled) {
+            auto triangulations = MeshCopy(job->copy, job->coarseDeflection, job->angularDeflection);
+            {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->coarseTriangulations = std::move(triangulations);
+            }
+            emit service->stageFinished(job->id, 0);
+        }
+
+        if (job->cancelled) {
+            return;
+        }
+
+        // 细网格阶段
+        auto triangulations = MeshCopy(job->copy, job->fineDeflection, job->angularDeflection);
+        {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->fineTriangulations = std::move(triangulations);
+        }
+    } catch (const Standard_Failure& e) {
+        // 网格化失败，仍通知GUI线程结束该任务
+        qDebug() << "Background meshing failed:" << e.GetMessageString();
+        job->failed = true;
+    }
+
+    // 副本只在工作线程上使用，结束时释放
+    job->copy.Nullify();
+
+    emit service->stageFinished(job->id, 1);
+}
+
+void MeshingService::onStageFinished(quint64 jobId, int stage) {
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end()) {
+        // 任务已取消
+        return;
+    }
+
+    std::shared_ptr<MeshJob> job = it->second;
+    const bool isFinal = (stage != 0);
+    if (isFinal) {
+        m_jobs.erase(it);
+    }
+
+    std::vector<Handle(Poly_Triangulation)> triangulations;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        triangulations.swap(isFinal ? job->fineTriangulations : job->coarseTriangulations);
+    }
+
+    if (isFinal && (job->failed || triangulations.empty())) {
+        emit meshFailed(jobId);
+        return;
+    }
+
+    if (!triangulations.empty() && !ApplyTriangulations(job->shape, triangulations)) {
+        qDebug() << "Mesh face count mismatch, job" << jobId;
+        if (isFinal) {
+            emit meshFailed(jobId);
+        }
+        return;
+    }
+
+    emit meshReady(jobId, isFinal);
+}
+
+} // namespace cad_ui
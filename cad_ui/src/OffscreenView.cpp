@@ -0,0 +1,201 @@
+﻿#include "cad_ui/OffscreenView.h"
+#include "cad_ui/MeshingService.h"
+
+#include <OpenGl_GraphicDriver.hxx>
+#include <OpenGl_Context.hxx>
+#include <Aspect_DisplayConnection.hxx>
+#include <AIS_Shape.hxx>
+#include <Prs3d_Drawer.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <Graphic3d_Camera.hxx>
+#include <Image_AlienPixMap.hxx>
+#include <V3d_ImageDumpOptions.hxx>
+#include <Standard_Failure.hxx>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <WNT_WClass.hxx>
+#include <WNT_Window.hxx>
+#elif defined(__APPLE__)
+#include <Cocoa_Window.hxx>
+#else
+#include <Xw_Window.hxx>
+#endif
+
+namespace cad_ui {
+
+OffscreenView::OffscreenView() : m_isInitialized(false) {
+}
+
+OffscreenView::~OffscreenView() {
+    if (!m_context.IsNull()) {
+        m_context->RemoveAll(Standard_False);
+    }
+    if (!m_view.IsNull()) {
+        m_view->Remove();
+    }
+}
+
+bool OffscreenView::Initialize(const OffscreenViewOptions& options) {
+    if (m_isInitialized) {
+        return true;
+    }
+    m_options = options;
+
+    try {
+#if !defined(_WIN32) && !defined(__APPLE__)
+        // Xw_Window 需要X服务器，没有 DISPLAY 时给出明确提示而不是连接失败的异常
+        const char* display = std::getenv("DISPLAY");
+        if (display == nullptr || display[0] == '\0') {
+            qDebug() << "Offscreen view requires an X server (DISPLAY is not set); run under xvfb-run";
+            return false;
+        }
+
+        // Mesa 在创建上下文前读取该变量，强制使用 llvmpipe 软件光栅化
+        if (m_options.softwareOpenGL) {
+            setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+        }
+#endif
+
+        Handle(Aspect_DisplayConnection) displayConnection = new Aspect_DisplayConnection();
+        Handle(OpenGl_GraphicDriver) driver = new OpenGl_GraphicDriver(displayConnection, Standard_False);
+        driver->ChangeOptions().buffersNoSwap = Standard_True;     // 不向屏幕交换缓冲
+        driver->ChangeOptions().swapInterval = m_options.vsync ? 1 : 0;
+        driver->ChangeOptions().contextNoAccel = m_options.softwareOpenGL ? Standard_True : Standard_False;
+        m_driver = driver;
+
+        m_viewer = new V3d_Viewer(m_driver);
+        m_viewer->SetDefaultLights();
+        m_viewer->SetLightOn();
+
+        m_context = new AIS_InteractiveContext(m_viewer);
+        m_context->SetDisplayMode(AIS_Shaded, Standard_False);
+        // 网格由调用方（或 DisplayShape）预先生成，帧时间中不包含网格化
+        m_context->DefaultDrawer()->SetAutoTriangulation(Standard_False);
+
+        m_view = m_viewer->CreateView();
+
+        // 虚拟窗口：只提供绘制上下文，不显示在屏幕上
+#ifdef _WIN32
+        Handle(WNT_WClass) windowClass = new WNT_WClass("AnderCAD_Offscreen",
+                                                        reinterpret_cast<Standard_Address>(DefWindowProcW),
+                                                        CS_OWNDC);
+        Handle(WNT_Window) window = new WNT_Window("AnderCAD Offscreen", windowClass, WS_POPUP,
+                                                   0, 0, m_options.width, m_options.height);
+#elif defined(__APPLE__)
+        Handle(Cocoa_Window) window = new Cocoa_Window("AnderCAD Offscreen", 0, 0,
+                                                       m_options.width, m_options.height);
+#else
+        Handle(Xw_Window) window = new Xw_Window(displayConnection, "AnderCAD Offscreen", 0, 0,
+                                                 m_options.width, m_options.height);
+#endif
+        window->SetVirtual(Standard_True);
+        m_view->SetWindow(window);
+
+        m_view->SetBackgroundColor(Quantity_NOC_GRAY30);
+        m_view->SetProj(V3d_XposYnegZpos);
+        m_view->MustBeResized();
+
+        m_isInitialized = true;
+        return true;
+    } catch (const Standard_Failure& e) {
+        qDebug() << "Offscreen view initialization failed:" << e.GetMessageString();
+    }
+
+    m_context.Nullify();
+    m_view.Nullify();
+    m_viewer.Nullify();
+    m_driver.Nullify();
+    return false;
+}
+
+void OffscreenView::DisplayShape(const cad_core::ShapePtr& shape) {
+    if (shape && shape->IsValid()) {
+        DisplayShape(shape->GetOCCTShape());
+    }
+}
+
+void OffscreenView::DisplayShape(const TopoDS_Shape& shape) {
+    if (!m_isInitialized || shape.IsNull()) {
+        return;
+    }
+    double deflection = MeshingService::ComputeDeflection(shape, m_options.relativeDeflection);
+    if (!MeshingService::HasTriangulation(shape, deflection)) {
+        BRepMesh_IncrementalMesh mesher(shape, deflection, Standard_False, 0.5, Standard_True);
+    }
+    Handle(AIS_Shape) aisShape = new AIS_Shape(shape);
+    m_context->Display(aisShape, AIS_Shaded, -1, Standard_False);
+}
+
+void OffscreenView::ClearShapes() {
+    if (m_isInitialized) {
+        m_context->RemoveAll(Standard_False);
+    }
+}
+
+void OffscreenView::SetCamera(const gp_Pnt& eye, const gp_Pnt& center, const gp_Dir& up) {
+    if (!m_isInitialized) {
+        return;
+    }
+    Handle(Graphic3d_Camera) camera = m_view->Camera();
+    camera->SetEyeAndCenter(eye, center);
+    camera->SetUp(up);
+    camera->OrthogonalizeUp();
+    m_view->Invalidate();
+}
+
+void OffscreenView::FitAll() {
+    if (m_isInitialized) {
+        m_view->FitAll(0.05, Standard_False);
+    }
+}
+
+double OffscreenView::RenderFrame() {
+    if (!m_isInitialized) {
+        return 0.0;
+    }
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    m_view->Redraw();
+    FinishFrame();
+    return frameTimer.nsecsElapsed() / 1.0e6;
+}
+
+void OffscreenView::FinishFrame() {
+    // Redraw 只是提交命令，等待GPU（或软件光栅化）完成后计时才有意义
+    Handle(OpenGl_GraphicDriver) driver = Handle(OpenGl_GraphicDriver)::DownCast(m_driver);
+    if (driver.IsNull()) {
+        return;
+    }
+    const Handle(OpenGl_Context)& glContext = driver->GetSharedContext();
+    if (!glContext.IsNull() && glContext->core11fwd != nullptr) {
+        glContext->core11fwd->glFinish();
+    }
+}
+
+bool OffscreenView::DumpImage(const std::string& filePath) {
+    if (!m_isInitialized) {
+        return false;
+    }
+    try {
+        // ToPixMap 在离屏FBO中重新绘制并读回像素
+        Image_AlienPixMap image;
+        V3d_ImageDumpOptions dumpOptions;
+        dumpOptions.Width = m_options.width;
+        dumpOptions.Height = m_options.height;
+        dumpOptions.BufferType = Graphic3d_BT_RGB;
+        if (!m_view->ToPixMap(image, dumpOptions)) {
+            qDebug() << "Failed to render offscreen image";
+            return false;
+        }
+        return image.Save(TCollection_AsciiString(filePath.c_str()));
+    } catch (const Standard_Failure& e) {
+        qDebug() << "Failed to dump image:" << e.GetMessageString();
+    }
+    return false;
+}
+
+} // namespace cad_ui
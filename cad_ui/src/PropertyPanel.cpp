@@ -111,6 +111,9 @@ void PropertyPanel::CreateFeatureProperties() {
         case cad_feature::FeatureType::Loft:
             typeText = "Loft";
             break;
+        case cad_feature::FeatureType::Pattern:
+            typeText = "Pattern";
+            break;
         default:
             typeText = "Unknown";
             break;
@@ -1,5 +1,6 @@
 ﻿#include "cad_ui/QtOccView.h"
 #include "cad_ui/SketchMode.h"
+#include "cad_ui/MeshingService.h"
 
 #include <OpenGl_GraphicDriver.hxx>
 #include <Aspect_Handle.hxx>
@@ -25,6 +26,22 @@
 #include <Geom_Line.hxx>
 
 #include <GeomAPI_IntCS.hxx>
+#include <BRepBndLib.hxx>
+#include <Bnd_Box.hxx>
+#include <Graphic3d_Camera.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <Graphic3d_RenderingParams.hxx>
+#include <Graphic3d_TransformPers.hxx>
+#include <TColStd_IndexedDataMapOfStringString.hxx>
+#include <TCollection_ExtendedString.hxx>
+#include <AIS_ListOfInteractive.hxx>
+#include <QElapsedTimer>
+#include <QString>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 #pragma execution_character_set("utf-8")
 
 #ifdef _WIN32
@@ -39,7 +56,8 @@ namespace cad_ui {
 
 QtOccView::QtOccView(QWidget* parent) 
     : QWidget(parent), m_isInitialized(false), m_currentMouseButton(Qt::NoButton),
-      m_currentSelectedShape(nullptr), m_currentSelectionMode(0), m_isDraggingPreview(false) {
+      m_currentSelectedShape(nullptr), m_currentSelectionMode(0), m_isDraggingPreview(false),
+      m_statsOverlayVisible(false), m_statsCollectionEnabled(false), m_presentationPoolLimit(64) {
     
     // Set widget attributes to reduce flicker
     setAttribute(Qt::WA_PaintOnScreen);
@@ -59,6 +77,19 @@ QtOccView::QtOccView(QWidget* parent)
     // Initialize selection manager
     m_selectionManager = std::make_unique<cad_core::SelectionManager>();
     
+    // 后台网格化服务，网格就绪后替换显示
+    m_meshingService = new MeshingService(this);
+    connect(m_meshingService, &MeshingService::meshReady, this, &QtOccView::OnMeshReady);
+    connect(m_meshingService, &MeshingService::meshFailed, this, &QtOccView::OnMeshFailed);
+    
+    // 缩放停止后再按新的屏幕尺寸调整网格精度
+    m_tessellationTimer = new QTimer(this);
+    m_tessellationTimer->setSingleShot(true);
+    m_tessellationTimer->setInterval(250);
+    connect(m_tessellationTimer, &QTimer::timeout, this, &QtOccView::UpdateViewDependentTessellation);
+    
+    m_meshResidency = std::make_unique<MeshResidencyManager>();
+    
     // Initialize sketch mode (delayed initialization to avoid crash)
     m_sketchMode = nullptr; // Will be initialized on first use
     
@@ -150,6 +181,7 @@ bool QtOccView::InitViewer() {
         m_selectionManager->SetView(m_view);
         
         m_isInitialized = true;
+        ApplyStatisticsParams();
         
         // Initial view setup and render
         FitAll();
@@ -169,6 +201,7 @@ void QtOccView::FitAll() {
     m_view->FitAll();
     m_view->ZFitAll();
     m_view->Redraw();
+    ScheduleTessellationUpdate();
 }
 
 void QtOccView::ZoomIn() {
@@ -176,6 +209,7 @@ void QtOccView::ZoomIn() {
     
     m_view->SetZoom(1.5);
     m_view->Redraw();
+    ScheduleTessellationUpdate();
 }
 
 void QtOccView::ZoomOut() {
@@ -183,6 +217,7 @@ void QtOccView::ZoomOut() {
     
     m_view->SetZoom(0.75);
     m_view->Redraw();
+    ScheduleTessellationUpdate();
 }
 
 void QtOccView::Pan(int dx, int dy) {
@@ -219,6 +254,7 @@ void QtOccView::SetProjectionMode(bool orthographic) {
         m_view->Camera()->SetProjectionType(Graphic3d_Camera::Projection_Perspective);
     }
     m_view->Redraw();
+    ScheduleTessellationUpdate();
 }
 
 void QtOccView::DisplayShape(const cad_core::ShapePtr& shape) {
@@ -226,26 +262,77 @@ void QtOccView::DisplayShape(const cad_core::ShapePtr& shape) {
         return;
     }
     
-    Handle(AIS_Shape) aisShape = new AIS_Shape(shape->GetOCCTShape());
+    // 相同几何已经显示过时，以实例方式共享同一表示和网格
+    if (DisplayAsInstance(shape)) {
+        m_view->FitAll();
+        m_view->Redraw();
+        update();
+        return;
+    }
+    
+    // 表示池中有相同几何（例如撤销/重做后未改变的实体），直接复用表示和网格
+    if (ReusePresentation(shape)) {
+        m_view->FitAll();
+        m_view->Redraw();
+        update();
+        return;
+    }
+    
+    const TopoDS_Shape& occShape = shape->GetOCCTShape();
+    Handle(AIS_Shape) aisShape = new AIS_Shape(occShape);
     
     // Set shape properties for better visibility
     aisShape->SetColor(Quantity_NOC_ORANGE);
     aisShape->SetTransparency(0.0);
     
-    m_context->Display(aisShape, Standard_False);
+    // 三角化交给后台网格化服务，GUI线程上不再自动网格化
+    aisShape->Attributes()->SetAutoTriangulation(Standard_False);
+    
+    // 按包围盒和当前屏幕尺寸确定网格精度
+    ShapeMeshState meshState;
+    Bnd_Box box;
+    BRepBndLib::Add(occShape, box, Standard_False);
+    if (!box.IsVoid()) {
+        meshState.box = box;
+        meshState.diagonal = std::sqrt(box.SquareExtent());
+        meshState.center = gp_Pnt((box.CornerMin().XYZ() + box.CornerMax().XYZ()) * 0.5);
+    }
     
     // Store mapping for selection synchronization
     m_shapeToAIS[shape] = aisShape;
+    m_meshStates[shape] = meshState;
+    m_meshResidency->Track(shape, 0);
+    
+    if (meshState.diagonal > 0.0) {
+        const double deflection = m_meshingService->ComputeViewDeflection(
+            meshState.diagonal, WorldSizePerPixel(meshState.center));
+        const MeshStatistics existing = MeshingService::ComputeMeshStatistics(occShape);
+        
+        if (existing.faces > 0 && existing.meshedFaces == existing.faces &&
+            existing.deflection <= deflection * m_meshingService->GetRemeshThreshold()) {
+            // 形状已有足够的网格（例如撤销后重新显示），直接着色显示
+            m_meshStates[shape].deflection = existing.deflection;
+            m_meshStates[shape].triangles = existing.triangles;
+            m_meshResidency->Track(shape, existing.bytes);
+        } else {
+            // 先显示包围盒，粗网格和细网格就绪后依次替换
+            const double coarseDeflection = meshState.diagonal * m_meshingService->GetCoarseRelativeDeflection();
+            RequestShapeMesh(shape, coarseDeflection, deflection, false);
+            if (m_meshStates[shape].pendingJob != 0) {
+                aisShape->SetDisplayMode(2); // 包围盒
+            }
+        }
+    }
+    
+    m_context->Display(aisShape, Standard_False);
     
     // Enable selection modes for this shape
-    m_context->SetSelectionModeActive(aisShape, 0, Standard_True); // Shape
-    m_context->SetSelectionModeActive(aisShape, 1, Standard_True); // Vertex
-    m_context->SetSelectionModeActive(aisShape, 2, Standard_True); // Edge
-    m_context->SetSelectionModeActive(aisShape, 4, Standard_True); // Face
+    ActivateShapeSelectionModes(aisShape);
     
     // Fit all objects in view to ensure visibility and render
     m_view->FitAll();
     m_view->Redraw();
+    ScheduleTessellationUpdate();
     
     // Force immediate rendering
     update();
@@ -259,15 +346,25 @@ void QtOccView::RemoveShape(const cad_core::ShapePtr& shape) {
         return;
     }
     
-    // Find and remove the AIS_Shape
+    // 网格完整的表示只擦除并放入表示池，其余的直接移除
     auto it = m_shapeToAIS.find(shape);
     if (it != m_shapeToAIS.end()) {
-        Handle(AIS_Shape) aisShape = it->second;
+        Handle(AIS_InteractiveObject) aisShape = it->second;
         if (!aisShape.IsNull()) {
-            m_context->Remove(aisShape, Standard_False);
+            ReleaseSelection(aisShape);
+            if (!ParkPresentation(shape, aisShape)) {
+                m_context->Remove(aisShape, Standard_False);
+            }
         }
         m_shapeToAIS.erase(it);
     }
+    m_hiddenShapes.erase(shape);
+    
+    // 其他实例仍共享该几何时，未完成的网格任务转交给接管的成员
+    ReleaseInstance(shape);
+    CancelPendingMesh(shape);
+    m_meshStates.erase(shape);
+    m_meshResidency->Untrack(shape);
     
     m_view->Redraw();
     update();
@@ -276,11 +373,88 @@ void QtOccView::RemoveShape(const cad_core::ShapePtr& shape) {
 void QtOccView::ClearShapes() {
     if (m_context.IsNull()) return;
     
-    m_context->RemoveAll(Standard_False);
+    m_meshingService->CancelAll();
+    m_pendingMeshes.clear();
+    
+    ClearEdgeSelection();
+    UnhighlightAllVertices();
+    UnhighlightAllFaces();
+    ClearPreviewShapes();
+    
+    // 只处理本视图管理的形状，不再 RemoveAll（视图立方体、统计标签等保持显示）。
+    // 网格完整的表示放入表示池，撤销/重做后重新显示同一形状时不必重建
+    for (const auto& pair : m_shapeToAIS) {
+        if (pair.second.IsNull()) {
+            continue;
+        }
+        ReleaseSelection(pair.second);
+        if (!ParkPresentation(pair.first, pair.second)) {
+            m_context->Remove(pair.second, Standard_False);
+        }
+    }
     m_shapeToAIS.clear(); // Clear the mapping
+    m_meshStates.clear();
+    m_meshResidency->Clear();
+    m_instanceGroups.clear();
+    m_hiddenShapes.clear();
     m_view->Redraw();
 }
 
+void QtOccView::SetShapeVisible(const cad_core::ShapePtr& shape, bool visible) {
+    if (!shape || m_context.IsNull()) {
+        return;
+    }
+    
+    auto it = m_shapeToAIS.find(shape);
+    if (it == m_shapeToAIS.end() || it->second.IsNull()) {
+        return;
+    }
+    
+    Handle(AIS_InteractiveObject) aisShape = it->second;
+    m_meshResidency->SetHidden(shape, !visible);
+    
+    if (visible) {
+        m_hiddenShapes.erase(shape);
+        if (!m_meshResidency->IsResident(shape)) {
+            // 隐藏期间网格因内存预算被释放，重新网格化
+            RestoreShapeMesh(shape);
+        } else if (!m_context->IsDisplayed(aisShape)) {
+            // 擦除的表示仍在上下文中，重新显示不需要重建
+            m_context->Display(aisShape, Standard_False);
+            if (aisShape->ToBeUpdated()) {
+                m_context->Redisplay(aisShape, Standard_False);
+            }
+        }
+        ScheduleTessellationUpdate();
+    } else {
+        m_hiddenShapes.insert(shape);
+        ReleaseSelection(aisShape);
+        if (m_context->IsDisplayed(aisShape)) {
+            m_context->Erase(aisShape, Standard_False);
+        }
+    }
+    
+    m_view->Redraw();
+    update();
+}
+
+bool QtOccView::IsShapeVisible(const cad_core::ShapePtr& shape) const {
+    return m_shapeToAIS.find(shape) != m_shapeToAIS.end() && m_hiddenShapes.count(shape) == 0;
+}
+
+void QtOccView::SetPresentationPoolLimit(std::size_t count) {
+    m_presentationPoolLimit = count;
+    while (m_poolOrder.size() > m_presentationPoolLimit) {
+        DropPooledPresentation(m_poolOrder.front());
+    }
+}
+
+void QtOccView::ClearPresentationPool() {
+    while (!m_poolOrder.empty()) {
+        DropPooledPresentation(m_poolOrder.front());
+    }
+}
+
 void QtOccView::RedrawAll() {
     if (m_view.IsNull()) return;
     
@@ -422,10 +596,8 @@ void QtOccView::paintEvent(QPaintEvent* event) {
         }
     }
     
-    if (!m_view.IsNull()) {
-        // Only redraw, avoid window remapping which can cause flicker
-        m_view->Redraw();
-    }
+    // Only redraw, avoid window remapping which can cause flicker
+    RenderFrame();
 }
 
 void QtOccView::resizeEvent(QResizeEvent* event) {
@@ -433,6 +605,7 @@ void QtOccView::resizeEvent(QResizeEvent* event) {
     
     if (!m_view.IsNull()) {
         m_view->MustBeResized();
+        ScheduleTessellationUpdate();
     }
 }
 
@@ -547,6 +720,7 @@ void QtOccView::mouseMoveEvent(QMouseEvent* event) {
             double factor = (delta.y() > 0) ? 0.9 : 1.1;
             m_view->SetZoom(factor);
             m_view->Redraw();  // 确保实时渲染
+            ScheduleTessellationUpdate();
         }
     }
     
@@ -571,6 +745,9 @@ void QtOccView::mouseReleaseEvent(QMouseEvent* event) {
     
     Q_UNUSED(event);
     m_currentMouseButton = Qt::NoButton;
+    
+    // 旋转/平移结束后检查离屏形状
+    ScheduleTessellationUpdate();
 }
 
 void QtOccView::wheelEvent(QWheelEvent* event) {
@@ -581,6 +758,7 @@ void QtOccView::wheelEvent(QWheelEvent* event) {
     
     m_view->SetZoom(factor);
     m_view->Redraw();
+    ScheduleTessellationUpdate();
 }
 
 void QtOccView::keyPressEvent(QKeyEvent* event) {
@@ -611,12 +789,47 @@ void QtOccView::InitializeOCC() {
 }
 
 void QtOccView::RedrawView() {
-    if (!m_view.IsNull()) {
-        m_view->Redraw();
+    RenderFrame();
+}
+
+void QtOccView::RenderFrame() {
+    if (m_view.IsNull()) {
+        return;
+    }
+    
+    // 叠加层文字随实际重绘一起更新（最多每500毫秒一次），空闲时不为刷新统计而重绘
+    if (m_statsOverlayVisible && (!m_statsClock.isValid() || m_statsClock.elapsed() >= 500)) {
+        UpdateStatisticsOverlay();
+        m_statsClock.start();
+    }
+    
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    m_view->Redraw();
+    RecordFrameTime(frameTimer.nsecsElapsed() / 1.0e6);
+}
+
+void QtOccView::RecordFrameTime(double milliseconds) {
+    m_renderStats.frameTimeMs = milliseconds;
+    
+    // 指数滑动平均，平滑单帧抖动
+    const double alpha = 0.1;
+    m_renderStats.averageFrameTimeMs = (m_renderStats.averageFrameTimeMs <= 0.0)
+        ? milliseconds
+        : m_renderStats.averageFrameTimeMs * (1.0 - alpha) + milliseconds * alpha;
+    if (m_renderStats.averageFrameTimeMs > 0.0) {
+        m_renderStats.fps = 1000.0 / m_renderStats.averageFrameTimeMs;
     }
 }
 
 void QtOccView::HandleSelection(const QPoint& point) {
+    QElapsedTimer pickTimer;
+    pickTimer.start();
+    HandleSelectionImpl(point);
+    m_renderStats.pickTimeMs = pickTimer.nsecsElapsed() / 1.0e6;
+}
+
+void QtOccView::HandleSelectionImpl(const QPoint& point) {
     if (m_context.IsNull()) return;
     
     qDebug() << "HandleSelection called, current selection mode:" << m_currentSelectionMode;
@@ -650,19 +863,12 @@ void QtOccView::HandleSelection(const QPoint& point) {
             for (m_context->InitSelected(); m_context->MoreSelected(); m_context->NextSelected()) {
                 selectedCount++;
                 Handle(AIS_InteractiveObject) anIO = m_context->SelectedInteractive();
-                Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(anIO);
                 
                 qDebug() << "Found selected object" << selectedCount;
                 
-                if (!aisShape.IsNull()) {
-                    // Find the corresponding cad_core::ShapePtr for this AIS_Shape
-                    cad_core::ShapePtr parentShape = nullptr;
-                    for (const auto& pair : m_shapeToAIS) {
-                        if (pair.second == aisShape) {
-                            parentShape = pair.first;
-                            break;
-                        }
-                    }
+                if (!anIO.IsNull()) {
+                    // Find the corresponding cad_core::ShapePtr (shape or shared-geometry instance)
+                    cad_core::ShapePtr parentShape = FindShapeForObject(anIO);
                     
                     if (!parentShape) {
                         qDebug() << "Could not find parent shape for selected edge";
@@ -672,7 +878,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
                     // Get the selected entity (edge)
                     Handle(StdSelect_BRepOwner) anOwner = Handle(StdSelect_BRepOwner)::DownCast(m_context->SelectedOwner());
                     if (!anOwner.IsNull()) {
-                        TopoDS_Shape selectedShape = anOwner->Shape();
+                        TopoDS_Shape selectedShape = ResolveSubShape(parentShape, anOwner->Shape());
                         qDebug() << "Selected shape type:" << selectedShape.ShapeType() << "TopAbs_EDGE=" << TopAbs_EDGE;
                         
                         if (selectedShape.ShapeType() == TopAbs_EDGE) {
@@ -701,7 +907,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
                         qDebug() << "No BRepOwner found";
                     }
                 } else {
-                    qDebug() << "Selected object is not an AIS_Shape";
+                    qDebug() << "Selected object is not a shape";
                 }
             }
             
@@ -717,13 +923,13 @@ void QtOccView::HandleSelection(const QPoint& point) {
             // Get selected vertex from OpenCASCADE context
             for (m_context->InitSelected(); m_context->MoreSelected(); m_context->NextSelected()) {
                 Handle(AIS_InteractiveObject) anIO = m_context->SelectedInteractive();
-                Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(anIO);
+                cad_core::ShapePtr parentShape = FindShapeForObject(anIO);
                 
-                if (!aisShape.IsNull()) {
+                if (parentShape) {
                     // Get the selected entity (vertex)
                     Handle(StdSelect_BRepOwner) anOwner = Handle(StdSelect_BRepOwner)::DownCast(m_context->SelectedOwner());
                     if (!anOwner.IsNull()) {
-                        TopoDS_Shape selectedShape = anOwner->Shape();
+                        TopoDS_Shape selectedShape = ResolveSubShape(parentShape, anOwner->Shape());
                         qDebug() << "Selected shape type:" << selectedShape.ShapeType() << "TopAbs_VERTEX=" << TopAbs_VERTEX;
                         
                         if (selectedShape.ShapeType() == TopAbs_VERTEX) {
@@ -745,17 +951,10 @@ void QtOccView::HandleSelection(const QPoint& point) {
 
             for (m_context->InitSelected(); m_context->MoreSelected(); m_context->NextSelected()) {
                 Handle(AIS_InteractiveObject) anIO = m_context->SelectedInteractive();
-                Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(anIO);
 
-                if (!aisShape.IsNull()) {
+                if (!anIO.IsNull()) {
                     // send signal for the parent shape
-                    cad_core::ShapePtr parentShape = nullptr;
-                    for (const auto& pair : m_shapeToAIS) {
-                        if (pair.second == aisShape) {
-                            parentShape = pair.first;
-                            break;
-                        }
-                    }
+                    cad_core::ShapePtr parentShape = FindShapeForObject(anIO);
                     if (parentShape) {
                         emit ShapeSelected(parentShape);
                     }
@@ -763,7 +962,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
 					// send signal for the selected face
                     Handle(StdSelect_BRepOwner) anOwner = Handle(StdSelect_BRepOwner)::DownCast(m_context->SelectedOwner());
                     if (!anOwner.IsNull()) {
-                        TopoDS_Shape selectedShape = anOwner->Shape();
+                        TopoDS_Shape selectedShape = ResolveSubShape(parentShape, anOwner->Shape());
                         if (selectedShape.ShapeType() == TopAbs_FACE) {
                             TopoDS_Face face = TopoDS::Face(selectedShape);
                             HighlightFace(face);
@@ -776,8 +975,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
             }
         } else {
             // Handle shape selection (single selection mode)
-            Handle(AIS_InteractiveObject) detectedObj = m_context->DetectedInteractive();
-            Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(detectedObj);
+            Handle(AIS_InteractiveObject) aisShape = m_context->DetectedInteractive();
             
             if (!aisShape.IsNull()) {
                 // Clear previous selection
@@ -788,13 +986,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
                 }
                 
                 // Find the corresponding shape
-                cad_core::ShapePtr foundShape;
-                for (const auto& pair : m_shapeToAIS) {
-                    if (pair.second == aisShape) {
-                        foundShape = pair.first;
-                        break;
-                    }
-                }
+                cad_core::ShapePtr foundShape = FindShapeForObject(aisShape);
                 
                 if (foundShape) {
                     // Set new selection with highlighting
@@ -837,6 +1029,584 @@ void QtOccView::OnRedrawTimer() {
     RedrawView();
 }
 
+void QtOccView::OnMeshReady(quint64 jobId, bool isFinal) {
+    auto it = m_pendingMeshes.find(jobId);
+    if (it == m_pendingMeshes.end()) {
+        return;
+    }
+    
+    cad_core::ShapePtr shape = it->second;
+    if (isFinal) {
+        m_pendingMeshes.erase(it);
+        
+        auto stateIt = m_meshStates.find(shape);
+        if (stateIt != m_meshStates.end() && stateIt->second.pendingJob == jobId) {
+            const MeshStatistics statistics = MeshingService::ComputeMeshStatistics(shape->GetOCCTShape());
+            stateIt->second.deflection = stateIt->second.targetDeflection;
+            stateIt->second.triangles = statistics.triangles;
+            stateIt->second.pendingJob = 0;
+            m_meshResidency->Track(shape, statistics.bytes);
+        }
+    }
+    
+    auto aisIt = m_shapeToAIS.find(shape);
+    if (m_context.IsNull() || aisIt == m_shapeToAIS.end()) {
+        return;
+    }
+    Handle(AIS_InteractiveObject) aisShape = aisIt->second;
+    if (aisShape.IsNull()) {
+        return;
+    }
+    if (aisShape->IsKind(STANDARD_TYPE(AIS_ConnectedInteractive))) {
+        // 接管网格的实例：网格写在共享的 TShape 上，刷新母版即可
+        RefreshInstances(shape);
+        if (!m_redrawTimer->isActive()) {
+            m_redrawTimer->start(0);
+        }
+        return;
+    }
+    if (!m_context->IsDisplayed(aisShape)) {
+        // 隐藏的形状只标记表示过期，重新显示时再计算
+        if (m_hiddenShapes.count(shape) != 0) {
+            if (aisShape->HasDisplayMode()) {
+                aisShape->UnsetDisplayMode();
+            }
+            aisShape->SetToUpdate();
+            RefreshInstances(shape);
+        }
+        return;
+    }
+    
+    // 包围盒切换回上下文的显示模式；已着色的则用新网格重新计算表示
+    if (aisShape->HasDisplayMode()) {
+        m_context->UnsetDisplayMode(aisShape, Standard_False);
+    } else {
+        m_context->Redisplay(aisShape, Standard_False);
+    }
+    m_context->RecomputeSelectionOnly(aisShape);
+    
+    // 共享同一几何的实例也使用新网格
+    RefreshInstances(shape);
+    
+    // 合并多个网格结果的重绘
+    if (!m_redrawTimer->isActive()) {
+        m_redrawTimer->start(0);
+    }
+}
+
+void QtOccView::OnMeshFailed(quint64 jobId) {
+    auto it = m_pendingMeshes.find(jobId);
+    if (it == m_pendingMeshes.end()) {
+        return;
+    }
+    
+    // 显示模式不变：没有网格时继续显示包围盒，已有粗网格时保留粗网格
+    cad_core::ShapePtr shape = it->second;
+    m_pendingMeshes.erase(it);
+    auto stateIt = m_meshStates.find(shape);
+    if (stateIt != m_meshStates.end() && stateIt->second.pendingJob == jobId) {
+        stateIt->second.pendingJob = 0;
+        stateIt->second.meshFailed = true;
+    }
+}
+
+void QtOccView::CancelPendingMesh(const cad_core::ShapePtr& shape) {
+    for (auto it = m_pendingMeshes.begin(); it != m_pendingMeshes.end();) {
+        if (it->second == shape) {
+            m_meshingService->Cancel(it->first);
+            it = m_pendingMeshes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    auto stateIt = m_meshStates.find(shape);
+    if (stateIt != m_meshStates.end()) {
+        stateIt->second.pendingJob = 0;
+    }
+}
+
+void QtOccView::RequestShapeMesh(const cad_core::ShapePtr& shape, double coarseDeflection,
+                                 double deflection, bool force) {
+    auto stateIt = m_meshStates.find(shape);
+    if (stateIt == m_meshStates.end()) {
+        return;
+    }
+    
+    CancelPendingMesh(shape);
+    
+    const quint64 jobId = m_meshingService->RequestMesh(shape->GetOCCTShape(), coarseDeflection, deflection, force);
+    stateIt->second.targetDeflection = deflection;
+    stateIt->second.pendingJob = jobId;
+    if (jobId != 0) {
+        m_pendingMeshes[jobId] = shape;
+    }
+}
+
+double QtOccView::WorldSizePerPixel(const gp_Pnt& point) const {
+    if (m_view.IsNull()) {
+        return 0.0;
+    }
+    
+    Handle(Graphic3d_Camera) camera = m_view->Camera();
+    const double viewportHeight = std::max(1, height());
+    if (camera->IsOrthographic()) {
+        return camera->ViewDimensions().Y() / viewportHeight;
+    }
+    
+    // 透视投影：按点到视点的距离计算
+    const double distance = camera->Eye().Distance(point);
+    return 2.0 * distance * std::tan(camera->FOVy() * M_PI / 360.0) / viewportHeight;
+}
+
+void QtOccView::ScheduleTessellationUpdate() {
+    if (!m_meshStates.empty()) {
+        m_tessellationTimer->start();
+    }
+}
+
+void QtOccView::UpdateViewDependentTessellation() {
+    if (m_view.IsNull() || m_context.IsNull() || m_meshStates.empty()) {
+        return;
+    }
+    
+    // 先处理离屏形状的网格释放和重新可见形状的重新网格化
+    UpdateMeshResidency();
+    
+    // 按屏幕尺寸计算每个形状的目标弦高，并估算达到该精度所需的三角形数
+    struct Candidate {
+        cad_core::ShapePtr shape;
+        double deflection;
+    };
+    std::vector<Candidate> candidates;
+    double totalTriangles = 0.0;
+    
+    for (const auto& pair : m_meshStates) {
+        const ShapeMeshState& state = pair.second;
+        if (state.diagonal <= 0.0 || state.meshFailed || state.isInstance || !m_meshResidency->IsResident(pair.first) ||
+            !m_meshResidency->IsVisible(pair.first)) {
+            continue;
+        }
+        
+        const double target = m_meshingService->ComputeViewDeflection(state.diagonal, WorldSizePerPixel(state.center));
+        double estimated = static_cast<double>(state.triangles);
+        if (state.deflection > 0.0 && state.triangles > 0) {
+            // 三角形数近似与弦高成反比
+            estimated = state.triangles * (state.deflection / target);
+        }
+        totalTriangles += estimated;
+        candidates.push_back({pair.first, target});
+    }
+    
+    // 超出三角形预算时统一放大弦高
+    const double budget = static_cast<double>(m_meshingService->GetTriangleBudget());
+    const double budgetScale = (budget > 0.0 && totalTriangles > budget) ? totalTriangles / budget : 1.0;
+    const double threshold = m_meshingService->GetRemeshThreshold();
+    
+    for (const Candidate& candidate : candidates) {
+        ShapeMeshState& state = m_meshStates[candidate.shape];
+        const double target = m_meshingService->ClampDeflection(state.diagonal, candidate.deflection * budgetScale);
+        
+        // 与当前（或正在生成的）网格精度比较，变化未超过阈值则保持不变
+        const double current = (state.pendingJob != 0) ? state.targetDeflection : state.deflection;
+        if (current > 0.0) {
+            const double ratio = std::max(current / target, target / current);
+            if (ratio < threshold) {
+                continue;
+            }
+        }
+        
+        // 旧网格保持显示，新网格在后台生成后替换
+        RequestShapeMesh(candidate.shape, 0.0, target, true);
+    }
+}
+
+void QtOccView::ActivateShapeSelectionModes(const Handle(AIS_InteractiveObject)& object) {
+    m_context->SetSelectionModeActive(object, 0, Standard_True); // Shape
+    m_context->SetSelectionModeActive(object, 1, Standard_True); // Vertex
+    m_context->SetSelectionModeActive(object, 2, Standard_True); // Edge
+    m_context->SetSelectionModeActive(object, 4, Standard_True); // Face
+}
+
+bool QtOccView::IsBoxOnScreen(const Bnd_Box& box) const {
+    if (box.IsVoid() || m_view.IsNull()) {
+        return true;
+    }
+    
+    Handle(Graphic3d_Camera) camera = m_view->Camera();
+    const gp_Pnt eye = camera->Eye();
+    const gp_Vec direction(camera->Direction());
+    
+    double xmin, ymin, zmin, xmax, ymax, zmax;
+    box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+    
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = -std::numeric_limits<double>::max();
+    double maxY = -std::numeric_limits<double>::max();
+    for (int i = 0; i < 8; ++i) {
+        const gp_Pnt corner((i & 1) ? xmax : xmin, (i & 2) ? ymax : ymin, (i & 4) ? zmax : zmin);
+        
+        // 透视投影下角点在视点后方时投影不可靠，保守地认为可见
+        if (!camera->IsOrthographic() && gp_Vec(eye, corner).Dot(direction) <= 0.0) {
+            return true;
+        }
+        
+        const gp_Pnt projected = camera->Project(corner);
+        minX = std::min(minX, projected.X());
+        minY = std::min(minY, projected.Y());
+        maxX = std::max(maxX, projected.X());
+        maxY = std::max(maxY, projected.Y());
+    }
+    
+    // 归一化设备坐标 [-1, 1]，留出一点余量避免边缘形状反复释放
+    const double margin = 1.2;
+    return maxX >= -margin && minX <= margin && maxY >= -margin && minY <= margin;
+}
+
+void QtOccView::UpdateMeshResidency() {
+    m_meshResidency->NextTick();
+    for (const auto& pair : m_meshStates) {
+        m_meshResidency->SetVisible(pair.first, IsBoxOnScreen(pair.second.box));
+    }
+    
+    // 重新可见的形状按需重新网格化
+    for (const cad_core::ShapePtr& shape : m_meshResidency->CollectReloads()) {
+        RestoreShapeMesh(shape);
+    }
+    
+    // 超出内存预算时先释放表示池中最早入池的表示，再释放最久未见的隐藏或离屏形状
+    while (!m_poolOrder.empty() && m_meshResidency->GetResidentBytes() > m_meshResidency->GetMemoryBudget()) {
+        DropPooledPresentation(m_poolOrder.front());
+    }
+    for (const cad_core::ShapePtr& shape : m_meshResidency->CollectEvictions()) {
+        EvictShapeMesh(shape);
+    }
+}
+
+void QtOccView::EvictShapeMesh(const cad_core::ShapePtr& shape) {
+    CancelPendingMesh(shape);
+    
+    // 只释放着色和线框表示（显示缓冲区），对象仍留在上下文中：
+    // 选择、FitAll 和对象列表不受影响，恢复前以包围盒显示。
+    // 面上的三角化不清除——TShape 可能被撤销栈、表示池或布尔结果共享
+    auto aisIt = m_shapeToAIS.find(shape);
+    if (aisIt != m_shapeToAIS.end() && !aisIt->second.IsNull()) {
+        Handle(AIS_InteractiveObject) aisShape = aisIt->second;
+        if (m_context->IsDisplayed(aisShape)) {
+            m_context->SetDisplayMode(aisShape, 2, Standard_False);
+        } else {
+            aisShape->SetDisplayMode(2);
+        }
+        m_context->ClearPrs(aisShape, 0, Standard_False);
+        m_context->ClearPrs(aisShape, 1, Standard_False);
+    }
+    
+    auto stateIt = m_meshStates.find(shape);
+    if (stateIt != m_meshStates.end()) {
+        stateIt->second.deflection = 0.0;
+        stateIt->second.targetDeflection = 0.0;
+        stateIt->second.triangles = 0;
+    }
+    m_meshResidency->SetEvicted(shape);
+}
+
+void QtOccView::RestoreShapeMesh(const cad_core::ShapePtr& shape) {
+    auto aisIt = m_shapeToAIS.find(shape);
+    auto stateIt = m_meshStates.find(shape);
+    if (aisIt == m_shapeToAIS.end() || aisIt->second.IsNull() || stateIt == m_meshStates.end()) {
+        return;
+    }
+    
+    Handle(AIS_InteractiveObject) aisShape = aisIt->second;
+    ShapeMeshState& state = stateIt->second;
+    const double deflection = m_meshingService->ComputeViewDeflection(state.diagonal, WorldSizePerPixel(state.center));
+    const double coarseDeflection = state.diagonal * m_meshingService->GetCoarseRelativeDeflection();
+    
+    m_meshResidency->Track(shape, 0);
+    RequestShapeMesh(shape, coarseDeflection, deflection, false);
+    if (state.pendingJob == 0) {
+        // 三角化仍在形状上，只需重建表示
+        const MeshStatistics statistics = MeshingService::ComputeMeshStatistics(shape->GetOCCTShape());
+        state.deflection = statistics.deflection;
+        state.triangles = statistics.triangles;
+        m_meshResidency->Track(shape, statistics.bytes);
+        if (m_context->IsDisplayed(aisShape)) {
+            m_context->UnsetDisplayMode(aisShape, Standard_False);
+        } else {
+            aisShape->UnsetDisplayMode();
+        }
+    }
+    
+    m_context->Display(aisShape, Standard_False);
+    ActivateShapeSelectionModes(aisShape);
+}
+
+QtOccView::InstanceKey QtOccView::MakeInstanceKey(const TopoDS_Shape& shape) {
+    return InstanceKey(shape.TShape().get(), static_cast<int>(shape.Orientation()));
+}
+
+bool QtOccView::DisplayAsInstance(const cad_core::ShapePtr& shape) {
+    const TopoDS_Shape& occShape = shape->GetOCCTShape();
+    InstanceGroup& group = m_instanceGroups[MakeInstanceKey(occShape)];
+    if (std::find(group.members.begin(), group.members.end(), shape) != group.members.end()) {
+        // 重复显示同一形状：已有表示时只确保它可见，不再加入成员
+        auto aisIt = m_shapeToAIS.find(shape);
+        if (aisIt != m_shapeToAIS.end() && !aisIt->second.IsNull()) {
+            if (m_hiddenShapes.count(shape) == 0 && !m_context->IsDisplayed(aisIt->second)) {
+                m_context->Display(aisIt->second, Standard_False);
+            }
+            return true;
+        }
+    } else {
+        group.members.push_back(shape);
+    }
+    if (group.members.front() == shape) {
+        // 第一次出现，按普通形状显示
+        return false;
+    }
+    
+    if (group.master.IsNull()) {
+        // 母版以单位位置构建，只通过连接对象绘制，三角化与其他成员共享
+        group.master = new AIS_Shape(occShape.Located(TopLoc_Location()));
+        group.master->SetColor(Quantity_NOC_ORANGE);
+        group.master->SetTransparency(0.0);
+        group.master->Attributes()->SetAutoTriangulation(Standard_False);
+    }
+    
+    // 每个实例只保存自己的变换，表示和缓冲区由母版提供
+    Handle(AIS_ConnectedInteractive) instance = new AIS_ConnectedInteractive();
+    instance->Connect(group.master, occShape.Location().Transformation());
+    
+    m_context->Display(instance, Standard_False);
+    m_shapeToAIS[shape] = instance;
+    ActivateShapeSelectionModes(instance);
+    
+    // 实例也参与可见性和驻留统计，网格字节只计在第一个成员上
+    ShapeMeshState meshState;
+    meshState.isInstance = true;
+    Bnd_Box box;
+    BRepBndLib::Add(occShape, box, Standard_False);
+    if (!box.IsVoid()) {
+        meshState.box = box;
+        meshState.diagonal = std::sqrt(box.SquareExtent());
+        meshState.center = gp_Pnt((box.CornerMin().XYZ() + box.CornerMax().XYZ()) * 0.5);
+    }
+    m_meshStates[shape] = meshState;
+    m_meshResidency->Track(shape, 0);
+    return true;
+}
+
+void QtOccView::ReleaseInstance(const cad_core::ShapePtr& shape) {
+    auto groupIt = m_instanceGroups.find(MakeInstanceKey(shape->GetOCCTShape()));
+    if (groupIt == m_instanceGroups.end()) {
+        return;
+    }
+    
+    std::vector<cad_core::ShapePtr>& members = groupIt->second.members;
+    const bool wasOwner = !members.empty() && members.front() == shape;
+    members.erase(std::remove(members.begin(), members.end(), shape), members.end());
+    if (members.empty()) {
+        m_instanceGroups.erase(groupIt);
+        return;
+    }
+    if (!wasOwner) {
+        return;
+    }
+    
+    // 网格所有者被移除：网格状态、驻留字节和未完成的网格任务交给下一个成员，
+    // 网格就绪后由它刷新母版，其余实例随之更新
+    const cad_core::ShapePtr& owner = members.front();
+    auto fromIt = m_meshStates.find(shape);
+    auto toIt = m_meshStates.find(owner);
+    if (fromIt == m_meshStates.end() || toIt == m_meshStates.end()) {
+        return;
+    }
+    ShapeMeshState& state = toIt->second;
+    state.isInstance = false;
+    state.deflection = fromIt->second.deflection;
+    state.targetDeflection = fromIt->second.targetDeflection;
+    state.triangles = fromIt->second.triangles;
+    state.pendingJob = fromIt->second.pendingJob;
+    state.meshFailed = fromIt->second.meshFailed;
+    fromIt->second.pendingJob = 0;
+    for (auto& pending : m_pendingMeshes) {
+        if (pending.second == shape) {
+            pending.second = owner;
+        }
+    }
+    m_meshResidency->Track(owner, m_meshResidency->GetBytes(shape));
+}
+
+void QtOccView::RefreshInstances(const cad_core::ShapePtr& shape) {
+    auto groupIt = m_instanceGroups.find(MakeInstanceKey(shape->GetOCCTShape()));
+    if (groupIt == m_instanceGroups.end() || groupIt->second.master.IsNull()) {
+        return;
+    }
+    
+    // 母版表示和选择按新网格重新计算，连接的实例随之更新
+    // （shape 自身若也是连接实例，例如接管网格的成员，同样需要重新显示）
+    InstanceGroup& group = groupIt->second;
+    group.master->SetToUpdate();
+    group.master->RecomputePrimitives();
+    for (const cad_core::ShapePtr& member : group.members) {
+        auto it = m_shapeToAIS.find(member);
+        if (it == m_shapeToAIS.end() || it->second.IsNull() ||
+            !it->second->IsKind(STANDARD_TYPE(AIS_ConnectedInteractive))) {
+            continue;
+        }
+        m_context->Redisplay(it->second, Standard_False);
+        m_context->RecomputeSelectionOnly(it->second);
+    }
+}
+
+bool QtOccView::ParkPresentation(const cad_core::ShapePtr& shape, const Handle(AIS_InteractiveObject)& object) {
+    Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(object);
+    auto stateIt = m_meshStates.find(shape);
+    if (m_presentationPoolLimit == 0 || aisShape.IsNull() || stateIt == m_meshStates.end()) {
+        return false;
+    }
+    
+    // 只保留网格完整的着色表示；包围盒占位或网格已释放的直接移除
+    const ShapeMeshState& state = stateIt->second;
+    if (state.pendingJob != 0 || state.triangles == 0 || aisShape->HasDisplayMode() ||
+        !m_meshResidency->IsResident(shape)) {
+        return false;
+    }
+    
+    const TopoDS_Shape& occShape = shape->GetOCCTShape();
+    DropPooledPresentation(occShape);
+    
+    // 擦除而不是移除：表示、显示缓冲区和选择结构都保留在上下文中
+    if (m_context->IsDisplayed(aisShape)) {
+        m_context->Erase(aisShape, Standard_False);
+    }
+    
+    PooledPresentation pooled;
+    pooled.object = aisShape;
+    pooled.meshState = state;
+    pooled.meshState.pendingJob = 0;
+    pooled.bytes = m_meshResidency->GetBytes(shape);
+    pooled.hidden = m_hiddenShapes.count(shape) != 0;
+    m_presentationPool.Bind(occShape, pooled);
+    m_poolOrder.push_back(occShape);
+    
+    while (m_poolOrder.size() > m_presentationPoolLimit) {
+        DropPooledPresentation(m_poolOrder.front());
+    }
+    UpdatePooledBytes();
+    return true;
+}
+
+bool QtOccView::ReusePresentation(const cad_core::ShapePtr& shape) {
+    const TopoDS_Shape& occShape = shape->GetOCCTShape();
+    const PooledPresentation* found = m_presentationPool.Seek(occShape);
+    if (found == nullptr) {
+        return false;
+    }
+    
+    // 池按 TShape+位置 索引，方向不同或网格已被清除时不能复用
+    const PooledPresentation pooled = *found;
+    if (!pooled.object->Shape().IsEqual(occShape) ||
+        !MeshingService::HasTriangulation(occShape, pooled.meshState.deflection)) {
+        DropPooledPresentation(occShape);
+        return false;
+    }
+    
+    m_presentationPool.UnBind(occShape);
+    m_poolOrder.erase(std::remove_if(m_poolOrder.begin(), m_poolOrder.end(),
+                                     [&occShape](const TopoDS_Shape& pooledShape) { return pooledShape.IsSame(occShape); }),
+                      m_poolOrder.end());
+    UpdatePooledBytes();
+    
+    Handle(AIS_Shape) aisShape = pooled.object;
+    if (aisShape->IsTransparent()) {
+        m_context->UnsetTransparency(aisShape, Standard_False);
+    }
+    
+    m_shapeToAIS[shape] = aisShape;
+    m_meshStates[shape] = pooled.meshState;
+    m_meshResidency->Track(shape, pooled.bytes);
+    
+    if (pooled.hidden) {
+        // 入池前是隐藏的（例如撤销删除一个隐藏的实体），保持擦除状态
+        m_hiddenShapes.insert(shape);
+        m_meshResidency->SetHidden(shape, true);
+    } else {
+        m_context->Display(aisShape, Standard_False);
+    }
+    ActivateShapeSelectionModes(aisShape);
+    ScheduleTessellationUpdate();
+    return true;
+}
+
+void QtOccView::DropPooledPresentation(const TopoDS_Shape& shape) {
+    const PooledPresentation* pooled = m_presentationPool.Seek(shape);
+    if (pooled != nullptr) {
+        if (!m_context.IsNull()) {
+            m_context->Remove(pooled->object, Standard_False);
+        }
+        m_presentationPool.UnBind(shape);
+    }
+    m_poolOrder.erase(std::remove_if(m_poolOrder.begin(), m_poolOrder.end(),
+                                     [&shape](const TopoDS_Shape& pooledShape) { return pooledShape.IsSame(shape); }),
+                      m_poolOrder.end());
+    UpdatePooledBytes();
+}
+
+void QtOccView::UpdatePooledBytes() {
+    std::size_t bytes = 0;
+    for (NCollection_DataMap<TopoDS_Shape, PooledPresentation, TopTools_ShapeMapHasher>::Iterator it(m_presentationPool);
+         it.More(); it.Next()) {
+        bytes += it.Value().bytes;
+    }
+    m_meshResidency->SetPooledBytes(bytes);
+}
+
+void QtOccView::ReleaseSelection(const Handle(AIS_InteractiveObject)& object) {
+    if (object == m_currentSelectedAIS) {
+        m_currentSelectedAIS.Nullify();
+        m_currentSelectedShape.reset();
+    }
+    if (m_context->IsSelected(object)) {
+        m_context->AddOrRemoveSelected(object, Standard_False);
+    }
+}
+
+cad_core::ShapePtr QtOccView::FindShapeForObject(const Handle(AIS_InteractiveObject)& object) const {
+    if (object.IsNull()) {
+        return nullptr;
+    }
+    
+    for (const auto& pair : m_shapeToAIS) {
+        if (pair.second == object) {
+            return pair.first;
+        }
+    }
+    return nullptr;
+}
+
+TopoDS_Shape QtOccView::ResolveSubShape(const cad_core::ShapePtr& parent, const TopoDS_Shape& subShape) const {
+    if (!parent || subShape.IsNull()) {
+        return subShape;
+    }
+    
+    const TopoDS_Shape& parentShape = parent->GetOCCTShape();
+    if (parentShape.Location().IsIdentity()) {
+        return subShape;
+    }
+    
+    // 实例的子形状来自单位位置的母版，需要叠加实例自己的位置
+    TopTools_IndexedMapOfShape subShapes;
+    TopExp::MapShapes(parentShape, subShape.ShapeType(), subShapes);
+    if (subShapes.Contains(subShape)) {
+        return subShape;
+    }
+    
+    const TopoDS_Shape moved = subShape.Moved(parentShape.Location());
+    return subShapes.Contains(moved) ? moved : subShape;
+}
+
 // 选择模式设置
 void QtOccView::SetSelectionMode(cad_core::SelectionMode mode) {
     if (m_selectionManager) {
@@ -951,10 +1721,10 @@ void QtOccView::SelectShape(const cad_core::ShapePtr& shape) {
         m_currentSelectedShape.reset();
     }
     
-    // Find the AIS_Shape corresponding to this shape
+    // Find the AIS object corresponding to this shape
     auto it = m_shapeToAIS.find(shape);
     if (it != m_shapeToAIS.end()) {
-        Handle(AIS_Shape) aisShape = it->second;
+        Handle(AIS_InteractiveObject) aisShape = it->second;
         if (!aisShape.IsNull()) {
             // Set new selection with highlighting
             m_context->SetSelected(aisShape, Standard_True);
@@ -983,16 +1753,22 @@ void QtOccView::ClearEdgeSelection() {
     m_view->Redraw();
 }
 
-std::map<cad_core::ShapePtr, std::vector<TopoDS_Edge>> QtOccView::GetSelectedEdgesByShape() const {
-    std::map<cad_core::ShapePtr, std::vector<TopoDS_Edge>> result;
+std::vector<std::pair<cad_core::ShapePtr, std::vector<TopoDS_Edge>>> QtOccView::GetSelectedEdgesByShape() const {
+    std::vector<std::pair<cad_core::ShapePtr, std::vector<TopoDS_Edge>>> result;
+    std::map<cad_core::ShapePtr, size_t> groupIndex;
     
     // Group edges by their parent shapes using parallel vectors
+    // 分组顺序跟随选择顺序而不是指针大小，批量运算的结果顺序因此可重复
     for (size_t i = 0; i < m_selectedEdges.size() && i < m_edgeParentShapes.size(); ++i) {
         const TopoDS_Edge& edge = m_selectedEdges[i];
         const cad_core::ShapePtr& parentShape = m_edgeParentShapes[i];
         
         if (parentShape) {
-            result[parentShape].push_back(edge);
+            auto inserted = groupIndex.emplace(parentShape, result.size());
+            if (inserted.second) {
+                result.emplace_back(parentShape, std::vector<TopoDS_Edge>());
+            }
+            result[inserted.first->second].second.push_back(edge);
         }
     }
     
@@ -1125,7 +1901,7 @@ void QtOccView::SetShapeTransparency(const cad_core::ShapePtr& shape, double tra
 
     auto it = m_shapeToAIS.find(shape);
     if (it != m_shapeToAIS.end()) {
-        Handle(AIS_Shape) aisShape = it->second;
+        Handle(AIS_InteractiveObject) aisShape = it->second;
         if (!aisShape.IsNull()) {
             // 设置透明度
             m_context->SetTransparency(aisShape, transparency, Standard_False);
@@ -1141,7 +1917,7 @@ void QtOccView::ResetShapeDisplay(const cad_core::ShapePtr& shape) {
     }
     auto it = m_shapeToAIS.find(shape);
     if (it != m_shapeToAIS.end()) {
-        Handle(AIS_Shape) aisShape = it->second;
+        Handle(AIS_InteractiveObject) aisShape = it->second;
         if (!aisShape.IsNull()) {
             // 移除透明度设置
             m_context->UnsetTransparency(aisShape, Standard_False);
@@ -1155,31 +1931,104 @@ void QtOccView::DisplayPreviewShape(const cad_core::ShapePtr& shape)
     if (!shape || shape->GetOCCTShape().IsNull() || m_context.IsNull()) {
         return;
     }
-    // 先清除旧的预览
-    ClearPreviewShapes();
-    Handle(AIS_Shape) aisShape = new AIS_Shape(shape->GetOCCTShape());
+    ShowPreview(PreviewSlot::Generic, shape->GetOCCTShape());
+    MovePreview(PreviewSlot::Generic, gp_Trsf());
+}
 
-    // 设置预览样式：半透明红色
-    aisShape->SetDisplayMode(AIS_Shaded);
-    aisShape->SetColor(Quantity_NOC_RED);
-    aisShape->SetTransparency(0.5);
+void QtOccView::ClearPreviewShapes()
+{
+    if (m_context.IsNull()) return;
+    for (const auto& pair : m_previewSlots) {
+        if (m_context->IsDisplayed(pair.second)) {
+            m_context->Erase(pair.second, Standard_False);
+        }
+    }
+    m_view->Redraw();
+}
 
-    m_context->Display(aisShape, Standard_False);
-    m_previewAISShapes.push_back(aisShape);
+void QtOccView::ShowPreview(PreviewSlot slot, const TopoDS_Shape& shape)
+{
+    if (shape.IsNull() || m_context.IsNull()) {
+        return;
+    }
+    
+    Handle(AIS_Shape)& preview = m_previewSlots[slot];
+    if (preview.IsNull()) {
+        preview = new AIS_Shape(shape);
+        preview->SetDisplayMode(AIS_Shaded);
+        
+        // 预览样式：各槽位用不同颜色区分
+        switch (slot) {
+        case PreviewSlot::Transform:
+            preview->SetColor(Quantity_NOC_CYAN1);
+            preview->SetTransparency(0.6);
+            break;
+        case PreviewSlot::Feature:
+            preview->SetColor(Quantity_NOC_GREEN);
+            preview->SetTransparency(0.5);
+            break;
+        case PreviewSlot::Boolean:
+            preview->SetColor(Quantity_NOC_GOLD);
+            preview->SetTransparency(0.4);
+            break;
+        case PreviewSlot::FaultyEdges:
+            // 比选中边（红色3像素）更醒目
+            preview->SetColor(Quantity_NOC_MAGENTA1);
+            preview->SetWidth(5.0);
+            break;
+        default:
+            preview->SetColor(Quantity_NOC_RED);
+            preview->SetTransparency(0.5);
+            break;
+        }
+        m_context->Display(preview, Standard_False);
+    } else {
+        // 形状不变时保留现有表示，只在变化时替换形状并重算当前显示模式
+        if (!preview->Shape().IsEqual(shape)) {
+            preview->SetShape(shape);
+            if (m_context->IsDisplayed(preview)) {
+                m_context->Redisplay(preview, Standard_False);
+            }
+        }
+        if (!m_context->IsDisplayed(preview)) {
+            m_context->Display(preview, Standard_False);
+        }
+    }
+    
+    m_view->Redraw();
+}
 
+void QtOccView::MovePreview(PreviewSlot slot, const gp_Trsf& transformation)
+{
+    auto it = m_previewSlots.find(slot);
+    if (it == m_previewSlots.end() || m_context.IsNull()) {
+        return;
+    }
+    
+    // 只改变局部变换，表示和选择结构都不重算
+    m_context->SetLocation(it->second, TopLoc_Location(transformation));
     m_view->Redraw();
 }
 
-void QtOccView::ClearPreviewShapes()
+void QtOccView::HidePreview(PreviewSlot slot)
 {
-    if (m_context.IsNull()) return;
-    for (const auto& aisShape : m_previewAISShapes) {
-        m_context->Remove(aisShape, Standard_False);
+    auto it = m_previewSlots.find(slot);
+    if (it == m_previewSlots.end() || m_context.IsNull()) {
+        return;
+    }
+    
+    if (m_context->IsDisplayed(it->second)) {
+        m_context->Erase(it->second, Standard_False);
     }
-    m_previewAISShapes.clear();
     m_view->Redraw();
 }
 
+bool QtOccView::IsPreviewVisible(PreviewSlot slot) const
+{
+    auto it = m_previewSlots.find(slot);
+    return it != m_previewSlots.end() && !m_context.IsNull() && m_context->IsDisplayed(it->second);
+}
+
 
 // =============================================================================
 // Sketch Mode Implementation
@@ -1261,6 +2110,201 @@ void QtOccView::DisablePreviewDragging() {
 }
 
 
+// =============================================================================
+// Render Statistics
+// =============================================================================
+
+namespace {
+
+// 在OCCT统计项中按候选名称查找（不区分大小写，取第一个匹配）
+bool FindCounter(const TColStd_IndexedDataMapOfStringString& dict,
+                 std::initializer_list<const char*> names, double& value) {
+    for (const char* name : names) {
+        const QString wanted = QString::fromLatin1(name);
+        for (int i = 1; i <= dict.Extent(); ++i) {
+            const QString key = QString::fromUtf8(dict.FindKey(i).ToCString()).trimmed();
+            if (key.compare(wanted, Qt::CaseInsensitive) != 0) {
+                continue;
+            }
+            // 数值可能带千位分隔空格或单位
+            QString text = QString::fromUtf8(dict.FindFromIndex(i).ToCString());
+            text.remove(QChar(' '));
+            QString number;
+            for (const QChar ch : text) {
+                if (ch.isDigit() || ch == QChar('.')) {
+                    number.append(ch);
+                } else if (!number.isEmpty()) {
+                    break;
+                }
+            }
+            bool ok = false;
+            value = number.toDouble(&ok);
+            return ok;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+void QtOccView::SetStatisticsOverlayVisible(bool visible) {
+    m_statsOverlayVisible = visible;
+    ApplyStatisticsParams();
+    
+    if (m_context.IsNull()) {
+        return;
+    }
+    
+    if (visible) {
+        if (m_statsLabel.IsNull()) {
+            // 自有计数显示在右上角，OCCT统计显示在左上角
+            m_statsLabel = new AIS_TextLabel();
+            m_statsLabel->SetColor(Quantity_NOC_WHITE);
+            m_statsLabel->SetHeight(12);
+            m_statsLabel->SetZLayer(Graphic3d_ZLayerId_TopOSD);
+            m_statsLabel->SetTransformPersistence(
+                new Graphic3d_TransformPers(Graphic3d_TMF_2d, Aspect_TOTP_RIGHT_UPPER, Graphic3d_Vec2i(240, 30)));
+        }
+        m_context->Display(m_statsLabel, 0, -1, Standard_False);  // 不参与选择
+        m_statsClock.invalidate();
+    } else {
+        if (!m_statsLabel.IsNull()) {
+            m_context->Remove(m_statsLabel, Standard_False);
+        }
+    }
+    
+    RedrawView();
+}
+
+void QtOccView::SetStatisticsCollectionEnabled(bool enabled) {
+    m_statsCollectionEnabled = enabled;
+    ApplyStatisticsParams();
+}
+
+void QtOccView::ApplyStatisticsParams() {
+    if (m_view.IsNull()) {
+        return;
+    }
+    
+    Graphic3d_RenderingParams& params = m_view->ChangeRenderingParams();
+    params.ToShowStats = m_statsOverlayVisible;
+    params.CollectedStats = (m_statsOverlayVisible || m_statsCollectionEnabled)
+        ? Graphic3d_RenderingParams::PerfCounters_All
+        : Graphic3d_RenderingParams::PerfCounters_NONE;
+    params.StatsPosition = new Graphic3d_TransformPers(Graphic3d_TMF_2d, Aspect_TOTP_LEFT_UPPER, Graphic3d_Vec2i(20, 20));
+}
+
+RenderStatistics QtOccView::GetRenderStatistics() const {
+    RenderStatistics stats = m_renderStats;
+    stats.pendingMeshJobs = m_pendingMeshes.size();
+    stats.gpuMemoryBytes = m_meshResidency ? m_meshResidency->GetResidentBytes() : 0;
+    
+    if (!m_context.IsNull()) {
+        AIS_ListOfInteractive displayed;
+        m_context->DisplayedObjects(displayed);
+        stats.presentations = static_cast<std::size_t>(displayed.Extent());
+        
+        // 统计标签本身不计入
+        if (!m_statsLabel.IsNull() && m_context->IsDisplayed(m_statsLabel) && stats.presentations > 0) {
+            --stats.presentations;
+        }
+    }
+    
+    // 三角形数：实例按母版网格计数
+    for (const auto& pair : m_shapeToAIS) {
+        auto stateIt = m_meshStates.find(pair.first);
+        if (stateIt != m_meshStates.end() && stateIt->second.isInstance) {
+            auto groupIt = m_instanceGroups.find(MakeInstanceKey(pair.first->GetOCCTShape()));
+            if (groupIt != m_instanceGroups.end() && !groupIt->second.members.empty()) {
+                stateIt = m_meshStates.find(groupIt->second.members.front());
+            }
+        }
+        if (stateIt != m_meshStates.end() && !m_context.IsNull() && m_context->IsDisplayed(pair.second)) {
+            stats.triangles += stateIt->second.triangles;
+        }
+    }
+    
+    // OCCT渲染统计（需要启用统计收集）
+    if (!m_view.IsNull() && (m_statsOverlayVisible || m_statsCollectionEnabled)) {
+        TColStd_IndexedDataMapOfStringString dict;
+        m_view->StatisticInformation(dict);
+        for (int i = 1; i <= dict.Extent(); ++i) {
+            stats.occtCounters[dict.FindKey(i).ToCString()] = dict.FindFromIndex(i).ToCString();
+        }
+        
+        double value = 0.0;
+        if (FindCounter(dict, {"FPS"}, value)) {
+            stats.fps = value;
+        }
+        if (FindCounter(dict, {"Rendered triangles", "Triangles"}, value)) {
+            stats.renderedTriangles = static_cast<std::size_t>(value);
+        }
+        if (FindCounter(dict, {"Rendered arrays", "Arrays"}, value)) {
+            stats.drawCalls = static_cast<std::size_t>(value);
+        }
+        if (FindCounter(dict, {"Rendered structures", "Structures"}, value)) {
+            stats.structures = static_cast<std::size_t>(value);
+        }
+        if (FindCounter(dict, {"GPU Memory"}, value) && value > 0.0) {
+            // OCCT以MiB报告估算的显存占用
+            stats.gpuMemoryBytes = static_cast<std::size_t>(value * 1024.0 * 1024.0);
+        }
+    }
+    
+    return stats;
+}
+
+RenderStatistics QtOccView::MeasureRedraw(int frames) {
+    if (m_view.IsNull() || frames <= 0) {
+        return GetRenderStatistics();
+    }
+    
+    // 强制完整重绘若干帧，用于自动化性能测试
+    const bool previousCollection = m_statsCollectionEnabled;
+    SetStatisticsCollectionEnabled(true);
+    
+    double total = 0.0;
+    QElapsedTimer frameTimer;
+    for (int i = 0; i < frames; ++i) {
+        m_view->Invalidate();
+        frameTimer.start();
+        m_view->Redraw();
+        const double elapsed = frameTimer.nsecsElapsed() / 1.0e6;
+        RecordFrameTime(elapsed);
+        total += elapsed;
+    }
+    
+    RenderStatistics stats = GetRenderStatistics();
+    stats.averageFrameTimeMs = total / frames;
+    stats.fps = (total > 0.0) ? 1000.0 * frames / total : 0.0;
+    
+    SetStatisticsCollectionEnabled(previousCollection);
+    return stats;
+}
+
+void QtOccView::UpdateStatisticsOverlay() {
+    if (m_statsLabel.IsNull() || m_context.IsNull()) {
+        return;
+    }
+    
+    const RenderStatistics stats = GetRenderStatistics();
+    const QString text = QString("Frame: %1 ms (avg %2)\nPick: %3 ms\nPresentations: %4\n"
+                                 "Triangles: %5\nMesh memory: %6 MB\nPending meshes: %7")
+        .arg(stats.frameTimeMs, 0, 'f', 2)
+        .arg(stats.averageFrameTimeMs, 0, 'f', 2)
+        .arg(stats.pickTimeMs, 0, 'f', 2)
+        .arg(stats.presentations)
+        .arg(stats.triangles)
+        .arg(stats.gpuMemoryBytes / (1024.0 * 1024.0), 0, 'f', 1)
+        .arg(stats.pendingMeshJobs);
+    
+    m_statsLabel->SetText(TCollection_ExtendedString(text.toUtf8().constData(), Standard_True));
+    if (m_context->IsDisplayed(m_statsLabel)) {
+        m_context->Redisplay(m_statsLabel, Standard_False);
+    }
+}
+
+
 } // namespace cad_ui
 
 #include "QtOccView.moc"
\ No newline at end of file
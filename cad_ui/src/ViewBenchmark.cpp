@@ -0,0 +1,250 @@
+﻿#include "cad_ui/ViewBenchmark.h"
+#include "cad_ui/OffscreenView.h"
+#include "cad_ui/MeshingService.h"
+#include "cad_core/ShapeFactory.h"
+
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepBuilderAPI_Transform.hxx>
+#include <BRepBndLib.hxx>
+#include <Bnd_Box.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_Vec.hxx>
+#include <TopoDS_TShape.hxx>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDir>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+namespace cad_ui {
+
+namespace {
+
+const double kGridSpacing = 30.0;
+
+// 把第 index 个对象放在 XY 平面的方形网格上
+gp_Vec GridOffset(int index, int count) {
+    const int columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count)))));
+    return gp_Vec((index % columns) * kGridSpacing, (index / columns) * kGridSpacing, 0.0);
+}
+
+cad_core::ShapePtr MoveShape(const cad_core::ShapePtr& shape, const gp_Vec& offset) {
+    if (!shape) {
+        return nullptr;
+    }
+    gp_Trsf trsf;
+    trsf.SetTranslation(offset);
+    // 不复制几何：结果只带位置，与原形状共享 TShape
+    BRepBuilderAPI_Transform transform(shape->GetOCCTShape(), trsf, Standard_False);
+    return std::make_shared<cad_core::Shape>(transform.Shape());
+}
+
+} // anonymous namespace
+
+ViewBenchmark::ViewBenchmark(OffscreenView& view)
+    : m_view(view)
+    , m_frameCount(360)
+    , m_warmupFrames(5)
+    , m_relativeDeflection(0.001)
+    , m_imageInterval(0)
+    , m_imageExtension("png") {
+}
+
+void ViewBenchmark::SetImageOutput(const std::string& directory, int interval, const std::string& extension) {
+    m_imageDirectory = directory;
+    m_imageInterval = interval;
+    m_imageExtension = extension;
+}
+
+std::vector<std::string> ViewBenchmark::GetStandardSceneNames() {
+    return {"boxes", "spheres", "instanced", "mixed"};
+}
+
+BenchmarkScene ViewBenchmark::CreateStandardScene(const std::string& name, int count) {
+    BenchmarkScene scene;
+    scene.name = name;
+    count = std::max(1, count);
+
+    if (name == "boxes") {
+        // 平面为主，三角形少，主要测试对象数量带来的开销
+        for (int i = 0; i < count; ++i) {
+            gp_Vec offset = GridOffset(i, count);
+            scene.shapes.push_back(cad_core::ShapeFactory::CreateBox(
+                cad_core::Point(offset.X(), offset.Y(), 0.0),
+                cad_core::Point(offset.X() + 20.0, offset.Y() + 20.0, 10.0 + (i % 5) * 2.0)));
+        }
+    } else if (name == "spheres") {
+        // 曲面为主，三角形多
+        for (int i = 0; i < count; ++i) {
+            gp_Vec offset = GridOffset(i, count);
+            scene.shapes.push_back(cad_core::ShapeFactory::CreateSphere(
+                cad_core::Point(offset.X(), offset.Y(), 0.0), 10.0 + (i % 3)));
+        }
+    } else if (name == "instanced") {
+        // 同一几何的多个位置实例，共享三角化
+        cad_core::ShapePtr prototype = cad_core::ShapeFactory::CreateCylinder(8.0, 20.0);
+        for (int i = 0; i < count; ++i) {
+            scene.shapes.push_back(MoveShape(prototype, GridOffset(i, count)));
+        }
+    } else if (name == "mixed") {
+        for (int i = 0; i < count; ++i) {
+            gp_Vec offset = GridOffset(i, count);
+            cad_core::Point base(offset.X(), offset.Y(), 0.0);
+            switch (i % 3) {
+            case 0:
+                scene.shapes.push_back(cad_core::ShapeFactory::CreateBox(
+                    base, cad_core::Point(offset.X() + 18.0, offset.Y() + 18.0, 18.0)));
+                break;
+            case 1:
+                scene.shapes.push_back(cad_core::ShapeFactory::CreateCylinder(base, 9.0, 18.0));
+                break;
+            default:
+                scene.shapes.push_back(cad_core::ShapeFactory::CreateSphere(base, 9.0));
+                break;
+            }
+        }
+    } else {
+        qDebug() << "Unknown benchmark scene:" << QString::fromStdString(name);
+    }
+
+    scene.shapes.erase(std::remove(scene.shapes.begin(), scene.shapes.end(), nullptr), scene.shapes.end());
+    return scene;
+}
+
+void ViewBenchmark::ApplyCameraPath(int frame, const gp_Pnt& center, double radius) {
+    // 环绕一周，同时上下摆动并推拉两次
+    const double t = m_frameCount > 0 ? static_cast<double>(frame) / m_frameCount : 0.0;
+    const double azimuth = 2.0 * M_PI * t;
+    const double elevation = (25.0 + 10.0 * std::sin(2.0 * M_PI * t)) * M_PI / 180.0;
+    const double distance = radius * (2.2 + 0.6 * std::sin(4.0 * M_PI * t));
+
+    gp_Pnt eye(center.X() + distance * std::cos(elevation) * std::cos(azimuth),
+               center.Y() + distance * std::cos(elevation) * std::sin(azimuth),
+               center.Z() + distance * std::sin(elevation));
+    m_view.SetCamera(eye, center, gp_Dir(0.0, 0.0, 1.0));
+}
+
+BenchmarkResult ViewBenchmark::Run(const BenchmarkScene& scene) {
+    BenchmarkResult result;
+    result.scene = scene.name;
+    result.shapes = static_cast<int>(scene.shapes.size());
+    if (!m_view.IsInitialized() || scene.shapes.empty()) {
+        return result;
+    }
+
+    m_view.ClearShapes();
+
+    // 预先网格化，共享 TShape 的实例只网格化一次
+    Bnd_Box sceneBox;
+    std::set<const TopoDS_TShape*> meshed;
+    QElapsedTimer meshTimer;
+    meshTimer.start();
+    for (const auto& shape : scene.shapes) {
+        const TopoDS_Shape& occtShape = shape->GetOCCTShape();
+        BRepBndLib::Add(occtShape, sceneBox);
+        if (meshed.insert(occtShape.TShape().get()).second) {
+            double deflection = MeshingService::ComputeDeflection(occtShape, m_relativeDeflection);
+            BRepMesh_IncrementalMesh mesher(occtShape, deflection, Standard_False, 0.5, Standard_True);
+        }
+        result.triangles += MeshingService::ComputeMeshStatistics(occtShape).triangles;
+    }
+    result.meshTimeMs = meshTimer.nsecsElapsed() / 1.0e6;
+
+    for (const auto& shape : scene.shapes) {
+        m_view.DisplayShape(shape);
+    }
+
+    Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
+    sceneBox.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+    gp_Pnt center((xmin + xmax) / 2.0, (ymin + ymax) / 2.0, (zmin + zmax) / 2.0);
+    double radius = std::max(1.0, gp_Pnt(xmin, ymin, zmin).Distance(gp_Pnt(xmax, ymax, zmax)) / 2.0);
+
+    // 首帧包含显示缓冲区上传，单独记录
+    ApplyCameraPath(0, center, radius);
+    result.firstFrameMs = m_view.RenderFrame();
+    for (int i = 0; i < m_warmupFrames; ++i) {
+        m_view.RenderFrame();
+    }
+
+    if (m_imageInterval > 0 && !m_imageDirectory.empty()) {
+        QDir().mkpath(QString::fromStdString(m_imageDirectory));
+    }
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(m_frameCount);
+    for (int frame = 0; frame < m_frameCount; ++frame) {
+        ApplyCameraPath(frame, center, radius);
+        frameTimes.push_back(m_view.RenderFrame());
+
+        // 截图不计入帧时间
+        if (m_imageInterval > 0 && !m_imageDirectory.empty() && frame % m_imageInterval == 0) {
+            QString fileName = QString("%1_%2.%3")
+                .arg(QString::fromStdString(scene.name))
+                .arg(frame, 4, 10, QChar('0'))
+                .arg(QString::fromStdString(m_imageExtension));
+            std::string path = QDir(QString::fromStdString(m_imageDirectory)).filePath(fileName).toStdString();
+            if (!m_view.DumpImage(path) && m_imageExtension != "ppm") {
+                // 没有图像编解码库时 PNG 可能不可用，退回无依赖的 PPM
+                qDebug() << "Failed to save" << QString::fromStdString(path) << ", falling back to PPM";
+                m_imageExtension = "ppm";
+                path = path.substr(0, path.find_last_of('.')) + ".ppm";
+                if (!m_view.DumpImage(path)) {
+                    continue;
+                }
+            }
+            result.images.push_back(path);
+        }
+    }
+
+    result.frames = static_cast<int>(frameTimes.size());
+    if (!frameTimes.empty()) {
+        std::vector<double> sorted = frameTimes;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for (double t : sorted) {
+            total += t;
+        }
+        std::size_t p95Index = static_cast<std::size_t>(std::ceil(0.95 * sorted.size())) - 1;
+        result.minFrameMs = sorted.front();
+        result.maxFrameMs = sorted.back();
+        result.meanFrameMs = total / sorted.size();
+        result.p95FrameMs = sorted[std::min(p95Index, sorted.size() - 1)];
+        result.fps = result.meanFrameMs > 0.0 ? 1000.0 / result.meanFrameMs : 0.0;
+    }
+
+    m_view.ClearShapes();
+    return result;
+}
+
+std::string ViewBenchmark::ToJson(const std::vector<BenchmarkResult>& results) {
+    QJsonArray scenes;
+    for (const auto& result : results) {
+        QJsonObject object;
+        object["scene"] = QString::fromStdString(result.scene);
+        object["shapes"] = result.shapes;
+        object["frames"] = result.frames;
+        object["triangles"] = static_cast<double>(result.triangles);
+        object["meshTimeMs"] = result.meshTimeMs;
+        object["firstFrameMs"] = result.firstFrameMs;
+        object["minFrameMs"] = result.minFrameMs;
+        object["meanFrameMs"] = result.meanFrameMs;
+        object["p95FrameMs"] = result.p95FrameMs;
+        object["maxFrameMs"] = result.maxFrameMs;
+        object["fps"] = result.fps;
+        QJsonArray images;
+        for (const auto& image : result.images) {
+            images.append(QString::fromStdString(image));
+        }
+        object["images"] = images;
+        scenes.append(object);
+    }
+    QJsonObject root;
+    root["results"] = scenes;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented).toStdString();
+}
+
+} // namespace cad_ui